@@ -33,7 +33,11 @@
     F(void, IcarianEngine.Physics, CharacterControllerInterop, SetVelocity, \
     { \
         Instance->SetCharacterControllerVelocity(a_addr, a_velocity); \
-    }, IOP_UINT32 a_addr, IOP_VEC3 a_velocity)\
+    }, IOP_UINT32 a_addr, IOP_VEC3 a_velocity) \
+    F(void, IcarianEngine.Physics, CharacterControllerInterop, SetListenerState, \
+    { \
+        Instance->SetCharacterControllerListener(a_addr, (bool)a_state); \
+    }, IOP_UINT32 a_addr, IOP_UINT32 a_state) \
     
 
 /// @endcond
@@ -0,0 +1,62 @@
+// Icarian Engine - C# Game Engine
+// 
+// License at end of file.
+
+#pragma once
+
+#include "InteropTypes.h"
+
+#ifdef CUBE_LANGUAGE_CSHARP
+namespace IcarianEngine.AI {
+#endif
+
+/// @file EngineNavigationInteropStructures.h
+
+/// <summary>
+/// The state of a path request.
+/// </summary>
+IOP_CSPUBLIC enum IOP_ENUM_NAME(PathRequestState) : IOP_UINT32
+{
+    /// <summary>
+    /// The path is waiting to be generated.
+    /// </summary>
+    IOP_ENUM_VALUE(PathRequestState, Pending) = 0,
+    /// <summary>
+    /// The path has been generated.
+    /// </summary>
+    IOP_ENUM_VALUE(PathRequestState, Ready) = 1,
+    /// <summary>
+    /// A path could not be found.
+    /// </summary>
+    IOP_ENUM_VALUE(PathRequestState, Failed) = 2,
+    /// <summary>
+    /// The request does not exist.
+    /// </summary>
+    IOP_ENUM_VALUE(PathRequestState, Invalid) = 3
+};
+
+#ifdef CUBE_LANGUAGE_CSHARP
+}
+#endif
+
+// MIT License
+// 
+// Copyright (c) 2024 River Govers
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
\ No newline at end of file
@@ -40,6 +40,18 @@
         } \
         return arr; \
     }, IOP_UINT32 a_addr, IOP_VEC3 a_startPoint, IOP_VEC3 a_endPoint, float a_agentRadius) \
+    F(IOP_UINT32, IcarianEngine.AI, NavigationMeshInterop, RequestPath, \
+    { \
+        return Instance->RequestNavMeshPath(a_addr, a_startPoint, a_endPoint, a_agentRadius); \
+    }, IOP_UINT32 a_addr, IOP_VEC3 a_startPoint, IOP_VEC3 a_endPoint, float a_agentRadius) \
+    F(IOP_UINT32, IcarianEngine.AI, NavigationMeshInterop, BakeMesh, \
+    { \
+        char* modelStr = mono_string_to_utf8(a_modelPath); \
+        IDEFER(mono_free(modelStr)); \
+        char* cookedStr = mono_string_to_utf8(a_cookedPath); \
+        IDEFER(mono_free(cookedStr)); \
+        return (uint32_t)Instance->BakeNavMesh(modelStr, cookedStr); \
+    }, IOP_STRING a_modelPath, IOP_STRING a_cookedPath) \
 
 /// @endcond
 
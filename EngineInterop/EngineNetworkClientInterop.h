@@ -26,16 +26,33 @@
     F(void, IcarianEngine.Networking, NetworkClientInterop, Send, \
     { \
         const uint32_t size = (uint32_t)mono_array_length(a_data); \
-        uint8_t* data = new uint8_t[size]; \
-        IDEFER(delete[] data); \
-        \
-        for (uint32_t i = 0; i < size; ++i) \
+        Instance->NetworkClientSend(a_addr, mono_array_addr(a_data, uint8_t, 0), size, (e_PacketFlags)a_flags, a_channel); \
+    }, IOP_UINT32 a_addr, IOP_ARRAY(byte[]) a_data, IOP_UINT32 a_flags, IOP_UINT32 a_channel) \
+    \
+    F(void, IcarianEngine.Networking, NetworkClientInterop, Replicate, \
+    { \
+        Instance->NetworkClientReplicate(a_addr, a_netID, a_transformAddr); \
+    }, IOP_UINT32 a_addr, IOP_UINT32 a_netID, IOP_UINT32 a_transformAddr) \
+    F(void, IcarianEngine.Networking, NetworkClientInterop, StopReplicating, \
+    { \
+        Instance->NetworkClientStopReplicating(a_addr, a_netID); \
+    }, IOP_UINT32 a_addr, IOP_UINT32 a_netID) \
+    F(IOP_ARRAY(byte[]), IcarianEngine.Networking, NetworkClientInterop, GetReplicatedData, \
+    { \
+        uint8_t data[ReplicationMaxDataSize]; \
+        const uint32_t size = Instance->NetworkClientGetReplicatedData(a_addr, a_netID, data); \
+        if (size == -1) \
         { \
-            data[i] = *(uint8_t*)mono_array_addr(a_data, uint8_t, i); \
+            return NULL; \
         } \
         \
-        Instance->NetworkClientSend(a_addr, data, size, (e_PacketFlags)a_flags); \
-    }, IOP_UINT32 a_addr, IOP_ARRAY(byte[]) a_data, IOP_UINT32 a_flags) \
+        MonoArray* arr = mono_array_new(mono_domain_get(), mono_get_byte_class(), (uintptr_t)size); \
+        if (size > 0) \
+        { \
+            memcpy(mono_array_addr(arr, uint8_t, 0), data, size); \
+        } \
+        return arr; \
+    }, IOP_UINT32 a_addr, IOP_UINT32 a_netID) \
     
 /// @endcond
 
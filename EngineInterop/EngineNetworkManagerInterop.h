@@ -13,6 +13,14 @@
     { \
         return (uint32_t)Instance->IsInitialized(); \
     }) \
+    F(IOP_UINT32, IcarianEngine.Networking, NetworkManagerInterop, GetInboundLatency, \
+    { \
+        return Instance->GetInboundLatency(); \
+    }) \
+    F(IOP_UINT32, IcarianEngine.Networking, NetworkManagerInterop, GetOutboundLatency, \
+    { \
+        return Instance->GetOutboundLatency(); \
+    }) \
     
 /// @endcond
 
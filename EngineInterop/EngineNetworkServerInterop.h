@@ -21,36 +21,53 @@
     F(void, IcarianEngine.Networking, NetworkServerInterop, Send, \
     { \
         const uint32_t size = (uint32_t)mono_array_length(a_data); \
-        uint8_t* data = new uint8_t[size]; \
-        IDEFER(delete[] data); \
-        \
-        for (uint32_t i = 0; i < size; ++i) \
-        { \
-            data[i] = *(uint8_t*)mono_array_addr(a_data, uint8_t, i); \
-        } \
-        Instance->NetworkServerSend(a_addr, data, size, (e_PacketFlags)a_flags); \
-    }, IOP_UINT32 a_addr, IOP_ARRAY(byte[]) a_data, IOP_UINT32 a_flags) \
+        Instance->NetworkServerSend(a_addr, mono_array_addr(a_data, uint8_t, 0), size, (e_PacketFlags)a_flags, a_channel); \
+    }, IOP_UINT32 a_addr, IOP_ARRAY(byte[]) a_data, IOP_UINT32 a_flags, IOP_UINT32 a_channel) \
+    F(void, IcarianEngine.Networking, NetworkServerInterop, SendTo, \
+    { \
+        const uint32_t clientCount = (uint32_t)mono_array_length(a_clients); \
+        const uint32_t size = (uint32_t)mono_array_length(a_data); \
+        Instance->NetworkServerSendTo(a_addr, mono_array_addr(a_clients, uint32_t, 0), clientCount, mono_array_addr(a_data, uint8_t, 0), size, (e_PacketFlags)a_flags, a_channel); \
+    }, IOP_UINT32 a_addr, IOP_ARRAY(uint[]) a_clients, IOP_ARRAY(byte[]) a_data, IOP_UINT32 a_flags, IOP_UINT32 a_channel) \
     F(IOP_UINT32, IcarianEngine.Networking, NetworkServerInterop, GetMaxClients, \
     { \
         return Instance->NetworkServerGetMaxClients(a_addr); \
     }, IOP_UINT32 a_addr) \
     F(IOP_ARRAY(uint[]), IcarianEngine.Networking, NetworkServerInterop, GetClients, \
     { \
-        NetworkPeer* peers = Instance->NetworkServerGetClients(a_addr); \
-        if (peers == NULL) \
+        const Array<uint32_t> clients = Instance->NetworkServerGetClients(a_addr); \
+        if (clients.Empty()) \
         { \
             return NULL; \
         } \
         \
-        const uint32_t size = Instance->NetworkServerGetMaxClients(a_addr); \
+        const uint32_t size = clients.Size(); \
         MonoArray* arr = mono_array_new(mono_domain_get(), mono_get_uint32_class(), size); \
         \
         for (uint32_t i = 0; i < size; ++i) \
         { \
-            mono_array_set(arr, uint32_t, i, peers[i].Addr); \
+            mono_array_set(arr, uint32_t, i, clients[i]); \
         } \
         return arr; \
     }, IOP_UINT32 a_addr) \
+    \
+    F(void, IcarianEngine.Networking, NetworkServerInterop, Replicate, \
+    { \
+        Instance->NetworkServerReplicate(a_addr, a_netID, a_transformAddr); \
+    }, IOP_UINT32 a_addr, IOP_UINT32 a_netID, IOP_UINT32 a_transformAddr) \
+    F(void, IcarianEngine.Networking, NetworkServerInterop, StopReplicating, \
+    { \
+        Instance->NetworkServerStopReplicating(a_addr, a_netID); \
+    }, IOP_UINT32 a_addr, IOP_UINT32 a_netID) \
+    F(void, IcarianEngine.Networking, NetworkServerInterop, SetReplicatedData, \
+    { \
+        const uint32_t size = (uint32_t)mono_array_length(a_data); \
+        Instance->NetworkServerSetReplicatedData(a_addr, a_netID, mono_array_addr(a_data, uint8_t, 0), size); \
+    }, IOP_UINT32 a_addr, IOP_UINT32 a_netID, IOP_ARRAY(byte[]) a_data) \
+    F(void, IcarianEngine.Networking, NetworkServerInterop, SetSnapshotRate, \
+    { \
+        Instance->NetworkServerSetSnapshotRate(a_addr, a_rate); \
+    }, IOP_UINT32 a_addr, IOP_UINT32 a_rate) \
 
 /// @endcond
 
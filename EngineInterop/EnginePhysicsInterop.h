@@ -27,6 +27,14 @@
     { \
         Instance->SetObjectLayerCollision(a_layerA, a_layerB, (bool)a_state); \
     }, IOP_UINT32 a_layerA, IOP_UINT32 a_layerB, IOP_UINT32 a_state) \
+    F(IOP_UINT32, IcarianEngine.Physics, PhysicsInterop, GetCharacterInteractionMode, \
+    { \
+        return (uint32_t)Instance->GetCharacterInteractionMode(); \
+    }) \
+    F(void, IcarianEngine.Physics, PhysicsInterop, SetCharacterInteractionMode, \
+    { \
+        Instance->SetCharacterInteractionMode((e_CharacterInteractionMode)a_mode); \
+    }, IOP_UINT32 a_mode) \
     F(IOP_ARRAY(RaycastResultBuffer[]), IcarianEngine.Physics, PhysicsInterop, Raycast, \
     { \
         uint32_t resultCount; \
@@ -12,6 +12,22 @@ namespace IcarianEngine.Physics {
 
 /// @file EnginePhysicsInteropStructures.h
 
+/// <summary>
+/// How CharacterControllers interact with each other
+/// </summary>
+IOP_CSPUBLIC enum IOP_ENUM_NAME(CharacterInteractionMode) : IOP_UINT32
+{
+    /// <summary>
+    /// CharacterControllers pass through each other
+    /// </summary>
+    IOP_ENUM_VALUE(CharacterInteractionMode, None) = 0,
+    /// <summary>
+    /// CharacterControllers push each other apart based on their positions at the end of the step
+    /// Results do not depend on update order or thread timing
+    /// </summary>
+    IOP_ENUM_VALUE(CharacterInteractionMode, Deterministic) = 1
+};
+
 /// @cond INTERNAL
 
 IOP_PACKED IOP_CSINTERNAL struct RaycastResultBuffer
@@ -54,6 +54,7 @@ static CUBE_CSProject BuildIcarianCSProject(CBBOOL a_optimise, CBBOOL a_enableEx
 
         "./src/AI/NavigationMesh.cs",
         "./src/AI/Navigation.cs",
+        "./src/AI/PathRequest.cs",
 
         "./src/Audio/AudioClip.cs",
         "./src/Audio/AudioListener.cs",
@@ -187,6 +188,27 @@ static CUBE_CSProject BuildIcarianCSProject(CBBOOL a_optimise, CBBOOL a_enableEx
     return project;
 }
 
+// Mono picks up <assembly>.so images next to the assembly and uses them instead of JIT compiling
+// Anything not precompiled (generic instances, dynamic methods) still falls back to the JIT
+// Game and mod assemblies are built outside of the engine build so they are not compiled here
+static CBBOOL AOTCompileCSAssembly(const char* a_workingDirectory, const char* a_mono, const char* a_assembly, CUBE_String** a_lines, CBUINT32* a_lineCount)
+{
+    CUBE_CommandLine commandLine = { 0 };
+
+    CUBE_String_AppendC(&commandLine.Path, a_workingDirectory);
+    CUBE_String_AppendC(&commandLine.Command, a_mono);
+
+    CUBE_CommandLine_AppendArgumentC(&commandLine, "-O=all");
+    CUBE_CommandLine_AppendArgumentC(&commandLine, "--aot");
+    CUBE_CommandLine_AppendArgumentC(&commandLine, a_assembly);
+
+    const int retCode = CUBE_CommandLine_Execute(&commandLine, a_lines, a_lineCount);
+
+    CUBE_CommandLine_Destroy(&commandLine);
+
+    return retCode == 0;
+}
+
 #ifdef __cplusplus
 }
 #endif
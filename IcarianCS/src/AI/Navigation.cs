@@ -11,6 +11,18 @@ namespace IcarianEngine.AI
     {
         [MethodImpl(MethodImplOptions.InternalCall)]
         public extern static Vector3[] GetPath(Vector3 a_startPoint, Vector3 a_endPoint, float a_agentRadius = 1.0f);
+
+        /// <summary>
+        /// Requests a path between points to be generated in the background
+        /// </summary>
+        /// <param name="a_startPoint">The starting point of the path</param>
+        /// <param name="a_endPoint">The ending point of the path</param>
+        /// <param name="a_agentRadius">The radius of the agent following the path</param>
+        /// <returns>The request to get the path from once ready</returns>
+        public static PathRequest RequestPath(Vector3 a_startPoint, Vector3 a_endPoint, float a_agentRadius = 1.0f)
+        {
+            return new PathRequest(NavigationInterop.RequestPath(a_startPoint, a_endPoint, a_agentRadius));
+        }
     }
 }
 
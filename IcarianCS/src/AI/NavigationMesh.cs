@@ -65,6 +65,18 @@ namespace IcarianEngine.AI
             }
         }
 
+        /// <summary>
+        /// Generates a nav mesh from a model and writes it out as a cooked nav mesh
+        /// A cooked nav mesh next to the model with the same name is used in place of the model when up to date
+        /// </summary>
+        /// <param name="a_modelPath">The path of the model to bake</param>
+        /// <param name="a_cookedPath">The path to write the cooked nav mesh to. Should use the .icnav extension</param>
+        /// <returns>Whether the nav mesh was baked</returns>
+        public static bool Bake(string a_modelPath, string a_cookedPath)
+        {
+            return NavigationMeshInterop.BakeMesh(a_modelPath, a_cookedPath) != 0;
+        }
+
         /// <summary>
         /// Gets a path between points
         /// </summary>
@@ -76,6 +88,18 @@ namespace IcarianEngine.AI
             return NavigationMeshInterop.GetPath(m_bufferAddr, a_startPoint, a_endPoint, a_agentRadius);
         }
 
+        /// <summary>
+        /// Requests a path between points to be generated in the background
+        /// </summary>
+        /// <param name="a_startPoint">The starting point of the path</param>
+        /// <param name="a_endPoint">The ending point of the path</param>
+        /// <param name="a_agentRadius">The radius of the agent following the path</param>
+        /// <returns>The request to get the path from once ready</returns>
+        public PathRequest RequestPath(Vector3 a_startPoint, Vector3 a_endPoint, float a_agentRadius = 1.0f)
+        {
+            return new PathRequest(NavigationMeshInterop.RequestPath(m_bufferAddr, a_startPoint, a_endPoint, a_agentRadius));
+        }
+
         /// <summary>
         /// Disposes of the NavigationMesh
         /// </summary>
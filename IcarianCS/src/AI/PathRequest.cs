@@ -0,0 +1,138 @@
+// Icarian Engine - C# Game Engine
+// 
+// License at end of file.
+
+using IcarianEngine.Maths;
+using System;
+using System.Runtime.CompilerServices;
+
+#include "EngineNavigationInterop.h"
+#include "EngineNavigationInteropStructures.h"
+#include "InteropBinding.h"
+
+ENGINE_NAVIGATION_EXPORT_TABLE(IOP_BIND_FUNCTION);
+
+namespace IcarianEngine.AI
+{
+    public class PathRequest : IDestroy
+    {
+        uint m_bufferAddr = uint.MaxValue;
+
+        /// <summary>
+        /// Whether the PathRequest has been Disposed/Finalised
+        /// </summary>
+        public bool IsDisposed
+        {
+            get
+            {
+                return m_bufferAddr == uint.MaxValue;
+            }
+        }
+
+        /// <summary>
+        /// The state of the PathRequest
+        /// </summary>
+        public PathRequestState State
+        {
+            get
+            {
+                if (m_bufferAddr == uint.MaxValue)
+                {
+                    return PathRequestState.Invalid;
+                }
+
+                return (PathRequestState)NavigationInterop.GetPathRequestState(m_bufferAddr);
+            }
+        }
+
+        internal PathRequest(uint a_bufferAddr)
+        {
+            m_bufferAddr = a_bufferAddr;
+        }
+
+        /// <summary>
+        /// Gets the generated path and releases the PathRequest
+        /// </summary>
+        /// <returns>The points that make up the path. Null if still pending</returns>
+        public Vector3[] TakePath()
+        {
+            if (m_bufferAddr == uint.MaxValue)
+            {
+                Logger.IcarianError("PathRequest TakePath on Disposed request");
+
+                return null;
+            }
+
+            PathRequestState state = (PathRequestState)NavigationInterop.GetPathRequestState(m_bufferAddr);
+            if (state == PathRequestState.Pending)
+            {
+                return null;
+            }
+
+            Vector3[] path = NavigationInterop.TakePathRequestPath(m_bufferAddr);
+
+            m_bufferAddr = uint.MaxValue;
+            GC.SuppressFinalize(this);
+
+            return path;
+        }
+
+        /// <summary>
+        /// Disposes of the PathRequest
+        /// </summary>
+        public void Dispose()
+        {
+            Dispose(true);
+
+            GC.SuppressFinalize(this);
+        }
+        /// <summary>
+        /// Called when the PathRequest is being Disposed/Finalised
+        /// </summary>
+        /// <param name="a_disposing">Whether it is being called from Dispose</param>
+        protected virtual void Dispose(bool a_disposing)
+        {
+            if (m_bufferAddr != uint.MaxValue)
+            {
+                if (!a_disposing)
+                {
+                    Logger.IcarianWarning("PathRequest failed to Dispose");
+                }
+
+                NavigationInterop.DestroyPathRequest(m_bufferAddr);
+
+                m_bufferAddr = uint.MaxValue;
+            }
+            else
+            {
+                Logger.IcarianError("Multiple PathRequest Dispose");
+            }
+        }
+        ~PathRequest()
+        {
+            Dispose(false);
+        }
+    }
+}
+
+// MIT License
+// 
+// Copyright (c) 2024 River Govers
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
\ No newline at end of file
@@ -3,6 +3,7 @@
 // License at end of file.
 
 using System;
+using System.Collections.Generic;
 using System.Runtime.CompilerServices;
 using System.Runtime.InteropServices;
 
@@ -12,6 +13,7 @@ namespace IcarianEngine.Audio
     struct AudioMixerBuffer
     {
         public float Gain;
+        public uint ParentAddr;
     };
 
     public class AudioMixer : IDestroy
@@ -26,9 +28,12 @@ namespace IcarianEngine.Audio
         [MethodImpl(MethodImplOptions.InternalCall)]
         extern static void SetAudioMixerBuffer(uint a_addr, AudioMixerBuffer a_buffer);
 
-        string m_name = string.Empty;
+        string           m_name = string.Empty;
 
-        uint   m_bufferAddr = uint.MaxValue;
+        AudioMixer       m_parent = null;
+        List<AudioMixer> m_children = new List<AudioMixer>();
+
+        uint             m_bufferAddr = uint.MaxValue;
 
         internal uint InternalAddr
         {
@@ -81,6 +86,60 @@ namespace IcarianEngine.Audio
             }
         }
 
+        /// <summary>
+        /// The AudioMixer this AudioMixer outputs into. Null outputs to the master output.
+        /// </summary>
+        public AudioMixer Parent
+        {
+            get
+            {
+                return m_parent;
+            }
+            set
+            {
+                for (AudioMixer mixer = value; mixer != null; mixer = mixer.m_parent)
+                {
+                    if (mixer == this)
+                    {
+                        Logger.IcarianError("AudioMixer cannot be parented to itself or a child");
+
+                        return;
+                    }
+                }
+
+                if (m_parent != null)
+                {
+                    m_parent.m_children.Remove(this);
+                }
+
+                m_parent = value;
+
+                AudioMixerBuffer buffer = GetAudioMixerBuffer(m_bufferAddr);
+
+                buffer.ParentAddr = uint.MaxValue;
+                if (m_parent != null)
+                {
+                    m_parent.m_children.Add(this);
+
+                    buffer.ParentAddr = m_parent.InternalAddr;
+                }
+
+                SetAudioMixerBuffer(m_bufferAddr, buffer);
+            }
+        }
+
+        void ClearParent()
+        {
+            m_parent = null;
+
+            if (m_bufferAddr != uint.MaxValue)
+            {
+                AudioMixerBuffer buffer = GetAudioMixerBuffer(m_bufferAddr);
+                buffer.ParentAddr = uint.MaxValue;
+                SetAudioMixerBuffer(m_bufferAddr, buffer);
+            }
+        }
+
         /// <summary>
         /// Creates a new AudioMixer.
         /// </summary>
@@ -112,6 +171,19 @@ namespace IcarianEngine.Audio
             {
                 if (a_disposing)
                 {
+                    // Children would otherwise keep the old address and send it back on their next change
+                    foreach (AudioMixer child in m_children)
+                    {
+                        child.ClearParent();
+                    }
+                    m_children.Clear();
+
+                    if (m_parent != null)
+                    {
+                        m_parent.m_children.Remove(this);
+                        m_parent = null;
+                    }
+
                     DestroyAudioMixer(m_bufferAddr);
                 }
                 else
@@ -18,12 +18,8 @@ namespace IcarianEngine.Audio
         public uint TransformAddr;
         public uint AudioClipAddr;
         public uint AudioMixerAddr;
-        public ulong SampleOffset;
         public uint Flags;
-        uint Source;
-        uint BufferA;
-        uint BufferB;
-        uint BufferC;
+        uint PlayID;
     }
 
     public class AudioSource : Component, IDestroy
@@ -36,6 +32,8 @@ namespace IcarianEngine.Audio
         [MethodImpl(MethodImplOptions.InternalCall)]
         extern static void PlayAudioSource(uint a_addr);
         [MethodImpl(MethodImplOptions.InternalCall)]
+        extern static void StopAudioSource(uint a_addr);
+        [MethodImpl(MethodImplOptions.InternalCall)]
         extern static void SetLoopAudioSource(uint a_addr, uint a_loop);
         [MethodImpl(MethodImplOptions.InternalCall)]
         extern static uint GetAudioSourcePlayingState(uint a_addr);
@@ -44,6 +42,8 @@ namespace IcarianEngine.Audio
         extern static AudioSourceBuffer GetAudioSourceBuffer(uint a_addr);
         [MethodImpl(MethodImplOptions.InternalCall)]
         extern static void SetAudioSourceBuffer(uint a_addr, AudioSourceBuffer a_buffer);
+        [MethodImpl(MethodImplOptions.InternalCall)]
+        extern static uint GetAudioUnderrunCount();
 
         bool       m_disposed = false;
         bool       m_loop = false;
@@ -73,6 +73,17 @@ namespace IcarianEngine.Audio
             }
         }
 
+        /// <summary>
+        /// The number of times the audio output stream has run out of mixed audio before it could be refilled.
+        /// </summary>
+        public static uint UnderrunCount
+        {
+            get
+            {
+                return GetAudioUnderrunCount();
+            }
+        }
+
         /// <summary>
         /// Whether or not the AudioSource is playing.
         /// </summary>
@@ -250,6 +261,17 @@ namespace IcarianEngine.Audio
             }
         }
 
+        /// <summary>
+        /// Stops the AudioSource.
+        /// </summary>
+        public void Stop()
+        {
+            if (m_bufferAddr != uint.MaxValue)
+            {
+                StopAudioSource(m_bufferAddr);
+            }
+        }
+
         /// <summary>
         /// Destroys the AudioSource.
         /// </summary>
@@ -9,9 +9,9 @@ namespace IcarianEngine.Definitions
     public class NavigationMeshDef : ComponentDef
     {
         /// <summary>
-        /// Path relative to the project for the model file to be used
+        /// Path relative to the project for the model or cooked nav mesh file to be used
         /// </summary>
-        [EditorTooltip("Path relative to the project for the model file to be used"), EditorPathString(new string[] { ".obj", ".dae", ".fbx", ".glb", ".gltf"})]
+        [EditorTooltip("Path relative to the project for the model or cooked nav mesh file to be used"), EditorPathString(new string[] { ".obj", ".dae", ".fbx", ".glb", ".gltf", ".icnav"})]
         public string MeshPath;
 
         public NavigationMeshDef()
@@ -2,6 +2,7 @@
 // 
 // License at end of file.
 
+using System;
 using System.Collections.Concurrent;
 using System.Runtime.CompilerServices;
 using System.Runtime.InteropServices;
@@ -27,6 +28,12 @@ namespace IcarianEngine.Networking
         /// <param name="a_client">NetworkClient that received the data</param>
         /// <param name="a_data">Data received</param>
         public delegate void ReceiveCallback(NetworkClient a_client, byte[] a_data);
+        /// <summary>
+        /// Delegate for when the NetworkClient receives data without copying it
+        /// </summary>
+        /// <param name="a_client">NetworkClient that received the data</param>
+        /// <param name="a_data">Data received, only valid for the duration of the call</param>
+        public delegate void ReceiveSegmentCallback(NetworkClient a_client, ArraySegment<byte> a_data);
 
         static ConcurrentDictionary<uint, NetworkClient> s_clients = new ConcurrentDictionary<uint, NetworkClient>();
 
@@ -37,6 +44,10 @@ namespace IcarianEngine.Networking
         /// </summary>
         public ReceiveCallback OnReceive;
         /// <summary>
+        /// Called when the NetworkClient receives data with a view into a shared buffer. Does not allocate unlike OnReceive
+        /// </summary>
+        public ReceiveSegmentCallback OnReceiveSegment;
+        /// <summary>
         /// Called when the NetworkClient is disconnected
         /// </summary>
         public DisconnectCallback OnDisconnect;
@@ -69,6 +80,14 @@ namespace IcarianEngine.Networking
             }
         }
 
+        internal uint InternalAddr
+        {
+            get
+            {
+                return m_bufferAddr;
+            }
+        }
+
         internal NetworkClient(uint a_bufferAddr)
         {
             m_bufferAddr = a_bufferAddr;
@@ -87,20 +106,39 @@ namespace IcarianEngine.Networking
             return null;
         }
 
-        static void Receive(uint a_bufferAddr, byte[] a_data)
+        // Every packet received in an update in one call
+        // Packets are address, offset and size triples into the data buffer
+        static void ReceiveBatch(byte[] a_data, uint[] a_packets, uint a_count)
         {
-            NetworkClient client;
-            if (s_clients.TryGetValue(a_bufferAddr, out client))
+            for (uint i = 0; i < a_count; ++i)
             {
+                uint index = i * 3;
+
+                uint addr = a_packets[index + 0];
+                int offset = (int)a_packets[index + 1];
+                int size = (int)a_packets[index + 2];
+
+                NetworkClient client;
+                if (!s_clients.TryGetValue(addr, out client))
+                {
+                    Logger.IcarianError("Failed to find NetworkClient");
+
+                    continue;
+                }
+
+                if (client.OnReceiveSegment != null)
+                {
+                    client.OnReceiveSegment(client, new ArraySegment<byte>(a_data, offset, size));
+                }
+
                 if (client.OnReceive != null)
                 {
-                    client.OnReceive(client, a_data);
+                    byte[] data = new byte[size];
+                    Array.Copy(a_data, offset, data, 0, size);
+
+                    client.OnReceive(client, data);
                 }
             }
-            else
-            {
-                Logger.IcarianError("Failed to find NetworkClient");
-            }
         }
         static void Disconnect(uint a_bufferAddr, uint a_error)
         {
@@ -142,9 +180,44 @@ namespace IcarianEngine.Networking
         /// </summary>
         /// <param name="a_data">Data to send</param>
         /// <param name="a_flags">Flags for the packet</param>
-        public override void Send(byte[] a_data, PacketFlags a_flags = PacketFlags.None)
+        /// <param name="a_channel">Channel to send the packet on, less than ChannelCount</param>
+        public override void Send(byte[] a_data, PacketFlags a_flags = PacketFlags.None, uint a_channel = 0)
+        {
+            if (a_channel >= ChannelCount)
+            {
+                Logger.IcarianError("NetworkClient invalid channel");
+
+                return;
+            }
+
+            NetworkClientInterop.Send(m_bufferAddr, a_data, (uint)a_flags, a_channel);
+        }
+
+        /// <summary>
+        /// Applies replicated snapshots from the server to a Transform as they arrive
+        /// </summary>
+        /// <param name="a_netID">ID the server replicates the object with</param>
+        /// <param name="a_transform">Transform to apply the snapshots to</param>
+        public void Replicate(uint a_netID, Transform a_transform)
+        {
+            NetworkClientInterop.Replicate(m_bufferAddr, a_netID, a_transform.InternalAddr);
+        }
+        /// <summary>
+        /// Stops applying replicated snapshots for an object
+        /// </summary>
+        /// <param name="a_netID">ID of the object</param>
+        public void StopReplicating(uint a_netID)
+        {
+            NetworkClientInterop.StopReplicating(m_bufferAddr, a_netID);
+        }
+        /// <summary>
+        /// Gets the component state of an object from the latest snapshot
+        /// </summary>
+        /// <param name="a_netID">ID of the object</param>
+        /// <returns>The data, null if the object is not in the latest snapshot</returns>
+        public byte[] GetReplicatedData(uint a_netID)
         {
-            NetworkClientInterop.Send(m_bufferAddr, a_data, (uint)a_flags);
+            return NetworkClientInterop.GetReplicatedData(m_bufferAddr, a_netID);
         }
 
         /// <summary>
@@ -26,6 +26,27 @@ namespace IcarianEngine.Networking
                 return NetworkManagerInterop.IsInitialized() != 0;
             }
         }
+
+        /// <summary>
+        /// Average time in microseconds for a received packet to be handed from the network thread to the game thread.
+        /// </summary>
+        public static uint InboundLatency
+        {
+            get
+            {
+                return NetworkManagerInterop.GetInboundLatency();
+            }
+        }
+        /// <summary>
+        /// Average time in microseconds for a sent packet to be picked up by the network thread.
+        /// </summary>
+        public static uint OutboundLatency
+        {
+            get
+            {
+                return NetworkManagerInterop.GetOutboundLatency();
+            }
+        }
     }
 }
 
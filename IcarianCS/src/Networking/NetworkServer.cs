@@ -23,6 +23,11 @@ namespace IcarianEngine.Networking
         /// <param name="a_client">NetworkClient that connected</param>
         public delegate void ConnectCallback(NetworkServer a_server, NetworkClient a_client);
 
+        /// <summary>
+        /// Maximum size of the data that can be replicated with an object
+        /// </summary>
+        public const int MaxReplicatedDataSize = 32;
+
         static ConcurrentDictionary<uint, NetworkServer> s_servers = new ConcurrentDictionary<uint, NetworkServer>();
 
         uint m_bufferAddr;
@@ -131,9 +136,109 @@ namespace IcarianEngine.Networking
         /// </summary>
         /// <param name="a_data">Data to send</param>
         /// <param name="a_flags">Flags for the packet</param>
-        public override void Send(byte[] a_data, PacketFlags a_flags = PacketFlags.None)
+        /// <param name="a_channel">Channel to send the packet on, less than ChannelCount</param>
+        public override void Send(byte[] a_data, PacketFlags a_flags = PacketFlags.None, uint a_channel = 0)
+        {
+            if (a_channel >= ChannelCount)
+            {
+                Logger.IcarianError("NetworkServer invalid channel");
+
+                return;
+            }
+
+            NetworkServerInterop.Send(m_bufferAddr, a_data, (uint)a_flags, a_channel);
+        }
+        /// <summary>
+        /// Send data to a single client of the NetworkServer
+        /// </summary>
+        /// <param name="a_client">Client to send to</param>
+        /// <param name="a_data">Data to send</param>
+        /// <param name="a_flags">Flags for the packet</param>
+        /// <param name="a_channel">Channel to send the packet on, less than ChannelCount</param>
+        public void SendTo(NetworkClient a_client, byte[] a_data, PacketFlags a_flags = PacketFlags.None, uint a_channel = 0)
+        {
+            SendTo(new NetworkClient[] { a_client }, a_data, a_flags, a_channel);
+        }
+        /// <summary>
+        /// Send data to a set of clients of the NetworkServer. The packet is shared between the clients instead of copied for each
+        /// </summary>
+        /// <param name="a_clients">Clients to send to</param>
+        /// <param name="a_data">Data to send</param>
+        /// <param name="a_flags">Flags for the packet</param>
+        /// <param name="a_channel">Channel to send the packet on, less than ChannelCount</param>
+        public void SendTo(IEnumerable<NetworkClient> a_clients, byte[] a_data, PacketFlags a_flags = PacketFlags.None, uint a_channel = 0)
+        {
+            if (a_channel >= ChannelCount)
+            {
+                Logger.IcarianError("NetworkServer invalid channel");
+
+                return;
+            }
+
+            List<uint> clients = new List<uint>();
+            foreach (NetworkClient client in a_clients)
+            {
+                if (client != null && !client.IsDisposed)
+                {
+                    clients.Add(client.InternalAddr);
+                }
+            }
+
+            if (clients.Count == 0)
+            {
+                return;
+            }
+
+            NetworkServerInterop.SendTo(m_bufferAddr, clients.ToArray(), a_data, (uint)a_flags, a_channel);
+        }
+
+        /// <summary>
+        /// Replicates a Transform to connected clients in snapshots
+        /// </summary>
+        /// <param name="a_netID">ID shared with the clients for the object</param>
+        /// <param name="a_transform">Transform to replicate</param>
+        public void Replicate(uint a_netID, Transform a_transform)
+        {
+            NetworkServerInterop.Replicate(m_bufferAddr, a_netID, a_transform.InternalAddr);
+        }
+        /// <summary>
+        /// Stops replicating an object, clients see it removed from the next snapshot
+        /// </summary>
+        /// <param name="a_netID">ID of the object</param>
+        public void StopReplicating(uint a_netID)
+        {
+            NetworkServerInterop.StopReplicating(m_bufferAddr, a_netID);
+        }
+        /// <summary>
+        /// Sets the component state sent with a replicated object. Only resent when it changes
+        /// </summary>
+        /// <param name="a_netID">ID of the object</param>
+        /// <param name="a_data">Data to replicate, up to MaxReplicatedDataSize bytes</param>
+        public void SetReplicatedData(uint a_netID, byte[] a_data)
+        {
+            if (a_data.Length > MaxReplicatedDataSize)
+            {
+                Logger.IcarianError("NetworkServer replicated data too large");
+
+                return;
+            }
+
+            NetworkServerInterop.SetReplicatedData(m_bufferAddr, a_netID, a_data);
+        }
+        /// <summary>
+        /// Sets how many snapshots are sent per second
+        /// </summary>
+        /// <param name="a_rate">Snapshots per second</param>
+        public void SetSnapshotRate(uint a_rate)
         {
-            NetworkServerInterop.Send(m_bufferAddr, a_data, (uint)a_flags);
+            if (a_rate == 0)
+            {
+                Logger.IcarianError("NetworkServer snapshot rate must be greater than 0");
+
+                return;
+            }
+
+            NetworkServerInterop.SetSnapshotRate(m_bufferAddr, a_rate);
         }
         /// <summary>
         /// Called when the NetworkServer is destroyed
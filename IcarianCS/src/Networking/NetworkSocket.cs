@@ -8,6 +8,11 @@ namespace IcarianEngine.Networking
 {
     public abstract class NetworkSocket : IDestroy
     {
+        /// <summary>
+        /// Number of channels packets can be sent on. Packets on different channels are not ordered against each other
+        /// </summary>
+        public const uint ChannelCount = 3;
+
         /// <summary>
         /// Whether the NetworkSocket has been disposed
         /// </summary>
@@ -37,7 +42,8 @@ namespace IcarianEngine.Networking
         /// </summary>
         /// <param name="a_data">Data to send</param>
         /// <param name="a_flags">Flags for the packet</param>
-        public abstract void Send(byte[] a_data, PacketFlags a_flags = PacketFlags.None);
+        /// <param name="a_channel">Channel to send the packet on, less than ChannelCount</param>
+        public abstract void Send(byte[] a_data, PacketFlags a_flags = PacketFlags.None, uint a_channel = 0);
     }
 }
 
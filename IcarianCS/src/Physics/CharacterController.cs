@@ -63,22 +63,75 @@ namespace IcarianEngine.Physics
         Vector3        m_up = new Vector3(0.0f, -1.0f, 0.0f);
         CollisionShape m_shape = null;
 
+        AdjustVelocityCallback  m_onAdjustVelocity = null;
+        ContactValidateCallback m_onContactValidate = null;
+        ContactAddCallback      m_onContactAdd = null;
+        ContactSolveCallback    m_onContactSolve = null;
+
         /// <summary>
         /// Callback used to adjust velocity of the CharacterController
         /// </summary>
-        public AdjustVelocityCallback OnAdjustVelocityCallback;
+        public AdjustVelocityCallback OnAdjustVelocityCallback
+        {
+            get
+            {
+                return m_onAdjustVelocity;
+            }
+            set
+            {
+                m_onAdjustVelocity = value;
+
+                UpdateListenerState();
+            }
+        }
         /// <summary>
         /// Callback used to validate contact with <see cref="IcarianEngine.Physics.PhysicsBody" />(s)
         /// </summary>
-        public ContactValidateCallback OnContactValidateCallback;
+        public ContactValidateCallback OnContactValidateCallback
+        {
+            get
+            {
+                return m_onContactValidate;
+            }
+            set
+            {
+                m_onContactValidate = value;
+
+                UpdateListenerState();
+            }
+        }
         /// <summary>
         /// Callback when a contact is added to the CharacterController
         /// </summary>
-        public ContactAddCallback OnContactAddCallback;
+        public ContactAddCallback OnContactAddCallback
+        {
+            get
+            {
+                return m_onContactAdd;
+            }
+            set
+            {
+                m_onContactAdd = value;
+
+                UpdateListenerState();
+            }
+        }
         /// <summary>
         /// Callback used to solve collisions with the CharacterController
         /// </summary>
-        public ContactSolveCallback OnContactSolveCallback;
+        public ContactSolveCallback OnContactSolveCallback
+        {
+            get
+            {
+                return m_onContactSolve;
+            }
+            set
+            {
+                m_onContactSolve = value;
+
+                UpdateListenerState();
+            }
+        }
 
         internal uint InternalAddr
         {
@@ -207,6 +260,24 @@ namespace IcarianEngine.Physics
             }
         }
 
+        // Characters without callbacks do not need a listener which lets the engine update them off the main thread
+        void UpdateListenerState()
+        {
+            if (m_internalAddr == uint.MaxValue)
+            {
+                return;
+            }
+
+            if (m_onAdjustVelocity != null || m_onContactValidate != null || m_onContactAdd != null || m_onContactSolve != null)
+            {
+                CharacterControllerInterop.SetListenerState(m_internalAddr, 1);
+            }
+            else
+            {
+                CharacterControllerInterop.SetListenerState(m_internalAddr, 0);
+            }
+        }
+
         void RegenController()
         {
             if (m_internalAddr != uint.MaxValue)
@@ -249,6 +320,8 @@ namespace IcarianEngine.Physics
             }
 
             s_characters[m_internalAddr] = this;
+
+            UpdateListenerState();
         }
 
         internal static CharacterController GetCharacter(uint a_addr)
@@ -51,6 +51,21 @@ namespace IcarianEngine.Physics
             }
         }
 
+        /// <summary>
+        /// How CharacterControllers interact with each other
+        /// </summary>
+        public static CharacterInteractionMode CharacterInteractionMode
+        {
+            get
+            {
+                return (CharacterInteractionMode)PhysicsInterop.GetCharacterInteractionMode();
+            }
+            set
+            {
+                PhysicsInterop.SetCharacterInteractionMode((uint)value);
+            }
+        }
+
         /// <summary>
         /// Checks if 2 ObjectLayers can collide
         /// </summary>
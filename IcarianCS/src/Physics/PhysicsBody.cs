@@ -175,7 +175,7 @@ namespace IcarianEngine.Physics
             return PhysicsBodyInterop.GetRotation(m_internalAddr);
         }
 
-        static void OnCollisionEnter(CollisionDataBuffer a_data)
+        static void OnCollisionEnter(ref CollisionDataBuffer a_data)
         {
             if (!s_bodies.ContainsKey(a_data.BodyAddrA) && !s_bodies.ContainsKey(a_data.BodyAddrB))
             {
@@ -226,7 +226,7 @@ namespace IcarianEngine.Physics
                 }
             }
         }
-        static void OnCollisionStay(CollisionDataBuffer a_data)
+        static void OnCollisionStay(ref CollisionDataBuffer a_data)
         {
             if (!s_bodies.ContainsKey(a_data.BodyAddrA) && !s_bodies.ContainsKey(a_data.BodyAddrB))
             {
@@ -275,7 +275,7 @@ namespace IcarianEngine.Physics
                 }
             }
         }
-        static void OnCollisionExit(CollisionDataBuffer a_data)
+        static void OnCollisionExit(ref CollisionDataBuffer a_data)
         {
             if (!s_bodies.ContainsKey(a_data.BodyAddrA) && !s_bodies.ContainsKey(a_data.BodyAddrB))
             {
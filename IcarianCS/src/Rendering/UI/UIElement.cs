@@ -303,44 +303,55 @@ namespace IcarianEngine.Rendering.UI
             UIElementInterop.RemoveChildElement(BufferAddr, a_child.BufferAddr);
         }
 
-        static void OnNormalS(uint a_canvasAddr, uint a_elementAddr)
+        // Every state change from input in a frame in one call
+        // Events are canvas, element and state triples
+        static void OnStateChangedS(uint[] a_events, uint a_count)
         {
-            Canvas canvas = Canvas.GetCanvas(a_canvasAddr);
-            UIElement element = GetUIElement(a_elementAddr);
-
-            if (element.OnNormal != null)
+            for (uint i = 0; i < a_count; ++i)
             {
-                element.OnNormal.Invoke(canvas, element);
-            }
-        }
-        static void OnHoverS(uint a_canvasAddr, uint a_elementAddr)
-        {
-            Canvas canvas = Canvas.GetCanvas(a_canvasAddr);
-            UIElement element = GetUIElement(a_elementAddr);
+                uint index = i * 3;
 
-            if (element.OnHover != null)
-            {
-                element.OnHover.Invoke(canvas, element);
-            }
-        }
-        static void OnPressedS(uint a_canvasAddr, uint a_elementAddr)
-        {
-            Canvas canvas = Canvas.GetCanvas(a_canvasAddr);
-            UIElement element = GetUIElement(a_elementAddr);
+                Canvas canvas = Canvas.GetCanvas(a_events[index + 0]);
+                UIElement element = GetUIElement(a_events[index + 1]);
+                if (element == null)
+                {
+                    continue;
+                }
 
-            if (element.OnPressed != null)
-            {
-                element.OnPressed.Invoke(canvas, element);
-            }
-        }
-        static void OnReleasedS(uint a_canvasAddr, uint a_elementAddr)
-        {
-            Canvas canvas = Canvas.GetCanvas(a_canvasAddr);
-            UIElement element = GetUIElement(a_elementAddr);
+                UIEvent uiEvent = null;
 
-            if (element.OnReleased != null)
-            {
-                element.OnReleased.Invoke(canvas, element);
+                switch ((ElementState)a_events[index + 2])
+                {
+                case ElementState.Normal:
+                {
+                    uiEvent = element.OnNormal;
+
+                    break;
+                }
+                case ElementState.Hovered:
+                {
+                    uiEvent = element.OnHover;
+
+                    break;
+                }
+                case ElementState.Pressed:
+                {
+                    uiEvent = element.OnPressed;
+
+                    break;
+                }
+                case ElementState.Released:
+                {
+                    uiEvent = element.OnReleased;
+
+                    break;
+                }
+                }
+
+                if (uiEvent != null)
+                {
+                    uiEvent.Invoke(canvas, element);
+                }
             }
         }
 
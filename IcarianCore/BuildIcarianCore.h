@@ -61,7 +61,8 @@ CUBE_CProject BuildIcarianCoreProject(CBBOOL a_enableAssert, e_TargetPlatform a_
         "src/FlareShader.cpp",
         "src/InputBindings.cpp",
         "src/IPCPipe.cpp",
-        "src/MonoNativeImpl.cpp"
+        "src/MonoNativeImpl.cpp",
+        "src/SharedMemory.cpp"
     );
     
     CUBE_CProject_AppendReference(&project, "stdc++");
@@ -23,9 +23,34 @@ namespace IcarianCore
         PipeMessageType_UnlockFrame,
         PipeMessageType_PushFrame,
         PipeMessageType_Message,
+        PipeMessageType_RequestFrameBuffer,
+        PipeMessageType_FrameBuffer,
+        PipeMessageType_PushFrameSlot,
         PipeMessageType_End
     };
 
+    static constexpr uint32_t FrameBufferNameMax = 64;
+
+    // Editors opt in to the shared memory ring with RequestFrameBuffer
+    // Until then frames are sent over the pipe with PushFrame
+    // Announces the shared memory ring frames are written to
+    // Sent again whenever the ring is recreated
+    struct FrameBufferInfo
+    {
+        char Name[FrameBufferNameMax];
+        uint32_t SlotCount;
+        uint32_t SlotSize;
+    };
+
+    // A slot in the ring holds a finished frame
+    // The slot is not written to again until the frame is unlocked
+    struct FrameSlotInfo
+    {
+        uint32_t Slot;
+        uint32_t Width;
+        uint32_t Height;
+    };
+
     struct PipeMessage
     {
         e_PipeMessageType Type;
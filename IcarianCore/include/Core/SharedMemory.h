@@ -0,0 +1,72 @@
+// Icarian Engine - C# Game Engine
+// 
+// License at end of file.
+
+#pragma once
+
+#include "Core/WindowsHeaders.h"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace IcarianCore
+{
+    // Named memory mapping that can be opened by another process
+    class SharedMemory
+    {
+    private:
+#if WIN32
+        HANDLE      m_handle;
+#else
+        int         m_fd;
+        bool        m_owner;
+        std::string m_name;
+#endif
+
+        void*       m_data;
+        uint64_t    m_size;
+
+        SharedMemory();
+
+    protected:
+
+    public:
+        ~SharedMemory();
+
+        static SharedMemory* Create(const std::string_view& a_name, uint64_t a_size);
+        static SharedMemory* Open(const std::string_view& a_name, uint64_t a_size);
+
+        inline void* GetData() const
+        {
+            return m_data;
+        }
+        inline uint64_t GetSize() const
+        {
+            return m_size;
+        }
+    };
+}
+
+
+// MIT License
+// 
+// Copyright (c) 2024 River Govers
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
\ No newline at end of file
@@ -0,0 +1,218 @@
+// Icarian Engine - C# Game Engine
+// 
+// License at end of file.
+
+#include "Core/SharedMemory.h"
+
+#include <cstdio>
+
+#ifndef WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace IcarianCore
+{
+    SharedMemory::SharedMemory()
+    {
+#if WIN32
+        m_handle = NULL;
+#else
+        m_fd = -1;
+        m_owner = false;
+#endif
+
+        m_data = nullptr;
+        m_size = 0;
+    }
+    SharedMemory::~SharedMemory()
+    {
+#if WIN32
+        if (m_data != nullptr)
+        {
+            UnmapViewOfFile(m_data);
+        }
+
+        if (m_handle != NULL)
+        {
+            CloseHandle(m_handle);
+        }
+#else
+        if (m_data != nullptr)
+        {
+            munmap(m_data, (size_t)m_size);
+        }
+
+        if (m_fd >= 0)
+        {
+            close(m_fd);
+        }
+
+        // Existing mappings stay valid after unlinking so the other side can still finish with it
+        if (m_owner)
+        {
+            shm_unlink(m_name.c_str());
+        }
+#endif
+    }
+
+#ifndef WIN32
+    static std::string GetShmName(const std::string_view& a_name)
+    {
+        return "/" + std::string(a_name);
+    }
+#endif
+
+    SharedMemory* SharedMemory::Create(const std::string_view& a_name, uint64_t a_size)
+    {
+#if WIN32
+        const std::string name = std::string(a_name);
+
+        const HANDLE handle = CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, (DWORD)(a_size >> 32), (DWORD)(a_size & 0xFFFFFFFF), name.c_str());
+        if (handle == NULL)
+        {
+            fprintf(stderr, "CreateFileMapping failed: %lu\n", GetLastError());
+
+            return nullptr;
+        }
+
+        void* data = MapViewOfFile(handle, FILE_MAP_ALL_ACCESS, 0, 0, (SIZE_T)a_size);
+        if (data == NULL)
+        {
+            fprintf(stderr, "MapViewOfFile failed: %lu\n", GetLastError());
+
+            CloseHandle(handle);
+
+            return nullptr;
+        }
+
+        SharedMemory* memory = new SharedMemory();
+        memory->m_handle = handle;
+#else
+        const std::string name = GetShmName(a_name);
+
+        // Clear out anything left behind by a crashed process
+        shm_unlink(name.c_str());
+
+        const int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (fd < 0)
+        {
+            perror("shm_open");
+
+            return nullptr;
+        }
+
+        if (ftruncate(fd, (off_t)a_size) != 0)
+        {
+            perror("ftruncate");
+
+            close(fd);
+            shm_unlink(name.c_str());
+
+            return nullptr;
+        }
+
+        void* data = mmap(NULL, (size_t)a_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (data == MAP_FAILED)
+        {
+            perror("mmap");
+
+            close(fd);
+            shm_unlink(name.c_str());
+
+            return nullptr;
+        }
+
+        SharedMemory* memory = new SharedMemory();
+        memory->m_fd = fd;
+        memory->m_owner = true;
+        memory->m_name = name;
+#endif
+
+        memory->m_data = data;
+        memory->m_size = a_size;
+
+        return memory;
+    }
+    SharedMemory* SharedMemory::Open(const std::string_view& a_name, uint64_t a_size)
+    {
+#if WIN32
+        const std::string name = std::string(a_name);
+
+        const HANDLE handle = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, name.c_str());
+        if (handle == NULL)
+        {
+            fprintf(stderr, "OpenFileMapping failed: %lu\n", GetLastError());
+
+            return nullptr;
+        }
+
+        void* data = MapViewOfFile(handle, FILE_MAP_ALL_ACCESS, 0, 0, (SIZE_T)a_size);
+        if (data == NULL)
+        {
+            fprintf(stderr, "MapViewOfFile failed: %lu\n", GetLastError());
+
+            CloseHandle(handle);
+
+            return nullptr;
+        }
+
+        SharedMemory* memory = new SharedMemory();
+        memory->m_handle = handle;
+#else
+        const std::string name = GetShmName(a_name);
+
+        const int fd = shm_open(name.c_str(), O_RDWR, 0600);
+        if (fd < 0)
+        {
+            perror("shm_open");
+
+            return nullptr;
+        }
+
+        void* data = mmap(NULL, (size_t)a_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (data == MAP_FAILED)
+        {
+            perror("mmap");
+
+            close(fd);
+
+            return nullptr;
+        }
+
+        SharedMemory* memory = new SharedMemory();
+        memory->m_fd = fd;
+        memory->m_name = name;
+#endif
+
+        memory->m_data = data;
+        memory->m_size = a_size;
+
+        return memory;
+    }
+}
+
+
+// MIT License
+// 
+// Copyright (c) 2024 River Govers
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
\ No newline at end of file
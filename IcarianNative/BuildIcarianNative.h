@@ -155,6 +155,7 @@ static CUBE_CProject BuildIcarianNativeProject(e_TargetPlatform a_targetPlatform
         "./src/Font.cpp",
         "./src/GamePad.cpp",
         "./src/GLFWAppWindow.cpp",
+        "./src/GlyphAtlas.cpp",
         "./src/H264.cpp",
         "./src/HeadlessAppWindow.cpp",
         "./src/IcarianError.cpp",
@@ -173,8 +174,10 @@ static CUBE_CProject BuildIcarianNativeProject(e_TargetPlatform a_targetPlatform
         "./src/Navigation.cpp",
         "./src/NavigationBindings.cpp",
         "./src/NavigationMesh.cpp",
+        "./src/NavigationPathQueue.cpp",
         "./src/NetworkClient.cpp",
         "./src/NetworkManager.cpp",
+        "./src/NetworkReplication.cpp",
         "./src/NetworkServer.cpp",
         "./src/NullRenderEngineBackend.cpp",
         "./src/ObjectManager.cpp",
@@ -194,9 +197,11 @@ static CUBE_CProject BuildIcarianNativeProject(e_TargetPlatform a_targetPlatform
         "./src/SPIRVTools.cpp",
         "./src/TextUIElement.cpp",
         "./src/ThreadPool.cpp",
+        "./src/UIBatcher.cpp",
         "./src/UIControl.cpp",
         "./src/UIControlBindings.cpp",
         "./src/UIElement.cpp",
+        "./src/UIHitGrid.cpp",
         "./src/VideoClip.cpp",
         "./src/VideoManager.cpp",
         "./src/VideoManagerBindings.cpp",
@@ -218,6 +223,7 @@ static CUBE_CProject BuildIcarianNativeProject(e_TargetPlatform a_targetPlatform
             "./src/Platform/Vulkan/VulkanComputeShader.cpp",
             "./src/Platform/Vulkan/VulkanDepthCubeRenderTexture.cpp",
             "./src/Platform/Vulkan/VulkanDepthRenderTexture.cpp",
+            "./src/Platform/Vulkan/VulkanDynamicVertexBuffer.cpp",
             "./src/Platform/Vulkan/VulkanGraphicsEngine.cpp",
             "./src/Platform/Vulkan/VulkanGraphicsEngineBindings.cpp",
             "./src/Platform/Vulkan/VulkanGraphicsParticle2D.cpp",
@@ -406,6 +412,8 @@ static CUBE_CProject BuildIcarianNativeProject(e_TargetPlatform a_targetPlatform
         CUBE_CProject_AppendReference(&project, "stdc++");
         CUBE_CProject_AppendReference(&project, "atomic");
         CUBE_CProject_AppendReference(&project, "m");
+        // shm_open for the headless frame buffer on older glibc
+        CUBE_CProject_AppendReference(&project, "rt");
 
         break;
     }
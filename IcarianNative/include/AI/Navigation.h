@@ -6,6 +6,7 @@
 
 class NavigationBindings;
 class NavigationMesh;
+class NavigationPathQueue;
 
 #include "DataTypes/TNCArray.h"
 
@@ -13,8 +14,10 @@ class Navigation
 {
 private:
     friend class NavigationBindings;
+    friend class NavigationPathQueue;
 
     NavigationBindings*       m_bindings;
+    NavigationPathQueue*      m_pathQueue;
 
     TNCArray<NavigationMesh*> m_meshes;
 
@@ -23,6 +26,8 @@ protected:
 public:
     Navigation();
     ~Navigation();
+
+    void Update();
 };
 
 // MIT License
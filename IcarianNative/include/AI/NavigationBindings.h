@@ -12,6 +12,8 @@
 
 #include "DataTypes/Array.h"
 
+#include "EngineNavigationInteropStructures.h"
+
 class Navigation;
 
 class NavigationBindings
@@ -27,9 +29,16 @@ public:
 
     uint32_t CreateNavMesh(const std::filesystem::path& a_path) const;
     void DestroyNavMesh(uint32_t a_addr) const;
+    bool BakeNavMesh(const std::filesystem::path& a_modelPath, const std::filesystem::path& a_cookedPath) const;
     Array<glm::vec3> GetNavMeshPath(uint32_t a_addr, const glm::vec3& a_startPoint, const glm::vec3& a_endPoint, float a_agentRadius) const;
 
     Array<glm::vec3> GetNavigationPath(const glm::vec3& a_startPoint, const glm::vec3& a_endPoint, float a_agentRadius) const;
+
+    uint32_t RequestNavMeshPath(uint32_t a_addr, const glm::vec3& a_startPoint, const glm::vec3& a_endPoint, float a_agentRadius) const;
+    uint32_t RequestNavigationPath(const glm::vec3& a_startPoint, const glm::vec3& a_endPoint, float a_agentRadius) const;
+    e_PathRequestState GetPathRequestState(uint32_t a_addr) const;
+    Array<glm::vec3> TakePathRequestPath(uint32_t a_addr) const;
+    void DestroyPathRequest(uint32_t a_addr) const;
 };
 
 // MIT License
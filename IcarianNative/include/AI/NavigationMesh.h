@@ -11,6 +11,10 @@
 
 #include "DataTypes/Array.h"
 
+class MappedFile;
+
+struct NavigationMeshHeader;
+
 struct NavigationFace
 {
     uint32_t Indicies[3];
@@ -23,22 +27,61 @@ struct NavigationFace
 class NavigationMesh
 {
 private:
+    // Keeps the grid from exploding on sparse meshes while still being fine enough to only have a handful of faces per cell
+    static constexpr uint32_t MaxGridDimension = 1024;
+
+    // When loaded from a cooked file all the arrays point into the mapped file instead of owning memory
+    MappedFile*     m_mappedFile;
+
     uint32_t        m_vertexCount;
     glm::vec3*      m_vertices;
 
     uint32_t        m_faceCount;
     NavigationFace* m_faces;
 
+    // Uniform grid over the XZ plane for point lookups
+    // Cell faces are stored contiguously with the cell offsets pointing into the face list
+    glm::vec2       m_gridMin;
+    float           m_gridInvCellSize;
+    uint32_t        m_gridWidth;
+    uint32_t        m_gridHeight;
+    uint32_t*       m_gridCellOffsets;
+    uint32_t        m_gridFaceCount;
+    uint32_t*       m_gridFaces;
+
+    NavigationMesh();
+
+    bool LoadModel(const std::filesystem::path& a_path);
+    static bool ValidateCooked(const NavigationMeshHeader* a_header, const uint8_t* a_faces, const uint8_t* a_cellOffsets, const uint8_t* a_gridFaces);
+    bool LoadCooked(const std::filesystem::path& a_path);
+    bool WriteCooked(const std::filesystem::path& a_path) const;
+
+    void BuildSpatialGrid();
+
+    bool IsPointInFace(const glm::vec3& a_point, uint32_t a_index) const;
+
 protected:
 
 public:
+    // Cooked files use the .icnav extension
+    // Loading a model will use a cooked file next to it if it is up to date
+    static constexpr char CookedExtension[] = ".icnav";
+
     NavigationMesh(const std::filesystem::path& a_path);
     ~NavigationMesh();
 
+    // Generates the nav mesh from a model and writes it out as a cooked file
+    static bool Bake(const std::filesystem::path& a_modelPath, const std::filesystem::path& a_cookedPath);
+
     uint32_t GetIndex(const glm::vec3& a_point) const;
 
     Array<glm::vec3> GeneratePath(const glm::vec3& a_startPoint, const glm::vec3& a_endPoint, float a_agentRadius) const;
     Array<glm::vec3> GeneratePath(const glm::vec3& a_startPoint, const glm::vec3& a_endPoint, uint32_t a_startIndex, uint32_t a_endIndex, float a_agentRadius) const;
+
+    // Finds the faces that need to be crossed to get from the start face to the end face
+    bool FindCorridor(uint32_t a_startIndex, uint32_t a_endIndex, Array<uint32_t>* a_corridor) const;
+    // Pulls a path tight through a corridor of faces
+    Array<glm::vec3> BuildPath(const Array<uint32_t>& a_corridor, const glm::vec3& a_startPoint, const glm::vec3& a_endPoint, float a_agentRadius) const;
 };
 
 // MIT License
@@ -0,0 +1,108 @@
+// Icarian Engine - C# Game Engine
+// 
+// License at end of file.
+
+#pragma once
+
+#define GLM_FORCE_SWIZZLE 
+#include <glm/glm.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include "DataTypes/Array.h"
+#include "DataTypes/SpinLock.h"
+#include "DataTypes/TNCArray.h"
+
+#include "EngineNavigationInteropStructures.h"
+
+class Navigation;
+
+struct NavigationPathRequest
+{
+    uint32_t           MeshAddr;
+    uint32_t           StartFace;
+    uint32_t           EndFace;
+    glm::vec3          StartPoint;
+    glm::vec3          EndPoint;
+    float              AgentRadius;
+    e_PathRequestState State;
+    // Handle has been released while the request was in flight so whoever holds it cleans it up
+    bool               Released;
+    Array<glm::vec3>   Path;
+};
+
+// Paths are requested by the runtime and generated on worker threads over the following frames
+// Requests that share start and end faces in the same frame only search the mesh once
+class NavigationPathQueue
+{
+private:
+    // Wall time the workers can spend on a batch before the remaining requests get pushed to the next frame
+    static constexpr std::chrono::microseconds FrameBudget = std::chrono::microseconds(2000);
+
+    struct PathGroup
+    {
+        uint32_t MeshAddr;
+        uint32_t StartFace;
+        uint32_t EndFace;
+        uint32_t Start;
+        uint32_t Count;
+    };
+
+    Navigation*                           m_navigation;
+
+    SpinLock                              m_lock;
+    TNCArray<NavigationPathRequest*>      m_requests;
+    Array<NavigationPathRequest*>         m_pending;
+
+    Array<NavigationPathRequest*>         m_batch;
+    Array<PathGroup>                      m_groups;
+    std::atomic<uint32_t>                 m_groupCursor;
+    std::atomic<uint32_t>                 m_activeJobs;
+    std::chrono::steady_clock::time_point m_deadline;
+
+    void RequeueBatch();
+    void BuildBatch();
+
+    void ProcessGroup(uint32_t a_index);
+
+protected:
+
+public:
+    NavigationPathQueue(Navigation* a_navigation);
+    ~NavigationPathQueue();
+
+    uint32_t PushRequest(uint32_t a_meshAddr, const glm::vec3& a_startPoint, const glm::vec3& a_endPoint, float a_agentRadius);
+
+    e_PathRequestState GetState(uint32_t a_addr);
+    // Gets the generated path and releases the request once it is no longer pending
+    Array<glm::vec3> TakePath(uint32_t a_addr);
+    void DestroyRequest(uint32_t a_addr);
+
+    void RunWorker();
+
+    void Update();
+};
+
+// MIT License
+// 
+// Copyright (c) 2024 River Govers
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
\ No newline at end of file
@@ -12,6 +12,7 @@
 
 #include "Core/IPCPipe.h"
 #include "Core/PipeMessage.h"
+#include "Core/SharedMemory.h"
 #include "DataTypes/TArray.h"
 #include "Logger.h"
 #include "Profiler.h"
@@ -38,6 +39,9 @@ private:
 
     static constexpr char PipeName[] = "IcarianEngine-IPC";
 
+    // One being read by the editor, one waiting to be sent and one being written
+    static constexpr uint32_t FrameSlotCount = 3;
+
     IcarianCore::IPCPipe*                          m_pipe;
 
     volatile bool                                  m_unlockWindow;    
@@ -47,8 +51,17 @@ private:
 
     TArray<IcarianCore::PipeMessage>               m_queuedMessages;
 
+    // Used until the editor requests the shared frame buffer or when it is not available
     char*                                          m_frameData;
 
+    IcarianCore::SharedMemory*                     m_frameBuffer;
+    uint32_t                                       m_frameBufferGeneration;
+    uint32_t                                       m_frameSlotSize;
+    uint32_t                                       m_readSlot;
+    uint32_t                                       m_readySlot;
+    bool                                           m_useFrameBuffer;
+    bool                                           m_announceFrameBuffer;
+
     uint32_t                                       m_width;
     uint32_t                                       m_height;
 
@@ -59,6 +72,8 @@ private:
 
     void PushMessageQueue();
 
+    void CreateFrameBuffer();
+
     void MessageCallback(const std::string_view& a_message, e_LoggerMessageType a_type);
     void ProfilerCallback(const Profiler::PData& a_profilerData);
 
@@ -6,7 +6,7 @@
 
 #include <cstdint>
 
-class RingAllocator;
+class FrameAllocator;
 
 enum e_AudioFormat : uint16_t
 {
@@ -14,6 +14,20 @@ enum e_AudioFormat : uint16_t
     AudioFormat_S16
 };
 
+// Streaming state for a single voice playing a clip
+// Lets voices read sequentially without fighting over a shared cursor
+class AudioClipDecoder
+{
+private:
+
+protected:
+
+public:
+    virtual ~AudioClipDecoder() = default;
+
+    virtual uint8_t* GetAudioData(FrameAllocator* a_allocator, uint64_t a_sampleOffset, uint32_t a_sampleSize, uint32_t* a_outSampleSize) = 0;
+};
+
 class AudioClip
 {
 private:
@@ -34,7 +48,19 @@ public:
         return AudioFormat_S16;
     }
 
-    virtual uint8_t* GetAudioData(RingAllocator* a_allocator, uint64_t a_sampleOffset, uint32_t a_sampleSize, uint32_t* a_outSampleSize) = 0;
+    // Bytes held by the clip in the decoded audio cache
+    virtual uint64_t GetCachedSize() const
+    {
+        return 0;
+    }
+
+    // Null if the clip can be read from directly without per voice state
+    virtual AudioClipDecoder* CreateDecoder()
+    {
+        return nullptr;
+    }
+
+    virtual uint8_t* GetAudioData(FrameAllocator* a_allocator, uint64_t a_sampleOffset, uint32_t a_sampleSize, uint32_t* a_outSampleSize) = 0;
 };
 
 // MIT License
@@ -11,30 +11,62 @@
 #define STB_VORBIS_HEADER_ONLY
 #include <stb_vorbis.c>
 
+class OGGAudioDecoder : public AudioClipDecoder
+{
+private:
+    stb_vorbis* m_stream;
+    uint32_t    m_channelCount;
+    uint64_t    m_sampleOffset;
+
+protected:
+
+public:
+    OGGAudioDecoder(const uint8_t* a_data, uint64_t a_size, uint32_t a_channelCount);
+    virtual ~OGGAudioDecoder();
+
+    virtual uint8_t* GetAudioData(FrameAllocator* a_allocator, uint64_t a_sampleOffset, uint32_t a_sampleSize, uint32_t* a_outSampleSize);
+};
+
 class OGGAudioClip : public AudioClip
 {
 private:
     std::filesystem::path m_path;
 
+    // Encoded file is kept in memory so each voice can open its own decoder on it
+    uint8_t*              m_data;
+    uint64_t              m_dataSize;
+
     stb_vorbis*           m_stream;
     stb_vorbis_info       m_info;
 
     uint64_t              m_sampleSize;
     float                 m_duration;
 
+    // Fully decoded audio for short clips so voices only need to copy
+    int16_t*              m_pcm;
+
 protected:
 
 public:
     OGGAudioClip(const std::filesystem::path& a_path);
     virtual ~OGGAudioClip();
 
+    // Size of the clip when fully decoded
+    uint64_t GetDecodedSize() const;
+    // Decodes the whole clip into memory
+    bool PreDecode();
+
     virtual float GetDuration() const;
 
     virtual uint32_t GetSampleRate() const;
     virtual uint32_t GetChannelCount() const;
     virtual uint64_t GetSampleSize() const;
 
-    virtual uint8_t* GetAudioData(RingAllocator* a_allocator, uint64_t a_sampleOffset, uint32_t a_sampleSize, uint32_t* a_outSampleSize);
+    virtual uint64_t GetCachedSize() const;
+
+    virtual AudioClipDecoder* CreateDecoder();
+
+    virtual uint8_t* GetAudioData(FrameAllocator* a_allocator, uint64_t a_sampleOffset, uint32_t a_sampleSize, uint32_t* a_outSampleSize);
 };
 
 // MIT License
@@ -8,6 +8,8 @@
 
 #include <filesystem>
 
+class MappedFile;
+
 class WAVAudioClip : public AudioClip
 {
 private:
@@ -21,6 +23,12 @@ private:
     uint64_t              m_dataOffset;
     uint64_t              m_dataSize;
 
+    // Sample data is either mapped from the file or read in once if the file cannot be mapped
+    // Buffers are served as slices of it so nothing is read or copied per buffer
+    MappedFile*           m_file;
+    uint8_t*              m_residentData;
+    const uint8_t*        m_data;
+
 protected:
 
 public:
@@ -33,7 +41,7 @@ public:
     virtual uint32_t GetChannelCount() const;
     virtual uint64_t GetSampleSize() const;
 
-    virtual uint8_t* GetAudioData(RingAllocator* a_allocator, uint64_t a_sampleOffset, uint32_t a_sampleSize, uint32_t* a_outSampleSize);
+    virtual uint8_t* GetAudioData(FrameAllocator* a_allocator, uint64_t a_sampleOffset, uint32_t a_sampleSize, uint32_t* a_outSampleSize);
 };
 
 // MIT License
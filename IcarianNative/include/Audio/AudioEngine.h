@@ -6,40 +6,181 @@
 
 #include <AL/al.h>
 #include <AL/alc.h>
+#include <atomic>
 #include <cstdint>
+#include <thread>
 
 #include "Audio/AudioListenerBuffer.h"
 #include "Audio/AudioMixerBuffer.h"
 #include "Audio/AudioSourceBuffer.h"
+#include "DataTypes/Array.h"
+#include "DataTypes/TLockFreeQueue.h"
 #include "DataTypes/TNCArray.h"
 
 class AudioClip;
 class AudioEngineBindings;
+class Config;
+class FrameAllocator;
+
+enum e_AudioCommandType : uint32_t
+{
+    AudioCommandType_Null,
+    AudioCommandType_Play,
+    AudioCommandType_Stop,
+    AudioCommandType_SetLoop,
+    AudioCommandType_SetClip,
+    AudioCommandType_SetMixer,
+    AudioCommandType_SetTransform,
+    AudioCommandType_DestroySource,
+    AudioCommandType_SetMixerBus,
+    AudioCommandType_DestroyMixer,
+    AudioCommandType_SetListenerTransform,
+    AudioCommandType_DestroyClip
+};
+
+// Changes sent from the bindings and update thread to the audio thread
+// Value is the clip, mixer, parent mixer or loop state depending on the command
+struct AudioCommand
+{
+    e_AudioCommandType Type;
+    uint32_t Addr;
+    uint32_t Value;
+    uint32_t PlayID;
+    float Gain;
+    glm::vec3 Position;
+    glm::vec3 Forward;
+    glm::vec3 Up;
+};
+
+struct AudioFinishedNotification
+{
+    uint32_t Addr;
+    uint32_t PlayID;
+};
+
+// Audio thread side of an AudioMixer
+struct AudioBus
+{
+    float Gain;
+    uint32_t ParentAddr;
+    // Recalculated every mix
+    float EffectiveGain;
+    uint32_t Depth;
+};
 
 class AudioEngine
 {
 private:
     friend class AudioEngineBindings;
 
-    constexpr static uint32_t AudioBufferSampleSize = 4096;
+    // Output buffers are ~21ms at 48KHz so refilling every few milliseconds leaves plenty of headroom before the output runs dry
+    constexpr static uint32_t OutputFrameCount = 1024;
+    constexpr static uint32_t OutputBufferCount = 4;
+    constexpr static uint32_t DefaultOutputRate = 48000;
+    constexpr static uint32_t AudioThreadIntervalMs = 5;
+    // Clips more than 4 times the output rate get pitched down rather than needing an unbounded staging buffer
+    constexpr static uint32_t MaxResampleStep = 4;
+    constexpr static uint32_t ReadFrameCount = 1024;
+    constexpr static uint32_t StagingFrameCount = OutputFrameCount * MaxResampleStep + ReadFrameCount;
+    // Anything past this or too quiet to hear keeps its position but is not decoded or mixed
+    constexpr static uint32_t MaxRealVoices = 128;
+    constexpr static float AudibleThreshold = 0.001f;
+    // Guards against cycles in the bus hierarchy
+    constexpr static uint32_t MaxBusDepth = 16;
+    constexpr static uint32_t AudioCommandQueueSize = 16384;
+    constexpr static uint32_t AudioNotificationQueueSize = 4096;
+    // Around 10 seconds of 48KHz stereo, anything longer is better off streamed
+    constexpr static uint64_t MaxPreDecodeSize = 1024 * 1024 * 2;
+
+    AudioEngineBindings*                                                   m_bindings;
+
+    ALCdevice*                                                             m_device;
+    ALCcontext*                                                            m_context;
+
+    std::thread                                                            m_thread;
+    std::atomic<bool>                                                      m_shutdown;
+    std::atomic<uint32_t>                                                  m_playID;
+    std::atomic<uint32_t>                                                  m_underrunCount;
 
-    AudioEngineBindings*          m_bindings;
+    // Memory budget for fully decoded clips
+    uint64_t                                                               m_cacheSize;
+    std::atomic<uint64_t>                                                  m_cacheUsed;
 
-    ALCdevice*                    m_device;
-    ALCcontext*                   m_context;
+    TLockFreeQueue<AudioCommand, AudioCommandQueueSize>                    m_commands;
+    TLockFreeQueue<AudioFinishedNotification, AudioNotificationQueueSize>  m_finished;
 
-    TNCArray<AudioClip*>          m_audioClips;
-    TNCArray<AudioSourceBuffer>   m_audioSources;
-    TNCArray<AudioListenerBuffer> m_audioListeners;
-    TNCArray<AudioMixerBuffer>    m_audioMixers;
+    TNCArray<AudioClip*>                                                   m_audioClips;
+    TNCArray<AudioSourceBuffer>                                            m_audioSources;
+    TNCArray<AudioListenerBuffer>                                          m_audioListeners;
+    TNCArray<AudioMixerBuffer>                                             m_audioMixers;
+
+    // Audio thread state
+    ALuint                                                                 m_outputSource;
+    ALuint                                                                 m_outputBuffers[OutputBufferCount];
+    uint32_t                                                               m_outputRate;
+
+    glm::vec3                                                              m_listenerPosition;
+    glm::vec3                                                              m_listenerRight;
+
+    Array<AudioSourceVoice>                                                m_voices;
+    Array<AudioBus>                                                        m_buses;
+    Array<uint32_t>                                                        m_realVoices;
+    Array<uint32_t>                                                        m_busOrder;
+
+    // Interleaved stereo scratch buffers, bus buffers are OutputFrameCount * 2 per bus
+    Array<float>                                                           m_busBuffers;
+    float*                                                                 m_masterBuffer;
+    float*                                                                 m_voiceBuffer;
+    int16_t*                                                               m_outputBuffer;
+
+    void Run();
+
+    AudioSourceVoice* GetVoice(uint32_t a_addr);
+    AudioBus* GetBus(uint32_t a_addr);
+
+    bool ReserveCache(uint64_t a_size);
+    void ReleaseCache(uint64_t a_size);
+
+    void StopVoice(uint32_t a_addr, AudioSourceVoice* a_voice);
+    void ProcessCommand(const AudioCommand& a_command);
+
+    void FillStaging(FrameAllocator* a_allocator, AudioSourceVoice* a_voice, AudioClip* a_clip, uint32_t a_frameCount);
+    // Return true when the voice has finished
+    bool MixVoice(FrameAllocator* a_allocator, AudioSourceVoice* a_voice, AudioClip* a_clip, float* a_output);
+    bool SkipVoice(AudioSourceVoice* a_voice, AudioClip* a_clip);
+
+    void UpdateBuses();
+    void UpdateVoices();
+    void MixBlock(FrameAllocator* a_allocator);
+    void UpdateOutput(FrameAllocator* a_allocator);
+
+    // Commands are dropped when there is no audio device as nothing will consume them
+    inline bool PushCommand(const AudioCommand& a_command)
+    {
+        if (!m_thread.joinable())
+        {
+            return false;
+        }
+
+        m_commands.Push(a_command);
+
+        return true;
+    }
 
 protected:
 
 public:
-    AudioEngine();
+    AudioEngine(Config* a_config);
     ~AudioEngine();
 
+    // Sends transforms to the audio thread and collects finished sources
     void Update();
+
+    // Times the output ran out of queued buffers before the audio thread refilled them
+    inline uint32_t GetUnderrunCount() const
+    {
+        return m_underrunCount.load(std::memory_order_relaxed);
+    }
 };
 
 // MIT License
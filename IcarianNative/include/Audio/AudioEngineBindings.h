@@ -17,6 +17,8 @@ class AudioEngineBindings
 private:
     AudioEngine* m_engine;
 
+    void QueuePlay(uint32_t a_addr, AudioSourceBuffer* a_buffer) const;
+
 protected:
 
 public:
@@ -32,10 +34,12 @@ public:
     uint32_t GenerateAudioSource(uint32_t a_transformAddr, uint32_t a_clipAddr) const;
     void DestroyAudioSource(uint32_t a_addr) const;
     void PlayAudioSource(uint32_t a_addr) const;
+    void StopAudioSource(uint32_t a_addr) const;
     void SetLoopAudioSource(uint32_t a_addr, bool a_loop) const;
     bool GetAudioSourcePlayingState(uint32_t a_addr) const;
     AudioSourceBuffer GetAudioSourceBuffer(uint32_t a_addr) const;
     void SetAudioSourceBuffer(uint32_t a_addr, const AudioSourceBuffer& a_buffer) const;
+    uint32_t GetAudioUnderrunCount() const;
 
     uint32_t GenerateAudioMixer() const;
     void DestroyAudioMixer(uint32_t a_addr) const;
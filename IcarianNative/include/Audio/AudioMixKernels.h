@@ -0,0 +1,216 @@
+// Icarian Engine - C# Game Engine
+// 
+// License at end of file.
+
+#pragma once
+
+#include <cstdint>
+#include <string.h>
+
+// x86_64 always has SSE2 so there is no need for a runtime check
+#if defined(__x86_64__) || defined(_M_X64)
+#include <emmintrin.h>
+#define ICARIAN_AUDIO_SSE
+#endif
+
+// Kernels used by the software mixer
+// All stereo buffers are interleaved left right
+
+// Adds a mono buffer into a stereo buffer panning with the left and right gains
+inline void MixMonoToStereo(float* a_dst, const float* a_src, uint32_t a_frames, float a_gainL, float a_gainR)
+{
+    uint32_t i = 0;
+
+#ifdef ICARIAN_AUDIO_SSE
+    const __m128 gain = _mm_setr_ps(a_gainL, a_gainR, a_gainL, a_gainR);
+
+    for (; i + 4 <= a_frames; i += 4)
+    {
+        const __m128 src = _mm_loadu_ps(a_src + i);
+
+        // s0 s0 s1 s1 and s2 s2 s3 s3
+        const __m128 lo = _mm_unpacklo_ps(src, src);
+        const __m128 hi = _mm_unpackhi_ps(src, src);
+
+        float* dst = a_dst + i * 2;
+        _mm_storeu_ps(dst, _mm_add_ps(_mm_loadu_ps(dst), _mm_mul_ps(lo, gain)));
+        _mm_storeu_ps(dst + 4, _mm_add_ps(_mm_loadu_ps(dst + 4), _mm_mul_ps(hi, gain)));
+    }
+#endif
+
+    for (; i < a_frames; ++i)
+    {
+        a_dst[i * 2 + 0] += a_src[i] * a_gainL;
+        a_dst[i * 2 + 1] += a_src[i] * a_gainR;
+    }
+}
+
+// Adds a stereo buffer into a stereo buffer with the left and right gains
+inline void MixStereo(float* a_dst, const float* a_src, uint32_t a_frames, float a_gainL, float a_gainR)
+{
+    const uint32_t count = a_frames * 2;
+    uint32_t i = 0;
+
+#ifdef ICARIAN_AUDIO_SSE
+    const __m128 gain = _mm_setr_ps(a_gainL, a_gainR, a_gainL, a_gainR);
+
+    for (; i + 4 <= count; i += 4)
+    {
+        const __m128 src = _mm_loadu_ps(a_src + i);
+
+        _mm_storeu_ps(a_dst + i, _mm_add_ps(_mm_loadu_ps(a_dst + i), _mm_mul_ps(src, gain)));
+    }
+#endif
+
+    for (; i < count; i += 2)
+    {
+        a_dst[i + 0] += a_src[i + 0] * a_gainL;
+        a_dst[i + 1] += a_src[i + 1] * a_gainR;
+    }
+}
+
+inline void ConvertS16ToFloat(float* a_dst, const int16_t* a_src, uint32_t a_count)
+{
+    constexpr float Scale = 1.0f / 32768.0f;
+
+    uint32_t i = 0;
+
+#ifdef ICARIAN_AUDIO_SSE
+    const __m128 scale = _mm_set1_ps(Scale);
+
+    for (; i + 8 <= a_count; i += 8)
+    {
+        const __m128i src = _mm_loadu_si128((const __m128i*)(a_src + i));
+
+        // Shift into the top half then arithmetic shift back down to sign extend
+        const __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(src, src), 16);
+        const __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(src, src), 16);
+
+        _mm_storeu_ps(a_dst + i, _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+        _mm_storeu_ps(a_dst + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+    }
+#endif
+
+    for (; i < a_count; ++i)
+    {
+        a_dst[i] = a_src[i] * Scale;
+    }
+}
+
+inline void ConvertU8ToFloat(float* a_dst, const uint8_t* a_src, uint32_t a_count)
+{
+    constexpr float Scale = 1.0f / 128.0f;
+
+    for (uint32_t i = 0; i < a_count; ++i)
+    {
+        a_dst[i] = ((int32_t)a_src[i] - 128) * Scale;
+    }
+}
+
+// Clamps to the range of a short
+inline void ConvertFloatToS16(int16_t* a_dst, const float* a_src, uint32_t a_count)
+{
+    constexpr float Scale = 32767.0f;
+
+    uint32_t i = 0;
+
+#ifdef ICARIAN_AUDIO_SSE
+    const __m128 scale = _mm_set1_ps(Scale);
+
+    for (; i + 8 <= a_count; i += 8)
+    {
+        const __m128i lo = _mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(a_src + i), scale));
+        const __m128i hi = _mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(a_src + i + 4), scale));
+
+        // Pack saturates so no need to clamp beforehand
+        _mm_storeu_si128((__m128i*)(a_dst + i), _mm_packs_epi32(lo, hi));
+    }
+#endif
+
+    for (; i < a_count; ++i)
+    {
+        float val = a_src[i] * Scale;
+        if (val > 32767.0f)
+        {
+            val = 32767.0f;
+        }
+        else if (val < -32768.0f)
+        {
+            val = -32768.0f;
+        }
+
+        a_dst[i] = (int16_t)val;
+    }
+}
+
+// Linear resample of interleaved frames
+// The source needs to have enough frames to cover a_fraction + (a_frames - 1) * a_step + 1
+inline void ResampleLinear(float* a_dst, const float* a_src, uint32_t a_channelCount, double a_fraction, double a_step, uint32_t a_frames)
+{
+    // Common case of the clip matching the output rate
+    if (a_step == 1.0 && a_fraction == 0.0)
+    {
+        memcpy(a_dst, a_src, a_frames * a_channelCount * sizeof(float));
+
+        return;
+    }
+
+    double pos = a_fraction;
+    switch (a_channelCount)
+    {
+    case 1:
+    {
+        for (uint32_t i = 0; i < a_frames; ++i)
+        {
+            const uint32_t index = (uint32_t)pos;
+            const float t = (float)(pos - index);
+
+            a_dst[i] = a_src[index] + (a_src[index + 1] - a_src[index]) * t;
+
+            pos += a_step;
+        }
+
+        break;
+    }
+    case 2:
+    {
+        for (uint32_t i = 0; i < a_frames; ++i)
+        {
+            const uint32_t index = (uint32_t)pos;
+            const float t = (float)(pos - index);
+
+            const float* a = a_src + index * 2;
+            const float* b = a + 2;
+
+            a_dst[i * 2 + 0] = a[0] + (b[0] - a[0]) * t;
+            a_dst[i * 2 + 1] = a[1] + (b[1] - a[1]) * t;
+
+            pos += a_step;
+        }
+
+        break;
+    }
+    }
+}
+
+// MIT License
+// 
+// Copyright (c) 2024 River Govers
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
\ No newline at end of file
@@ -4,9 +4,13 @@
 
 #pragma once
 
+#include <cstdint>
+
 struct AudioMixerBuffer
 {
     float Gain;
+    // Mixer this mixer outputs into, -1 for the master output
+    uint32_t ParentAddr;
 };
 
 // MIT License
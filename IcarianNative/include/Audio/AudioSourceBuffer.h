@@ -4,25 +4,53 @@
 
 #pragma once
 
-#include <AL/al.h>
+#define GLM_FORCE_SWIZZLE 
+#include <glm/glm.hpp>
 
 #include <cstdint>
 
+class AudioClipDecoder;
+
 struct AudioSourceBuffer
 {
     static constexpr uint32_t PlayBitOffset = 0;
     static constexpr uint32_t LoopBitOffset = 1;
     static constexpr uint32_t PlayingBitOffset = 2;
 
-    static constexpr uint32_t BufferCount = 3;
-
     uint32_t TransformAddr;
     uint32_t AudioClipAddr;
     uint32_t AudioMixerAddr;
-    uint64_t SampleOffset;
     uint32_t Flags;
-    ALuint Source;
-    ALuint Buffers[BufferCount];
+    // Used to match finished notifications from the audio thread to the play that caused them
+    uint32_t PlayID;
+};
+
+// Audio thread side of an AudioSource
+// Only ever touched by the audio thread
+struct AudioSourceVoice
+{
+    static constexpr uint32_t PlayingBitOffset = 0;
+    static constexpr uint32_t LoopBitOffset = 1;
+    static constexpr uint32_t EndedBitOffset = 2;
+    static constexpr uint32_t VirtualBitOffset = 3;
+
+    uint32_t AudioClipAddr;
+    uint32_t AudioMixerAddr;
+    uint32_t PlayID;
+    uint32_t Flags;
+    // Next frame to read from the clip
+    uint64_t SampleOffset;
+    // Read position between the first two staged frames
+    double Fraction;
+    // Decoded frames waiting to be resampled
+    float* Staging;
+    uint32_t StagingCount;
+    // Recalculated every mix
+    float GainL;
+    float GainR;
+    float Audibility;
+    glm::vec3 Position;
+    AudioClipDecoder* Decoder;
 };
 
 // MIT License
@@ -18,6 +18,7 @@ private:
 
     double            m_fixedTimeStep = 1.0 / 50.0;
     uint32_t          m_fileCacheSize = 256;
+    uint32_t          m_audioCacheSize = 64;
 
     std::string       m_appName = std::string(DefaultAppName);
 
@@ -38,6 +39,10 @@ public:
     {
         return m_fileCacheSize;
     }
+    inline uint32_t GetAudioCacheSize() const
+    {
+        return m_audioCacheSize;
+    }
 
     inline const std::string GetApplicationName() const
     {
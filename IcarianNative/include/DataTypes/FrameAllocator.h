@@ -0,0 +1,212 @@
+// Icarian Engine - C# Game Engine
+// 
+// License at end of file.
+
+#pragma once
+
+#include <cstdint>
+#include <cstdlib>
+
+#include "DataTypes/Array.h"
+#include "IcarianError.h"
+
+#ifdef DEBUG
+#include <string>
+
+#include "Logger.h"
+#endif
+
+#ifdef WIN32
+#include "Core/WindowsHeaders.h"
+#elif defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+// A no deallocation allocator for scratch memory that only lives for a frame
+// Owned by a single thread and reset at the start of each of its frames so the memory is kept and reused instead of mapped every frame
+// Running out of space falls back to the heap instead of overwriting live allocations and the arena grows to fit on the next reset
+class FrameAllocator
+{
+private:
+    // Keeps SIMD loads and stores on allocations happy
+    static constexpr uint64_t Alignment = 16;
+
+    void*        m_memory;
+    void*        m_slider;
+    void*        m_end;
+
+    // Allocations that did not fit this frame
+    Array<void*> m_overflow;
+    uint64_t     m_overflowSize;
+
+#ifdef DEBUG
+    const char*  m_name;
+    uint64_t     m_peakUsed;
+#endif
+
+    static void* MapMemory(uint64_t a_size)
+    {
+#ifdef WIN32
+        void* memory = VirtualAlloc(nullptr, a_size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+#elif defined(__linux__)
+        void* memory = mmap(nullptr, a_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (memory == MAP_FAILED)
+        {
+            memory = nullptr;
+        }
+#else
+        // Fall back to malloc
+        void* memory = malloc(a_size);
+#endif
+
+        if (memory == nullptr)
+        {
+            IERROR("Failed to map frame allocator memory");
+        }
+
+        return memory;
+    }
+    static void UnmapMemory(void* a_memory, uint64_t a_size)
+    {
+#ifdef WIN32
+        VirtualFree(a_memory, 0, MEM_RELEASE);
+#elif defined(__linux__)
+        munmap(a_memory, a_size);
+#else
+        free(a_memory);
+#endif
+    }
+
+protected:
+
+public:
+    FrameAllocator([[maybe_unused]] const char* a_name, uint64_t a_size)
+    {
+        m_memory = MapMemory(a_size);
+        m_slider = m_memory;
+        m_end = (void*)((char*)m_memory + a_size);
+
+        m_overflowSize = 0;
+
+#ifdef DEBUG
+        m_name = a_name;
+        m_peakUsed = 0;
+#endif
+    }
+    ~FrameAllocator()
+    {
+        for (void* memory : m_overflow)
+        {
+            free(memory);
+        }
+
+        UnmapMemory(m_memory, GetSize());
+    }
+
+    // Copies would unmap the same memory twice
+    FrameAllocator(const FrameAllocator& a_other) = delete;
+    FrameAllocator& operator =(const FrameAllocator& a_other) = delete;
+
+    inline uint64_t GetSize() const
+    {
+        return (uint64_t)((char*)m_end - (char*)m_memory);
+    }
+    inline uint64_t GetUsed() const
+    {
+        return (uint64_t)((char*)m_slider - (char*)m_memory) + m_overflowSize;
+    }
+#ifdef DEBUG
+    inline uint64_t GetPeakUsed() const
+    {
+        return m_peakUsed;
+    }
+#endif
+
+    void* Allocate(uint64_t a_size)
+    {
+        const uint64_t size = (a_size + Alignment - 1) & ~(Alignment - 1);
+
+        if ((char*)m_slider + size > (char*)m_end)
+        {
+            // Rare and only until the next reset so just use the heap
+            void* memory = malloc(size);
+            m_overflow.Push(memory);
+            m_overflowSize += size;
+
+            return memory;
+        }
+
+        void* result = m_slider;
+        m_slider = (void*)((char*)m_slider + size);
+
+        return result;
+    }
+    template<typename T>
+    inline T* Allocate()
+    {
+        return (T*)Allocate(sizeof(T));
+    }
+    template<typename T>
+    inline T* Allocate(uint64_t a_count)
+    {
+        return (T*)Allocate(sizeof(T) * a_count);
+    }
+
+    // Everything allocated since the last reset is invalid after this
+    void Reset()
+    {
+        const uint64_t used = GetUsed();
+
+#ifdef DEBUG
+        if (used > m_peakUsed)
+        {
+            m_peakUsed = used;
+
+            Logger::Message(std::string(m_name) + " frame allocator peak: " + std::to_string(used) + " bytes");
+        }
+#endif
+
+        if (m_overflowSize > 0)
+        {
+            for (void* memory : m_overflow)
+            {
+                free(memory);
+            }
+
+            m_overflow.Clear();
+            m_overflowSize = 0;
+
+            // Leave some headroom so a slightly bigger frame does not overflow again
+            const uint64_t size = used + used / 2;
+
+            UnmapMemory(m_memory, GetSize());
+            m_memory = MapMemory(size);
+            m_end = (void*)((char*)m_memory + size);
+        }
+
+        m_slider = m_memory;
+    }
+};
+
+
+// MIT License
+// 
+// Copyright (c) 2024 River Govers
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
\ No newline at end of file
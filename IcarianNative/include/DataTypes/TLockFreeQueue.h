@@ -0,0 +1,147 @@
+// Icarian Engine - C# Game Engine
+// 
+// License at end of file.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "DataTypes/SpinLock.h"
+
+// Bounded queue that can be pushed to from any thread without locking
+// Each slot has a sequence number that tells producers and consumers whose turn it is so there is no shared lock to contend on
+// Credit for the algorithm: https://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue
+template<typename T, uint32_t Size>
+class TLockFreeQueue
+{
+private:
+    static_assert((Size & (Size - 1)) == 0, "TLockFreeQueue size must be a power of 2");
+
+    static constexpr uint32_t Mask = Size - 1;
+
+    struct Slot
+    {
+        std::atomic<uint32_t> Sequence;
+        T                     Data;
+    };
+
+    // Keep the producer and consumer counters on separate cache lines so they do not thrash each other
+    alignas(64) std::atomic<uint32_t> m_pushIndex;
+    alignas(64) std::atomic<uint32_t> m_popIndex;
+
+    alignas(64) Slot                  m_slots[Size];
+
+protected:
+
+public:
+    TLockFreeQueue()
+    {
+        for (uint32_t i = 0; i < Size; ++i)
+        {
+            m_slots[i].Sequence.store(i, std::memory_order_relaxed);
+        }
+
+        m_pushIndex.store(0, std::memory_order_relaxed);
+        m_popIndex.store(0, std::memory_order_relaxed);
+    }
+    ~TLockFreeQueue()
+    {
+
+    }
+
+    // Returns false if the queue is full
+    bool TryPush(const T& a_value)
+    {
+        uint32_t index = m_pushIndex.load(std::memory_order_relaxed);
+
+        while (true)
+        {
+            Slot& slot = m_slots[index & Mask];
+
+            const uint32_t sequence = slot.Sequence.load(std::memory_order_acquire);
+            const int32_t diff = (int32_t)(sequence - index);
+            if (diff == 0)
+            {
+                if (m_pushIndex.compare_exchange_weak(index, index + 1, std::memory_order_relaxed))
+                {
+                    slot.Data = a_value;
+                    slot.Sequence.store(index + 1, std::memory_order_release);
+
+                    return true;
+                }
+            }
+            else if (diff < 0)
+            {
+                return false;
+            }
+            else
+            {
+                index = m_pushIndex.load(std::memory_order_relaxed);
+            }
+        }
+    }
+    // Waits for the consumer to make room if the queue is full
+    void Push(const T& a_value)
+    {
+        while (!TryPush(a_value))
+        {
+            ISPINPAUSE;
+        }
+    }
+
+    // Returns false if the queue is empty
+    bool TryPop(T* a_value)
+    {
+        uint32_t index = m_popIndex.load(std::memory_order_relaxed);
+
+        while (true)
+        {
+            Slot& slot = m_slots[index & Mask];
+
+            const uint32_t sequence = slot.Sequence.load(std::memory_order_acquire);
+            const int32_t diff = (int32_t)(sequence - (index + 1));
+            if (diff == 0)
+            {
+                if (m_popIndex.compare_exchange_weak(index, index + 1, std::memory_order_relaxed))
+                {
+                    *a_value = slot.Data;
+                    slot.Sequence.store(index + Size, std::memory_order_release);
+
+                    return true;
+                }
+            }
+            else if (diff < 0)
+            {
+                return false;
+            }
+            else
+            {
+                index = m_popIndex.load(std::memory_order_relaxed);
+            }
+        }
+    }
+};
+
+
+// MIT License
+// 
+// Copyright (c) 2024 River Govers
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
\ No newline at end of file
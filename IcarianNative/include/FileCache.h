@@ -77,6 +77,34 @@ public:
     virtual bool EndOfFile() const;
 };
 
+// Read only view of a whole file mapped into memory
+// Pages are loaded by the OS on demand and shared with the page cache so large files do not need to be read up front
+class MappedFile
+{
+private:
+    void*    m_data;
+    uint64_t m_size;
+
+    MappedFile(void* a_data, uint64_t a_size);
+
+protected:
+
+public:
+    ~MappedFile();
+
+    // Returns null if the file could not be mapped
+    static MappedFile* Open(const std::filesystem::path& a_path);
+
+    inline const void* GetData() const
+    {
+        return m_data;
+    }
+    inline uint64_t GetSize() const
+    {
+        return m_size;
+    }
+};
+
 // RAM is incredibly slow but spinning rust is much slower then RAM,
 // therefore use RAM to reduce file access if at all possible
 class FileCache
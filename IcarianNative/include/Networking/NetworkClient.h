@@ -7,10 +7,20 @@
 #include <cstdint>
 #include <enet/enet.h>
 
+#include "DataTypes/Array.h"
+#include "DataTypes/SpinLock.h"
+#include "Networking/NetworkReplication.h"
+
 #include "EngineNetworkInteropStructures.h"
 
 class NetworkManager;
 
+struct ReplicationTarget
+{
+    uint32_t NetID;
+    uint32_t TransformAddr;
+};
+
 class NetworkClient
 {
 private:
@@ -22,8 +32,17 @@ private:
     ENetHost*       m_host;
     ENetPeer*       m_peer;
 
+    // Guards the targets and the latest snapshot in the history, the rest of the history is network thread only
+    SpinLock                 m_replicationLock;
+    Array<ReplicationTarget> m_replicationTargets;
+    ReplicationHistory       m_history;
+    // Game thread only
+    uint32_t                 m_appliedTick;
+
     NetworkClient();
 
+    void ReceiveSnapshot(const ENetPacket* a_packet);
+
 protected:
 
 public:
@@ -40,8 +59,27 @@ public:
     {
         return m_server;
     }
+    inline ENetPeer* GetPeer() const
+    {
+        return m_peer;
+    }
+
+    // ENet resets the peer after a disconnect event and may hand it to a new connection
+    inline void ClearPeer()
+    {
+        m_peer = NULL;
+    }
+
+    // Takes ownership of the packet
+    void Send(ENetPacket* a_packet, uint32_t a_channel);
+
+    // Writes the latest received snapshot into the replicated transforms, game thread only
+    void ApplySnapshot();
 
-    void Send(const uint8_t* a_data, uint32_t a_size, e_PacketFlags a_flags);
+    void Replicate(uint32_t a_netID, uint32_t a_transformAddr);
+    void StopReplicating(uint32_t a_netID);
+    // Copies the latest replicated data for the object and returns the size or -1 if it has not been received
+    uint32_t GetReplicatedData(uint32_t a_netID, uint8_t* a_data);
 
     void Update();
 };
@@ -4,30 +4,126 @@
 
 #pragma once
 
+#include <atomic>
+#include <cstdint>
 #include <enet/enet.h>
+#include <mono/metadata/object.h>
+#include <thread>
 
+#include "DataTypes/Array.h"
+#include "DataTypes/TLockFreeQueue.h"
 #include "DataTypes/TNCArray.h"
 
 class NetworkClient;
 class NetworkServer;
 class RuntimeFunction;
+template<typename... T>
+class RuntimeThunk;
 
-struct NetworkPeer;
+struct ReplicationSnapshot;
 
 #include "EngineNetworkInteropStructures.h"
 
+// Managed packets pick from the first channels so unreliable state does not wait on reliable events
+// The last channel is reserved for replication snapshots and acks
+static constexpr uint32_t NetworkUserChannelCount = 3;
+static constexpr uint32_t ReplicationChannel = NetworkUserChannelCount;
+static constexpr uint32_t NetworkChannelCount = NetworkUserChannelCount + 1;
+
+enum e_NetworkEventType : uint32_t
+{
+    NetworkEventType_Null,
+    NetworkEventType_Connect,
+    NetworkEventType_Receive,
+    NetworkEventType_Disconnect
+};
+
+// Sent from the network thread to the game thread
+// Addr is the server for connects and the client otherwise
+struct NetworkEvent
+{
+    e_NetworkEventType Type;
+    uint32_t Addr;
+    uint32_t ClientAddr;
+    uint32_t ServerAddr;
+    uint32_t Error;
+    ENetPacket* Packet;
+    uint64_t Timestamp;
+};
+
+enum e_NetworkCommandType : uint32_t
+{
+    NetworkCommandType_Null,
+    NetworkCommandType_ClientSend,
+    NetworkCommandType_ServerSend,
+    NetworkCommandType_ServerMulticast,
+    NetworkCommandType_DestroyClient,
+    NetworkCommandType_DestroyServer,
+    NetworkCommandType_ServerSnapshot
+};
+
+// Sent from any thread to the network thread
+// Clients is allocated by the sender and freed by the network thread
+struct NetworkCommand
+{
+    e_NetworkCommandType Type;
+    uint32_t Addr;
+    uint32_t Channel;
+    uint32_t ClientCount;
+    uint32_t* Clients;
+    ENetPacket* Packet;
+    ReplicationSnapshot* Snapshot;
+    uint64_t Timestamp;
+};
+
 class NetworkManager
 {
 private:
-    bool                     m_initialized;
+    static constexpr uint32_t NetworkEventQueueSize = 8192;
+    static constexpr uint32_t NetworkCommandQueueSize = 8192;
+    static constexpr uint32_t NetworkThreadIntervalMs = 1;
+
+    bool                                                         m_initialized;
+
+    std::thread                                                  m_thread;
+    std::atomic<bool>                                            m_shutdown;
+
+    TLockFreeQueue<NetworkEvent, NetworkEventQueueSize>          m_events;
+    TLockFreeQueue<NetworkCommand, NetworkCommandQueueSize>      m_commands;
+    // Network thread only, holds events while the game thread is behind so servicing never stalls
+    Array<NetworkEvent>                                          m_eventBacklog;
+
+    // Moving average in microseconds of time spent waiting in the queues
+    float                                                        m_inboundLatency;
+    std::atomic<uint32_t>                                        m_outboundLatency;
+
+    TNCArray<NetworkClient*>                                     m_clients;
+    TNCArray<NetworkServer*>                                     m_servers;
 
-    TNCArray<NetworkClient*> m_clients;
-    TNCArray<NetworkServer*> m_servers;
+    // Packets received during an update are copied straight into pinned managed arrays and handed over in one call
+    // Packet table is address, offset and size for each packet
+    MonoArray*                                                   m_receiveData;
+    uint32_t                                                     m_receiveDataHandle;
+    uint32_t                                                     m_receiveDataSize;
+    MonoArray*                                                   m_receivePackets;
+    uint32_t                                                     m_receivePacketsHandle;
+    uint32_t                                                     m_receivePacketCount;
 
-    RuntimeFunction*         m_networkClientReceiveFunction;
-    RuntimeFunction*         m_networkClientDisconnectFunction;
+    RuntimeThunk<MonoArray*, MonoArray*, uint32_t>*             m_networkClientReceiveFunction;
+    RuntimeFunction*                                             m_networkClientDisconnectFunction;
 
-    RuntimeFunction*         m_networkServerConnectFunction;
+    RuntimeFunction*                                             m_networkServerConnectFunction;
+
+    void Run();
+    void ProcessCommand(const NetworkCommand& a_command);
+    void FlushEventBacklog();
+    NetworkServer* GetNetworkServer(uint32_t a_addr);
+
+    void FlushReceive();
+
+    void NetworkClientReceive(uint32_t a_addr, const uint8_t* a_data, uint32_t a_size);
+    void NetworkClientDisconnect(uint32_t a_addr, bool a_error);
+    void NetworkServerConnect(uint32_t a_addr, uint32_t a_clientAddr);
 
 protected:
 
@@ -35,28 +131,53 @@ public:
     NetworkManager();
     ~NetworkManager();
 
+    static uint64_t GetTimestamp();
+
     inline bool IsInitialized() const
     {
         return m_initialized;
     }
 
+    inline uint32_t GetInboundLatency() const
+    {
+        return (uint32_t)m_inboundLatency;
+    }
+    inline uint32_t GetOutboundLatency() const
+    {
+        return m_outboundLatency.load(std::memory_order_relaxed);
+    }
+
     uint32_t CreateNetworkClient(const NetworkAddress& a_address);
-    uint32_t CreateNetworkClientConnection(uint32_t a_hostAddr, const ENetEvent& a_event);
     void DestroyNetworkClient(uint32_t a_addr);
     uint32_t NetworkClientGetServerAddress(uint32_t a_addr);
 
-    void NetworkClientSend(uint32_t a_addr, const uint8_t* a_data, uint32_t a_size, e_PacketFlags a_flags);
-    void NetworkClientReceive(uint32_t a_addr, const uint8_t* a_data, uint32_t a_size);
-    void NetworkClientDisconnect(uint32_t a_addr, bool a_error = false);
+    void NetworkClientSend(uint32_t a_addr, const uint8_t* a_data, uint32_t a_size, e_PacketFlags a_flags, uint32_t a_channel);
+
+    void NetworkClientReplicate(uint32_t a_addr, uint32_t a_netID, uint32_t a_transformAddr);
+    void NetworkClientStopReplicating(uint32_t a_addr, uint32_t a_netID);
+    uint32_t NetworkClientGetReplicatedData(uint32_t a_addr, uint32_t a_netID, uint8_t* a_data);
 
     uint32_t CreateNetworkServer(uint16_t a_port, uint32_t a_maxClients);
     void DestroyNetworkServer(uint32_t a_addr);
 
-    void NetworkServerSend(uint32_t a_addr, const uint8_t* a_data, uint32_t a_size, e_PacketFlags a_flags);
-    void NetworkServerConnect(uint32_t a_addr, uint32_t a_clientAddr);
+    void NetworkServerSend(uint32_t a_addr, const uint8_t* a_data, uint32_t a_size, e_PacketFlags a_flags, uint32_t a_channel);
+    // Sends one packet shared between the listed clients of the server
+    void NetworkServerSendTo(uint32_t a_addr, const uint32_t* a_clients, uint32_t a_clientCount, const uint8_t* a_data, uint32_t a_size, e_PacketFlags a_flags, uint32_t a_channel);
     uint32_t NetworkServerGetMaxClients(uint32_t a_addr);
-    NetworkPeer* NetworkServerGetClients(uint32_t a_addr);
+    Array<uint32_t> NetworkServerGetClients(uint32_t a_addr);
+
+    void NetworkServerReplicate(uint32_t a_addr, uint32_t a_netID, uint32_t a_transformAddr);
+    void NetworkServerStopReplicating(uint32_t a_addr, uint32_t a_netID);
+    void NetworkServerSetReplicatedData(uint32_t a_addr, uint32_t a_netID, const uint8_t* a_data, uint32_t a_size);
+    void NetworkServerSetSnapshotRate(uint32_t a_addr, uint32_t a_rate);
+
+    // Network thread only
+    void PushEvent(const NetworkEvent& a_event);
+    uint32_t CreateNetworkClientConnection(uint32_t a_hostAddr, const ENetEvent& a_event);
+    NetworkClient* GetNetworkClient(uint32_t a_addr);
+    void EraseNetworkClient(uint32_t a_addr);
 
+    // Dispatches events from the network thread to managed code and captures replication snapshots
     void Update();
 };
 
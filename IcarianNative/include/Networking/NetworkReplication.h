@@ -0,0 +1,103 @@
+// Icarian Engine - C# Game Engine
+// 
+// License at end of file.
+
+#pragma once
+
+#include <cstdint>
+
+#include "DataTypes/Array.h"
+
+struct TransformBuffer;
+
+static constexpr uint32_t ReplicationHistorySize = 32;
+static constexpr uint32_t ReplicationMaxDataSize = 32;
+
+// Fixed point fraction bits, translation is ~2mm and scale ~0.4%
+static constexpr uint32_t ReplicationTranslationBits = 9;
+static constexpr uint32_t ReplicationScaleBits = 8;
+
+enum e_ReplicationField : uint8_t
+{
+    ReplicationField_Translation = 0b1 << 0,
+    ReplicationField_Rotation = 0b1 << 1,
+    ReplicationField_Scale = 0b1 << 2,
+    ReplicationField_Data = 0b1 << 3,
+    ReplicationField_Removed = 0b1 << 4
+};
+
+struct ReplicationState
+{
+    uint32_t NetID;
+    int32_t Translation[3];
+    // Smallest three, 2 bits for the dropped component and 10 bits for each of the rest
+    uint32_t Rotation;
+    int32_t Scale[3];
+    uint32_t DataSize;
+    uint8_t Data[ReplicationMaxDataSize];
+};
+
+struct ReplicationSnapshot
+{
+    uint32_t Tick;
+    // Sorted by NetID
+    Array<ReplicationState> States;
+};
+
+class ReplicationHistory
+{
+private:
+    ReplicationSnapshot* m_snapshots[ReplicationHistorySize];
+    uint32_t             m_latestTick;
+
+protected:
+
+public:
+    ReplicationHistory();
+    ~ReplicationHistory();
+
+    inline uint32_t GetLatestTick() const
+    {
+        return m_latestTick;
+    }
+
+    const ReplicationSnapshot* GetSnapshot(uint32_t a_tick) const;
+    inline const ReplicationSnapshot* GetLatest() const
+    {
+        return GetSnapshot(m_latestTick);
+    }
+
+    // Takes ownership of the snapshot and frees the one it replaces
+    void Push(ReplicationSnapshot* a_snapshot);
+};
+
+void ReplicationQuantize(uint32_t a_netID, const TransformBuffer& a_transform, const uint8_t* a_data, uint32_t a_dataSize, ReplicationState* a_state);
+void ReplicationDequantize(const ReplicationState& a_state, TransformBuffer* a_transform);
+
+// Writes only what changed since the base, a null base writes the full snapshot
+void ReplicationEncodeDelta(const ReplicationSnapshot* a_base, const ReplicationSnapshot& a_snapshot, Array<uint8_t>* a_out);
+// Returns null if the packet is malformed or the base is no longer in the history
+ReplicationSnapshot* ReplicationDecodeDelta(const ReplicationHistory& a_history, const uint8_t* a_data, uint32_t a_size);
+
+
+// MIT License
+// 
+// Copyright (c) 2024 River Govers
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
\ No newline at end of file
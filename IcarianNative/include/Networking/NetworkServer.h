@@ -4,9 +4,14 @@
 
 #pragma once
 
+#include <atomic>
 #include <cstdint>
 #include <enet/enet.h>
 
+#include "DataTypes/Array.h"
+#include "DataTypes/SpinLock.h"
+#include "Networking/NetworkReplication.h"
+
 #include "EngineNetworkInteropStructures.h"
 
 class NetworkManager;
@@ -15,6 +20,16 @@ struct NetworkPeer
 {
     uint32_t Addr;
     ENetPeer* Peer;
+    // Latest snapshot the peer has, deltas are made against it
+    uint32_t AckTick;
+};
+
+struct ReplicatedObject
+{
+    uint32_t NetID;
+    uint32_t TransformAddr;
+    uint32_t DataSize;
+    uint8_t Data[ReplicationMaxDataSize];
 };
 
 class NetworkServer
@@ -24,12 +39,33 @@ private:
     uint32_t        m_addr;
 
     uint32_t        m_maxClients;
+    // Peers are changed on the network thread, the lock covers the addresses read by the game thread
+    SpinLock        m_peerLock;
     NetworkPeer*    m_peers;
+    Array<uint32_t> m_freeSlots;
 
     ENetHost*       m_host;
 
+    // Network thread only
+    ReplicationHistory       m_history;
+    Array<uint8_t>           m_replicationBuffer;
+
+    // Written by the game thread, read by the network thread to validate acks
+    std::atomic<uint32_t>    m_tick;
+
+    // Game thread only, sorted by NetID
+    Array<ReplicatedObject>  m_replicated;
+    uint64_t                 m_snapshotInterval;
+    uint64_t                 m_nextSnapshot;
+
     NetworkServer(uint32_t a_maxClients);
 
+    uint32_t GetPeerSlot(const ENetPeer* a_peer) const;
+    void FreePeerSlot(uint32_t a_slot);
+    void DisconnectPeer(uint32_t a_slot, bool a_error);
+
+    uint32_t GetReplicatedIndex(uint32_t a_netID) const;
+
 protected:
 
 public:
@@ -41,17 +77,30 @@ public:
     {
         return m_maxClients;
     }
-    inline NetworkPeer* GetPeers() const
-    {
-        return m_peers;
-    }
+    // Addresses of connected clients in slot order, unused slots are -1
+    Array<uint32_t> GetClientAddresses();
 
     inline void SetBufferAddress(uint32_t a_addr)
     {
         m_addr = a_addr;
     }
 
-    void Send(const uint8_t* a_data, uint32_t a_size, e_PacketFlags a_flags);
+    // Takes ownership of the packets
+    void Send(ENetPacket* a_packet, uint32_t a_channel);
+    void SendTo(ENetPacket* a_packet, uint32_t a_channel, const uint32_t* a_clients, uint32_t a_clientCount);
+
+    // Frees the slot of a client that is being destroyed
+    void ReleaseClient(ENetPeer* a_peer);
+
+    void Replicate(uint32_t a_netID, uint32_t a_transformAddr);
+    void StopReplicating(uint32_t a_netID);
+    void SetReplicatedData(uint32_t a_netID, const uint8_t* a_data, uint32_t a_size);
+    void SetSnapshotRate(uint32_t a_rate);
+
+    // Returns null if a snapshot is not due yet
+    ReplicationSnapshot* CaptureSnapshot(uint64_t a_timestamp);
+    // Takes ownership of the snapshot and sends each peer the delta from what it last acknowledged
+    void SendSnapshot(ReplicationSnapshot* a_snapshot);
 
     void Update();
 };
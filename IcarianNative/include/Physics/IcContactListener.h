@@ -12,18 +12,19 @@
 #include <Jolt/Physics/Collision/ContactListener.h>
 
 class PhysicsEngine;
-class RuntimeFunction;
+template<typename... T>
+class RuntimeThunk;
 
 #include "EnginePhysicsBodyInteropStructures.h"
 
 class IcContactListener : public JPH::ContactListener
 {
 private:
-    PhysicsEngine*   m_engine;
+    PhysicsEngine*                           m_engine;
     
-    RuntimeFunction* m_onCollisionEnterFunc;
-    RuntimeFunction* m_onCollisionStayFunc;
-    RuntimeFunction* m_onCollisionExitFunc;
+    RuntimeThunk<CollisionDataBuffer*>*      m_onCollisionEnterFunc;
+    RuntimeThunk<CollisionDataBuffer*>*      m_onCollisionStayFunc;
+    RuntimeThunk<CollisionDataBuffer*>*      m_onCollisionExitFunc;
 
 protected:
 
@@ -27,9 +27,14 @@
 #include "Physics/IcObjectLayerPairFilter.h"
 #include "Physics/IcPhysicsJobSystem.h"
 
+#include "EnginePhysicsInteropStructures.h"
+
 class Config;
 class PhysicsEngineBindings;
-class RuntimeFunction;
+template<typename... T>
+class RuntimeThunk;
+
+struct CharacterUpdateContext;
 
 struct BodyBinding
 {
@@ -53,6 +58,10 @@ private:
     static constexpr uint32_t MaxBodies = 65535;
     static constexpr uint32_t MaxContactConstraints = 1024 * 10;
     static constexpr uint32_t AllocatorSize = 1024 * 1024 * 10;
+    // Characters only need scratch for their own contact queries so can get away with a lot less per thread
+    static constexpr uint32_t CharacterAllocatorSize = 1024 * 1024;
+    // Small batches thrash the job queue and big batches starve threads so grab a middle ground
+    static constexpr uint32_t CharacterBatchSize = 16;
 
     PhysicsEngineBindings*                    m_runtimeBindings;
 
@@ -63,7 +72,7 @@ private:
     double                                    m_fixedTimeStep;
     double                                    m_fixedTimeTimer;
 
-    RuntimeFunction*                          m_fixedUpdateFunction;
+    RuntimeThunk<double, double>*             m_fixedUpdateFunction;
 
     // FFS got foot gunned by RAII. Raw pointers it is then.
     IcPhysicsJobSystem*                       m_jobSystem;
@@ -76,6 +85,10 @@ private:
     IcCharacterListener*                      m_characterListener;
 
     JPH::TempAllocatorImpl*                   m_allocator;
+    JPH::TempAllocatorImpl**                  m_characterAllocators;
+    uint32_t                                  m_characterAllocatorCount;
+
+    e_CharacterInteractionMode                m_characterInteractionMode;
 
     JPH::PhysicsSystem*                       m_physicsSystem;
 
@@ -86,6 +99,9 @@ private:
     TNCArray<BodyBinding>                     m_bodyBindings;
     TNCArray<JPH::CharacterVirtual*>          m_characters;
 
+    void UpdateCharacters(double a_delta);
+    void SeparateCharacters(const CharacterUpdateContext& a_context, uint32_t a_count);
+
 protected:
 
 public:
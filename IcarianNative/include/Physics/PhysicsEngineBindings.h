@@ -51,6 +51,7 @@ public:
     void DestroyCharacterController(uint32_t a_addr) const;
     glm::vec3 GetCharacterControllerVelocity(uint32_t a_addr) const;
     void SetCharacterControllerVelocity(uint32_t a_addr, const glm::vec3& a_velocity) const;
+    void SetCharacterControllerListener(uint32_t a_addr, bool a_state) const;
 
     uint32_t CreatePhysicsBody(uint32_t a_transformAddr, uint32_t a_colliderAddr) const;
     void DestroyPhysicsBody(uint32_t a_addr) const;
@@ -76,6 +77,9 @@ public:
     void SetGravity(const glm::vec3& a_gravity) const;
     glm::vec3 GetGravity() const;
 
+    e_CharacterInteractionMode GetCharacterInteractionMode() const;
+    void SetCharacterInteractionMode(e_CharacterInteractionMode a_mode) const;
+
     bool GetObjectLayerCollision(uint32_t a_lhs, uint32_t a_rhs) const;
     void SetObjectLayerCollision(uint32_t a_lhs, uint32_t a_rhs, bool a_state) const;
 
@@ -8,11 +8,13 @@
 #include <glm/glm.hpp>
 
 #include <cstdint>
+#include <mono/metadata/object.h>
 
 #include "DataTypes/TNCArray.h"
 
 class AnimationControllerBindings;
-class RuntimeFunction;
+template<typename... T>
+class RuntimeThunk;
 
 enum e_AnimationUpdateMode : uint16_t
 {
@@ -47,8 +49,8 @@ private:
     TNCArray<e_AnimationUpdateMode> m_animators;
     TNCArray<SkeletonData>          m_skeletons;  
 
-    RuntimeFunction*                m_updateAnimatorFunc;
-    RuntimeFunction*                m_updateAnimatorsFunc;
+    RuntimeThunk<uint32_t, double>*   m_updateAnimatorFunc;
+    RuntimeThunk<MonoArray*, double>* m_updateAnimatorsFunc;
 
     AnimationController();
 
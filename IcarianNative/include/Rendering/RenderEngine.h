@@ -23,7 +23,8 @@ class Font;
 class ObjectManager;
 class RenderAssetStore;
 class RenderEngineBackend;
-class RuntimeFunction;
+template<typename... T>
+class RuntimeThunk;
 class RuntimeManager;
 
 class RenderEngine
@@ -42,7 +43,7 @@ private:
 
     AppWindow*           m_window;
 
-    RuntimeFunction*     m_frameUpdateFunction;
+    RuntimeThunk<double, double>* m_frameUpdateFunction;
 
     // If not volatile GCC may optimize away the stop function
     // Program will not terminate if stop is optimized away
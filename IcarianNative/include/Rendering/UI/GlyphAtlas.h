@@ -0,0 +1,115 @@
+// Icarian Engine - C# Game Engine
+// 
+// License at end of file.
+
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <stb_truetype.h>
+#include <unordered_map>
+
+class RenderEngine;
+
+// Metrics are in pixels at the atlas base size and get scaled by the user to the wanted font size
+struct GlyphInfo
+{
+    // Atlas rect in texels so growing the atlas does not invalidate built text
+    glm::vec2 TexMin;
+    glm::vec2 TexMax;
+    // Distance field box relative to the pen position on the baseline
+    glm::vec2 Offset;
+    glm::vec2 Size;
+    float     Advance;
+};
+
+// Per font cache of signed distance field glyphs packed into a single texture shared by every font size
+// Glyphs are rasterized once on first use and the texture is only reuploaded when new glyphs are added
+// Render thread only
+class GlyphAtlas
+{
+private:
+    static constexpr uint32_t AtlasWidth = 1024;
+    static constexpr uint32_t InitialAtlasHeight = 512;
+    static constexpr uint32_t MaxAtlasHeight = 4096;
+    static constexpr uint32_t GlyphPadding = 1;
+
+    // Glyphs are stored as signed distance fields so a single atlas serves every font size
+    static constexpr float    BaseFontSize = 48.0f;
+    // Pixels around the glyph the distance field covers
+    static constexpr int      SDFSpread = 6;
+    static constexpr uint8_t  SDFOnEdgeValue = 128;
+    static constexpr float    SDFPixelDistScale = (float)SDFOnEdgeValue / SDFSpread;
+
+    const stbtt_fontinfo*                    m_fontInfo;
+    RenderEngine*                            m_renderEngine;
+
+    std::unordered_map<char32_t, GlyphInfo> m_glyphs;
+
+    uint8_t*                                 m_data;
+    uint32_t                                 m_height;
+
+    uint32_t                                 m_shelfX;
+    uint32_t                                 m_shelfY;
+    uint32_t                                 m_shelfHeight;
+
+    float                                    m_scale;
+    float                                    m_lineHeight;
+
+    uint32_t                                 m_textureAddr;
+    uint32_t                                 m_samplerAddr;
+
+    bool                                     m_dirty;
+
+    bool Pack(uint32_t a_width, uint32_t a_height, uint32_t* a_x, uint32_t* a_y);
+    const GlyphInfo* Rasterize(char32_t a_codepoint);
+
+protected:
+
+public:
+    GlyphAtlas(const stbtt_fontinfo* a_fontInfo);
+    ~GlyphAtlas();
+
+    inline float GetBaseFontSize() const
+    {
+        return BaseFontSize;
+    }
+    inline float GetLineHeight() const
+    {
+        return m_lineHeight;
+    }
+
+    inline uint32_t GetSamplerAddr() const
+    {
+        return m_samplerAddr;
+    }
+
+    const GlyphInfo* GetGlyph(char32_t a_codepoint);
+
+    // Uploads the atlas if glyphs have been added since the last flush
+    void Flush(RenderEngine* a_renderEngine);
+};
+
+
+// MIT License
+// 
+// Copyright (c) 2024 River Govers
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
\ No newline at end of file
@@ -29,6 +29,8 @@ public:
     inline void SetSamplerAddr(uint32_t a_addr)
     {
         m_samplerAddr = a_addr;
+
+        MarkDirty();
     }
 
     virtual void Update(RenderEngine* a_renderEngine);
@@ -8,25 +8,41 @@
 
 #include <string>
 
+#include "Core/Bitfield.h"
+#include "DataTypes/Array.h"
+
+class GlyphAtlas;
+
+struct UITextQuad
+{
+    // Normalized to the element rect
+    glm::vec2 Min;
+    glm::vec2 Max;
+    // Atlas texels
+    glm::vec2 TexMin;
+    glm::vec2 TexMax;
+};
+
 class TextUIElement : public UIElement
 {
 private:
     static constexpr uint32_t RefreshBit = 0;
     static constexpr uint32_t ValidBit = 1;
 
-    RenderEngine*  m_lastRenderEngine;
+    SharedSpinLock      m_lock;
 
-    SharedSpinLock m_lock;
-
-    std::u32string m_text;
+    std::u32string      m_text;
     
-    uint32_t       m_textureAddr;
-    uint32_t       m_samplerAddr;
+    GlyphAtlas*         m_atlas;
+    Array<UITextQuad>   m_quads;
+    glm::vec2           m_builtSize;
+
+    float               m_fontSize;
+    uint32_t            m_fontAddr;
 
-    float          m_fontSize;
-    uint32_t       m_fontAddr;
+    uint8_t             m_flags;
 
-    uint8_t        m_flags;
+    void Rebuild(RenderEngine* a_renderEngine);
 
 protected:
 
@@ -39,9 +55,12 @@ public:
         return UIElementType_Text;
     }
 
-    inline uint32_t GetSamplerAddr() const
+    uint32_t GetSamplerAddr() const;
+
+    // Render thread only valid after Update
+    inline const Array<UITextQuad>& GetQuads() const
     {
-        return m_samplerAddr;
+        return m_quads;
     }
 
     inline uint32_t GetFontAddr() const
@@ -57,6 +76,8 @@ public:
     inline void SetFontSize(float a_size)
     {
         m_fontSize = a_size;
+
+        ISETBIT(m_flags, RefreshBit);
     }
 
     inline bool IsValid() const
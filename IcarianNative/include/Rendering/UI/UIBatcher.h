@@ -0,0 +1,129 @@
+// Icarian Engine - C# Game Engine
+// 
+// License at end of file.
+
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+
+#include "DataTypes/Array.h"
+
+class RenderEngine;
+
+#include "EngineCanvasInteropStructures.h"
+
+enum e_UIBatchType : uint16_t
+{
+    UIBatchType_Text,
+    UIBatchType_Image
+};
+
+struct UIBatchVertex
+{
+    // Normalized to the render target
+    glm::vec2 Position;
+    // Atlas texels for text and normalized for images
+    glm::vec2 TexCoord;
+    glm::vec4 Color;
+};
+
+struct UIBatch
+{
+    e_UIBatchType Type;
+    uint32_t      SamplerAddr;
+    uint32_t      FirstVertex;
+    uint32_t      VertexCount;
+};
+
+// Flattens a canvas into as few draws as possible and keeps them until something in the canvas changes
+// Does not touch the GPU so backends only have to upload the vertices and record a draw per batch
+class UIBatcher
+{
+private:
+    // How many batches back triangles can be moved to share a batch with the same state
+    static constexpr uint32_t MaxBatchLookback = 8;
+
+    struct PendingBatch
+    {
+        e_UIBatchType Type;
+        uint32_t      SamplerAddr;
+        glm::vec2     Min;
+        glm::vec2     Max;
+    };
+
+    struct PendingRange
+    {
+        uint32_t Batch;
+        uint32_t FirstVertex;
+        uint32_t VertexCount;
+    };
+
+    uint64_t             m_hash;
+    glm::vec2            m_screenSize;
+
+    Array<PendingBatch>  m_pendingBatches;
+    Array<PendingRange>  m_pendingRanges;
+    Array<UIBatchVertex> m_pendingVertices;
+
+    Array<UIBatchVertex> m_elementVertices;
+
+    Array<UIBatchVertex> m_vertices;
+    Array<UIBatch>       m_batches;
+
+    void UpdateElement(uint32_t a_addr, RenderEngine* a_renderEngine, uint64_t* a_hash);
+    void AddElement(const CanvasBuffer& a_canvas, uint32_t a_addr, const glm::vec2& a_screenSize);
+
+    uint32_t GetBatch(e_UIBatchType a_type, uint32_t a_samplerAddr, const glm::vec2& a_min, const glm::vec2& a_max);
+
+protected:
+
+public:
+    UIBatcher();
+    ~UIBatcher();
+
+    inline const Array<UIBatchVertex>& GetVertices() const
+    {
+        return m_vertices;
+    }
+    inline const Array<UIBatch>& GetBatches() const
+    {
+        return m_batches;
+    }
+
+    // Updates the elements of the canvas and rebuilds the batches only if something changed
+    // Returns true if the batches were rebuilt
+    bool Update(const CanvasBuffer& a_canvas, const glm::vec2& a_screenSize, RenderEngine* a_renderEngine);
+
+    // Expects the elements to have already been updated
+    void Build(const CanvasBuffer& a_canvas, const glm::vec2& a_screenSize);
+
+    void Begin();
+    // Triangle list normalized to the render target
+    // Merged into an earlier batch with the same state as long as nothing drawn in between overlaps it
+    void AddTriangles(e_UIBatchType a_type, uint32_t a_samplerAddr, const UIBatchVertex* a_vertices, uint32_t a_count);
+    void End();
+};
+
+// MIT License
+// 
+// Copyright (c) 2024 River Govers
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE
\ No newline at end of file
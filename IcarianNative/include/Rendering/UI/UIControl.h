@@ -4,15 +4,23 @@
 
 #pragma once
 
+#include <atomic>
 #include <cstdint>
 
+#include "DataTypes/Array.h"
 #include "DataTypes/TNCArray.h"
 
-class RuntimeFunction;
+#include <mono/metadata/object.h>
+
+template<typename... T>
+class RuntimeThunk;
+
 class UIControlBindings;
 class UIElement;
+class UIHitGrid;
 
 #include "EngineCanvasInteropStructures.h"
+#include "EngineUIElementInteropStuctures.h"
 
 class UIControl
 {
@@ -21,21 +29,28 @@ private:
 
     static UIControl* Instance;
 
-    UIControlBindings*     m_bindings;
+    UIControlBindings*                      m_bindings;
+
+    RuntimeThunk<MonoArray*, uint32_t>*     m_onStateChanged;
+
+    TNCArray<CanvasBuffer>                  m_canvas;
+    TNCArray<UIElement*>                    m_uiElements;
+
+    // Bumped on anything that can move an element so hit grids know to rebuild
+    std::atomic<uint32_t>                   m_layoutGeneration;
 
-    RuntimeFunction*       m_onNormal;
-    RuntimeFunction*       m_onHover;
-    RuntimeFunction*       m_onPressed;
-    RuntimeFunction*       m_onReleased;
+    // Only touched by input on the main thread
+    Array<UIHitGrid*>                       m_hitGrids;
+    Array<uint32_t>                         m_hits;
 
-    TNCArray<CanvasBuffer> m_canvas;
-    TNCArray<UIElement*>   m_uiElements;
+    // Canvas, element and state triples sent to managed in one call
+    Array<uint32_t>                         m_stateEvents;
 
     UIControl();
-    
-    void SendCursor(uint32_t a_canvasAddr, uint32_t a_elementAddr, const glm::vec2& a_pos, const glm::vec2& a_screenSize);
-    bool SendClick(uint32_t a_canvasAddr, uint32_t a_elementAddr, const glm::vec2& a_pos, const glm::vec2& a_screenSize);
-    void SendRelease(uint32_t a_canvasAddr, uint32_t a_elementAddr, const glm::vec2& a_pos, const glm::vec2& a_screenSize);
+
+    UIHitGrid* GetHitGrid(uint32_t a_canvasAddr, const CanvasBuffer& a_canvas, const glm::vec2& a_screenSize);
+
+    void SetElementState(uint32_t a_canvasAddr, uint32_t a_elementAddr, UIElement* a_element, e_ElementState a_state);
 
 protected:
 
@@ -50,9 +65,14 @@ public:
 
     static UIElement* GetUIElement(uint32_t a_addr);
 
+    static void MarkLayoutDirty();
+
     static void UpdateCursor(const glm::vec2& a_pos, const glm::vec2& a_size);
     static bool SubmitClick(const glm::vec2& a_pos, const glm::vec2& a_size);
     static void SubmitRelease(const glm::vec2& a_pos, const glm::vec2& a_size);
+
+    // Sends the state changes from input this frame to managed
+    static void FlushEvents();
 };
 
 // MIT License
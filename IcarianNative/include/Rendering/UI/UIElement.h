@@ -37,6 +37,8 @@ private:
 
     e_ElementState m_state;
 
+    uint32_t       m_version;
+
     float GetXPosition(const CanvasBuffer& a_canvas, const glm::vec2& a_screenSize) const;
     float GetYPosition(const CanvasBuffer& a_canvas, const glm::vec2& a_screenSize) const;
 
@@ -44,6 +46,11 @@ private:
     float GetYSize(const CanvasBuffer& a_canvas, const glm::vec2& a_screenSize) const;
 
 protected:
+    // Anything that changes how the element is drawn bumps the version so renderers can keep their batches otherwise
+    inline void MarkDirty()
+    {
+        ++m_version;
+    }
 
 public:
     UIElement();
@@ -65,6 +72,8 @@ public:
     inline void SetXAnchor(e_UIXAnchor a_anchor)
     {
         m_xAnchor = a_anchor;
+
+        MarkDirty();
     }
     inline e_UIYAnchor GetYAnchor() const
     {
@@ -73,6 +82,8 @@ public:
     inline void SetYAnchor(e_UIYAnchor a_anchor) 
     {
         m_yAnchor = a_anchor;
+
+        MarkDirty();
     }
 
     inline glm::vec2 GetPosition() const
@@ -82,6 +93,8 @@ public:
     inline void SetPosition(const glm::vec2& a_pos)
     {
         m_pos = a_pos;
+
+        MarkDirty();
     }
     
     inline glm::vec2 GetSize() const
@@ -91,6 +104,8 @@ public:
     inline void SetSize(const glm::vec2& a_size)
     {
         m_size = a_size;
+
+        MarkDirty();
     }
 
     inline glm::vec4 GetColor() const
@@ -100,6 +115,13 @@ public:
     inline void SetColor(const glm::vec4& a_color)
     {
         m_color = a_color;
+
+        MarkDirty();
+    }
+
+    inline uint32_t GetVersion() const
+    {
+        return m_version;
     }
 
     inline uint32_t GetParent() const
@@ -110,6 +132,8 @@ public:
     inline void SetParent(uint32_t a_parent)
     {
         m_parent = a_parent;
+
+        MarkDirty();
     }
 
     void AddChild(uint32_t a_childAddr);
@@ -0,0 +1,105 @@
+// Icarian Engine - C# Game Engine
+// 
+// License at end of file.
+
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+
+#include "DataTypes/Array.h"
+
+#include "EngineCanvasInteropStructures.h"
+
+struct UIHitEntry
+{
+    // Screen space rect
+    glm::vec2 Min;
+    glm::vec2 Max;
+    uint32_t  ElementAddr;
+
+    inline bool Contains(const glm::vec2& a_pos) const
+    {
+        return a_pos.x >= Min.x && a_pos.x <= Max.x &&
+            a_pos.y >= Min.y && a_pos.y <= Max.y;
+    }
+};
+
+// Uniform grid over the resolved element rects of a canvas so input only has to look at elements under the cursor
+// Only rebuilt when the layout or screen size changes
+class UIHitGrid
+{
+private:
+    static constexpr uint32_t CellCount = 16;
+    static constexpr uint32_t TotalCellCount = CellCount * CellCount;
+
+    uint32_t          m_generation;
+    glm::vec2         m_screenSize;
+
+    // In the same depth first order input was dispatched in so the index doubles as the dispatch order
+    Array<UIHitEntry> m_entries;
+
+    // Entry indices bucketed by cell with m_cellStart holding the offset of each cell
+    Array<uint32_t>   m_cellStart;
+    Array<uint32_t>   m_cellEntries;
+
+    // Entries not in the normal state that need to be checked when the cursor is not over them
+    Array<uint32_t>   m_active;
+
+    void AddElement(const CanvasBuffer& a_canvas, uint32_t a_addr);
+
+    glm::uvec2 GetCell(const glm::vec2& a_pos) const;
+
+protected:
+
+public:
+    UIHitGrid();
+    ~UIHitGrid();
+
+    inline bool IsValid(uint32_t a_generation, const glm::vec2& a_screenSize) const
+    {
+        return m_generation == a_generation && m_screenSize == a_screenSize;
+    }
+
+    inline const UIHitEntry& GetEntry(uint32_t a_index) const
+    {
+        return m_entries[a_index];
+    }
+
+    inline const Array<uint32_t>& GetActive() const
+    {
+        return m_active;
+    }
+
+    void Build(const CanvasBuffer& a_canvas, uint32_t a_generation, const glm::vec2& a_screenSize);
+
+    // Appends the entries containing the position in dispatch order
+    void Query(const glm::vec2& a_pos, Array<uint32_t>* a_entries) const;
+
+    void MarkActive(uint32_t a_index);
+    // Drops entries that have returned to the normal state
+    void PruneActive();
+};
+
+// MIT License
+// 
+// Copyright (c) 2024 River Govers
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE
\ No newline at end of file
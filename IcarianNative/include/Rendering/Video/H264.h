@@ -6,6 +6,7 @@
 
 #include "DataTypes/Array.h"
 #include <cstdint>
+#include <cstring>
 
 // I could not make head or tails until completely refactoring 
 // Even then still goes over my head
@@ -15,73 +16,169 @@ namespace H264
 	static constexpr uint8_t NALStartCode[] = { 0, 0, 1 };
 	static constexpr uint32_t NALStartCodeSize = sizeof(NALStartCode);
 
+    // Reads are served from a 64 bit cache that is refilled a word at a time so fields do not branch per bit
+    // Emulation prevention bytes are dropped on refill so everything reading from it sees the raw RBSP
     struct BitStream
     {
         const uint8_t* Start;
         const uint8_t* End;
+        // Next byte to be loaded into the cache
         const uint8_t* P;
-    	int32_t BitsLeft;
+        // Bits are taken from the top and anything below the valid bits is always 0
+        uint64_t Cache;
+        int32_t CacheBits;
+        uint32_t ZeroRun;
 
         constexpr BitStream(const uint8_t* a_start, uint64_t a_size) :
             Start(a_start),
             End(a_start + a_size),
             P(a_start),
-            BitsLeft(8)
+            Cache(0),
+            CacheBits(0),
+            ZeroRun(0)
         {
 
         }
 
-        constexpr bool IsEOF() const
+        inline void Refill()
         {
-            return P >= End;
+            // Words without a zero byte cannot hold an emulation prevention sequence so can go straight in
+            // Assumes a little endian host which is all we run on
+            if (End - P >= 8 && ZeroRun < 2)
+            {
+                uint64_t word;
+                memcpy(&word, P, sizeof(word));
+
+                if (((word - 0x0101010101010101ULL) & ~word & 0x8080808080808080ULL) == 0)
+                {
+                    const int32_t bits = (64 - CacheBits) & ~0b111;
+                    if (bits > 0)
+                    {
+                        word = __builtin_bswap64(word);
+
+                        Cache |= (word >> (64 - bits)) << (64 - bits - CacheBits);
+                        CacheBits += bits;
+                        P += bits / 8;
+                        ZeroRun = 0;
+                    }
+
+                    return;
+                }
+            }
+
+            while (CacheBits <= 56 && P < End)
+            {
+                const uint8_t b = *P++;
+
+                // 0x000003 is escaped start code so drop the 3
+                if (ZeroRun >= 2 && b == 0x03)
+                {
+                    ZeroRun = 0;
+
+                    continue;
+                }
+
+                ZeroRun = b == 0 ? ZeroRun + 1 : 0;
+
+                Cache |= (uint64_t)b << (56 - CacheBits);
+                CacheBits += 8;
+            }
+        }
+
+        inline bool IsEOF() const
+        {
+            return CacheBits <= 0 && P >= End;
         }
 
-		constexpr void Ignore(uint64_t a_n)
-		{
-			P += a_n / 8;
-			BitsLeft -= (int32_t)(a_n % 8);
-			if (BitsLeft <= 0)
-			{
-				++P;
-				BitsLeft = 8;
-			}
-		}
+        // Bits remaining before the next byte boundary
+        inline int32_t BitsLeft() const
+        {
+            const int32_t r = CacheBits & 0b111;
 
-        template<typename T = uint8_t>
-        constexpr T u1()
+            return r == 0 ? 8 : r;
+        }
+
+        inline void Consume(uint32_t a_n)
         {
-            if (!IsEOF())
+            Cache <<= a_n;
+            CacheBits -= (int32_t)a_n;
+            if (CacheBits < 0)
             {
-                const T r = ((*P) >> --BitsLeft) & 0b1;
+                CacheBits = 0;
+            }
+        }
 
-                if (BitsLeft <= 0)
+        inline void Ignore(uint64_t a_n)
+        {
+            while (a_n > 0)
+            {
+                if (CacheBits < 32)
                 {
-                    ++P;
-                    BitsLeft = 8;
+                    Refill();
                 }
 
-                return r;
+                const uint32_t n = (uint32_t)(a_n < 32 ? a_n : 32);
+                Consume(n);
+
+                a_n -= n;
+            }
+        }
+
+        template<typename T = uint8_t>
+        inline T u1()
+        {
+            if (CacheBits <= 0)
+            {
+                Refill();
             }
 
-            return 0;
+            const T r = (T)(Cache >> 63);
+            Consume(1);
+
+            return r;
         }
 
+        // Past the end reads as 0 the same as u1
         template<typename T = uint32_t>
-        constexpr T u(uint32_t a_n)
+        inline T u(uint32_t a_n)
         {
-            const T n1 = a_n - 1;
+            if (a_n == 0)
+            {
+                return 0;
+            }
 
-            T r = 0;
-            for (uint32_t i = 0; i < a_n; ++i)
+            if (CacheBits < (int32_t)a_n)
             {
-                r |= u1<T>() << (n1 - i);
+                Refill();
             }
 
+            const T r = (T)(Cache >> (64 - a_n));
+            Consume(a_n);
+
             return r;
         }
 
-        constexpr uint32_t ue()
+        inline uint32_t ue()
         {
+            if (CacheBits < 32)
+            {
+                Refill();
+            }
+
+            // Whole code is in the cache so can be read in one go
+            if (Cache != 0)
+            {
+                const int32_t zeros = __builtin_clzll(Cache);
+                const int32_t len = zeros * 2 + 1;
+                if (zeros < 32 && len <= CacheBits)
+                {
+                    const uint64_t r = Cache >> (64 - len);
+                    Consume((uint32_t)len);
+
+                    return (uint32_t)(r - 1);
+                }
+            }
+
             uint32_t i = 0;
             while (u1() == 0 && i < 32 && !IsEOF())
             {
@@ -92,16 +189,16 @@ namespace H264
             return r + (1 << i) - 1;
         }
 
-		constexpr int32_t se()
-		{
-			const uint32_t r = ue();
-			if (r & 0b1)
-			{
-				return (int32_t)(r + 1) / 2;
-			}
+        inline int32_t se()
+        {
+            const uint32_t r = ue();
+            if (r & 0b1)
+            {
+                return (int32_t)(r + 1) / 2;
+            }
 
-			return (int32_t)(r / 2);
-		}
+            return (int32_t)(r / 2);
+        }
     };
 
     enum e_NALRefIDC
@@ -4,9 +4,11 @@
 
 #pragma once
 
+#include <atomic>
 #include <filesystem>
 
 #include "DataTypes/Array.h"
+#include "DataTypes/SpinLock.h"
 #include "Rendering/Video/H264.h"
 
 enum e_VideoProfile
@@ -39,9 +41,41 @@ struct VideoFrameInfo
     uint64_t Offset;
 };
 
+struct VideoGOPInfo
+{
+    // Always an intra frame except for leading frames before the first intra frame
+    uint32_t FrameIndex;
+    // Highest timestamp up to the end of the GOP
+    // Frames are in presentation order so timestamps are not guaranteed to be monotonic
+    double   MaxTimeStamp;
+};
+
+enum e_VideoPrefetchState : uint32_t
+{
+    VideoPrefetchState_Pending,
+    VideoPrefetchState_Ready
+};
+
+// Shared between the clip and the job reading it so either can go away first
+struct VideoClipPrefetch
+{
+    std::atomic<uint32_t> Refs;
+    std::atomic<uint32_t> State;
+    uint32_t StartIndex;
+    uint32_t EndIndex;
+    uint32_t Size;
+    uint8_t* Data;
+};
+
 class VideoClip
 {
 private:
+    // Enough to read the NAL and slice headers of most slices when building the frame table
+    static constexpr uint32_t SliceHeaderPeekSize = 64;
+    // Caps the bitstream held in memory ahead of playback
+    static constexpr uint32_t MaxPrefetchCount = 2;
+    static constexpr uint64_t MaxPrefetchSize = 1ULL << 26;
+
     std::filesystem::path m_path;
 
     e_VideoProfile        m_videoProfile;
@@ -58,9 +92,22 @@ private:
     uint32_t              m_frameCount;
     VideoFrameInfo*       m_frames;
 
+    uint32_t              m_gopCount;
+    VideoGOPInfo*         m_gops;
+    // Playback asks for the following GOP most of the time so check around the last one before searching
+    mutable std::atomic<uint32_t> m_lastGOP;
+
+    mutable SpinLock           m_prefetchLock;
+    mutable VideoClipPrefetch* m_prefetch[MaxPrefetchCount];
+
     double                m_duration;
     float                 m_fps;
 
+    void BuildGOPIndex();
+    uint32_t FindGOP(double a_timeStamp) const;
+
+    bool GetClipRange(double a_timeStamp, uint32_t* a_startIndex, uint32_t* a_endIndex) const;
+
 protected:
 
 public:
@@ -126,7 +173,11 @@ public:
         return m_sps.Size();
     }
 
+    static void ReadClipData(const std::filesystem::path& a_path, const VideoFrameInfo* a_frames, uint32_t a_frameCount, uint8_t** a_data, uint32_t* a_size);
+
     bool GetVideoClipData(double a_inTimeStamp, uint32_t* a_startIndex, uint32_t* a_endIndex, uint8_t** a_data, uint32_t* a_size) const;
+    // Starts reading the clip data for the timestamp in the background so the next GetVideoClipData call does not hit the disk
+    void PrefetchClipData(double a_timeStamp) const;
 };
 
 // MIT License
@@ -0,0 +1,72 @@
+// Icarian Engine - C# Game Engine
+// 
+// License at end of file.
+
+#pragma once
+
+#ifdef ICARIANNATIVE_ENABLE_GRAPHICS_VULKAN
+
+#include "Rendering/Vulkan/IcarianVulkanHeader.h"
+
+class VulkanRenderEngineBackend;
+
+// Host visible per frame vertex ring for geometry rebuilt on the CPU every frame
+// Writes append to the buffer for the frame and get reset at the start of the next use of that frame index
+// When a frame runs out of space the buffer is replaced with a larger one straight away
+// The old buffer goes through the deletion queue as commands recorded earlier in the frame still read from it
+class VulkanDynamicVertexBuffer
+{
+private:
+    VulkanRenderEngineBackend* m_engine;
+
+    vk::Buffer                 m_buffers[VulkanFlightPoolSize];
+    VmaAllocation              m_allocations[VulkanFlightPoolSize];
+    void*                      m_mapped[VulkanFlightPoolSize];
+    uint32_t                   m_sizes[VulkanFlightPoolSize];
+
+    uint32_t                   m_offset;
+    uint32_t                   m_requiredSize;
+
+    void CreateBuffer(uint32_t a_index, uint32_t a_size);
+    void GrowBuffer(uint32_t a_index, uint32_t a_size);
+
+protected:
+
+public:
+    VulkanDynamicVertexBuffer(VulkanRenderEngineBackend* a_engine, uint32_t a_initialSize);
+    ~VulkanDynamicVertexBuffer();
+
+    void Reset(uint32_t a_index);
+    // Buffer can change on a write so GetBuffer needs to be called after writing
+    vk::DeviceSize Write(uint32_t a_index, const void* a_data, uint32_t a_size);
+
+    inline vk::Buffer GetBuffer(uint32_t a_index) const
+    {
+        return m_buffers[a_index];
+    }
+};
+
+#endif
+
+
+// MIT License
+// 
+// Copyright (c) 2024 River Govers
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
\ No newline at end of file
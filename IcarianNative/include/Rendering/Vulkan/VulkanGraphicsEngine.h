@@ -32,8 +32,10 @@
 struct CanvasBuffer;
 
 class RuntimeFunction;
+class UIBatcher;
 class VulkanDepthCubeRenderTexture;
 class VulkanDepthRenderTexture;
+class VulkanDynamicVertexBuffer;
 class VulkanGraphicsEngineBindings;
 class VulkanGraphicsParticle2D;
 class VulkanLightData;
@@ -55,6 +57,7 @@ private:
     friend class VulkanGraphicsEngineBindings;
 
     static constexpr uint32_t DrawingPassCount = 7;
+    static constexpr uint32_t UIVertexBufferInitialSize = 1024 * 256;
 
     VulkanGraphicsEngineBindings*                 m_runtimeBindings;
     VulkanSwapchain*                              m_swapchain;
@@ -118,6 +121,10 @@ private:
 
     VulkanUniformBuffer*                          m_timeUniform;
 
+    VulkanDynamicVertexBuffer*                    m_uiVertexBuffer;
+    // Indexed by canvas and only touched by the UI draw
+    Array<UIBatcher*>                             m_uiBatchers;
+
     vk::CommandPool                               m_decodePool[VulkanFlightPoolSize];
     vk::CommandBuffer                             m_decodeBuffer[VulkanFlightPoolSize];
 
@@ -142,7 +149,7 @@ private:
     VulkanCommandBuffer ForwardPass(uint32_t a_camIndex, uint32_t a_bufferIndex, uint32_t a_frameIndex);
     VulkanCommandBuffer PostPass(uint32_t a_camIndex, uint32_t a_bufferIndex, uint32_t a_frameIndex);
 
-    void DrawUIElement(vk::CommandBuffer a_commandBuffer, uint32_t a_addr, const CanvasBuffer& a_canvas, const glm::vec2& a_screenSize, uint32_t a_index);
+    void DrawCanvas(vk::CommandBuffer a_commandBuffer, uint32_t a_canvasAddr, const CanvasBuffer& a_canvas, const glm::vec2& a_screenSize, uint32_t a_index);
     
 protected:
 
@@ -11,6 +11,8 @@
 #include <string_view>
 #include <unordered_map>
 
+#include "Runtime/RuntimeThunk.h"
+
 class RenderEngine;
 class RuntimeFunction;
 
@@ -39,8 +41,8 @@ private:
     MonoClass*                                             m_programClass;
                                         
     MonoMethod*                                            m_initMethod;
-    MonoMethod*                                            m_updateMethod;
-    MonoMethod*                                            m_lateUpdateMethod;
+    RuntimeThunk<double, double>*                          m_updateFunction;
+    RuntimeThunk<>*                                        m_lateUpdateFunction;
     MonoMethod*                                            m_shutdownMethod;
 
     RuntimeManager();
@@ -67,7 +69,13 @@ public:
 
     static MonoClass* GetClass(const std::string_view& a_namespace, const std::string_view& a_name);
 
+    static MonoMethod* GetMethod(const std::string_view& a_namespace, const std::string_view& a_class, const std::string_view& a_method);
     static RuntimeFunction* GetFunction(const std::string_view& a_namespace, const std::string_view& a_class, const std::string_view& a_method);
+    template<typename... T>
+    static RuntimeThunk<T...>* GetThunk(const std::string_view& a_namespace, const std::string_view& a_class, const std::string_view& a_method)
+    {
+        return new RuntimeThunk<T...>(GetMethod(a_namespace, a_class, a_method));
+    }
 };
 
 // MIT License
@@ -0,0 +1,72 @@
+// Icarian Engine - C# Game Engine
+// 
+// License at end of file.
+
+#pragma once
+
+#include <mono/jit/jit.h>
+#include <mono/metadata/object.h>
+
+// Typed call into a static managed method through the native to managed wrapper returned by mono_method_get_unmanaged_thunk
+// Avoids the reflective argument handling of mono_runtime_invoke so is prefered for per frame callbacks
+// Arguments follow the thunk rules:
+//     Primitives are passed by value
+//     Reference types are passed as MonoObject* or MonoArray*
+//     Value types must be taken by ref on the managed side and passed as a pointer otherwise Mono expects them boxed
+template<typename... T>
+class RuntimeThunk
+{
+private:
+    typedef void (*Thunk)(T..., MonoException**);
+
+    MonoMethod* m_method;
+    Thunk       m_thunk;
+
+protected:
+
+public:
+    RuntimeThunk(MonoMethod* a_method)
+    {
+        m_method = a_method;
+        m_thunk = (Thunk)mono_method_get_unmanaged_thunk(a_method);
+    }
+    ~RuntimeThunk()
+    {
+        mono_free_method(m_method);
+    }
+
+    inline void Exec(T... a_args) const
+    {
+        MonoException* exception = nullptr;
+
+        m_thunk(a_args..., &exception);
+
+        if (exception != nullptr)
+        {
+            mono_unhandled_exception((MonoObject*)exception);
+        }
+    }
+};
+
+
+// MIT License
+// 
+// Copyright (c) 2024 River Govers
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
\ No newline at end of file
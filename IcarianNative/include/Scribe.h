@@ -6,23 +6,50 @@
 
 #include <cstdint>
 #include <string>
+#include <unordered_map>
 
+#include "DataTypes/Array.h"
 #include "DataTypes/SpinLock.h"
 #include "DataTypes/TUMap.h"
 #include "IcarianError.h"
 
+struct ScribeSegment
+{
+    static constexpr uint32_t Literal = UINT32_MAX;
+
+    // Ranges into the UTF-32 and UTF-16 text, arguments keep the placeholder text for when they are not supplied
+    uint32_t Start;
+    uint32_t Length;
+    uint32_t Start16;
+    uint32_t Length16;
+    uint32_t Arg;
+};
+
+// Templates are split into literal and argument segments when set so formatting is a single pass into a presized buffer
+struct ScribeString
+{
+    std::string          Key;
+    std::u32string       Text;
+    std::u16string       Text16;
+    Array<ScribeSegment> Segments;
+};
+
 class Scribe
 {
 private:
     static Scribe* Instance;
 
-    SharedSpinLock                     m_lock;
-    std::string                        m_curLang;
-    TUMap<std::string, std::u32string> m_strings;
-    TUMap<std::string, uint32_t>       m_fonts;
+    SharedSpinLock                             m_lock;
+    std::string                                m_curLang;
+    // Keyed by hash of the UTF-8 key so lookups from the runtime do not need to convert the key
+    std::unordered_map<uint64_t, ScribeString> m_strings;
+    TUMap<std::string, uint32_t>               m_fonts;
 
     Scribe();
 
+    const ScribeString* FindString(const std::string_view& a_key) const;
+    const ScribeString* FindString(const std::u16string_view& a_key) const;
+
 protected:
 
 public:
@@ -34,12 +61,7 @@ public:
     static std::string GetCurrentLanguage();
     static void SetCurrentLanguage(const std::string_view& a_language);
 
-    inline static bool KeyExists(const std::string_view& a_key)
-    {
-        IVERIFY(Instance != nullptr);
-
-        return Instance->m_strings.Exists(std::string(a_key));
-    }
+    static bool KeyExists(const std::string_view& a_key);
 
     inline static void SetFont(const std::string_view& a_key, uint32_t a_addr)
     {
@@ -47,18 +69,18 @@ public:
 
         Instance->m_fonts.Push(std::string(a_key), a_addr);
     }
-    inline static void SetString(const std::string_view& a_key, const std::u32string_view& a_string)
-    {
-        IVERIFY(Instance != nullptr);
-
-        Instance->m_strings.Push(std::string(a_key), std::u32string(a_string));
-    }
+    static void SetString(const std::string_view& a_key, const std::u32string_view& a_string);
 
     static uint32_t GetFont(const std::string_view& a_key);
 
     static std::u32string GetString(const std::string_view& a_key);
     static std::u32string GetStringFormated(const std::string_view& a_key, const char32_t* const* a_args, uint32_t a_count);
     static std::u32string GetStringFormated(const std::string_view& a_key, const std::u32string* a_args, uint32_t a_count);
+
+    // Writes straight into the buffer for the runtime which keeps its strings in UTF-16
+    // Returns false if the key does not exist and leaves the buffer untouched
+    static bool GetStringUTF16(const std::u16string_view& a_key, std::u16string* a_out);
+    static bool GetStringFormatedUTF16(const std::u16string_view& a_key, const std::u16string_view* a_args, uint32_t a_count, std::u16string* a_out);
 };
 
 // MIT License
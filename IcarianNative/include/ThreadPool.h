@@ -10,7 +10,8 @@
 #include "DataTypes/TArray.h"
 #include "ThreadJob.h"
 
-class RuntimeFunction;
+template<typename... T>
+class RuntimeThunk;
 
 class ThreadPool
 {
@@ -23,7 +24,7 @@ private:
         }
     };
 
-    RuntimeFunction*                                                m_runtimeDispatch;
+    RuntimeThunk<uint32_t>*                                         m_runtimeDispatch;
 
     std::thread*                                                    m_threads;
 
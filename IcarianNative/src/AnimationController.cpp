@@ -5,7 +5,6 @@
 #include "Rendering/AnimationController.h"
 
 #include "Rendering/AnimationControllerBindings.h"
-#include "Runtime/RuntimeFunction.h"
 #include "Runtime/RuntimeManager.h"
 #include "ThreadJob.h"
 #include "ThreadPool.h"
@@ -16,8 +15,8 @@ static AnimationController* Instance = nullptr;
 AnimationController::AnimationController()
 {
     TRACE("Initializing AnimationController");
-    m_updateAnimatorFunc = RuntimeManager::GetFunction("IcarianEngine.Rendering.Animation", "Animator", ":UpdateAnimatorS(uint,double)");
-    m_updateAnimatorsFunc = RuntimeManager::GetFunction("IcarianEngine.Rendering.Animation", "Animator", ":UpdateAnimatorsS(uint[],double)");
+    m_updateAnimatorFunc = RuntimeManager::GetThunk<uint32_t, double>("IcarianEngine.Rendering.Animation", "Animator", ":UpdateAnimatorS(uint,double)");
+    m_updateAnimatorsFunc = RuntimeManager::GetThunk<MonoArray*, double>("IcarianEngine.Rendering.Animation", "Animator", ":UpdateAnimatorsS(uint[],double)");
 
     m_bindings = new AnimationControllerBindings(this);
 }
@@ -68,13 +67,7 @@ std::vector<uint32_t> AnimationController::GetAnimators(e_AnimationUpdateMode a_
 
 void AnimationController::UpdateAnimator(uint32_t a_index, double a_deltaTime)
 {
-    void* args[] = 
-    { 
-        &a_index, 
-        &a_deltaTime 
-    };
-
-    Instance->m_updateAnimatorFunc->Exec(args);
+    Instance->m_updateAnimatorFunc->Exec(a_index, a_deltaTime);
 }
 void AnimationController::UpdateAnimators(e_AnimationUpdateMode a_updateMode, double a_deltaTime)
 {
@@ -89,13 +82,7 @@ void AnimationController::UpdateAnimators(e_AnimationUpdateMode a_updateMode, do
             mono_array_set(animatorsArray, uint32_t, i, animators[i]);
         }
 
-        void* args[] = 
-        { 
-            animatorsArray, 
-            &a_deltaTime 
-        };
-
-        Instance->m_updateAnimatorsFunc->Exec(args);
+        Instance->m_updateAnimatorsFunc->Exec(animatorsArray, a_deltaTime);
     }
 }
 
@@ -143,7 +143,7 @@ Application::Application(Config* a_config)
     VideoManager::Init();
 
     m_navigation = new Navigation();
-    m_audioEngine = new AudioEngine();
+    m_audioEngine = new AudioEngine(m_config);
     m_physicsEngine = new PhysicsEngine(m_config);
     m_renderEngine = new RenderEngine(m_appWindow, m_config);
     m_networkManager = new NetworkManager();
@@ -174,6 +174,10 @@ Application::~Application()
     AnimationController::Destroy();
     UIControl::Destroy();
 
+    // Jobs popped before the stop still run and queued jobs can reference engine objects
+    // Joining the pool here means nothing is left in flight when the engines go away
+    ThreadPool::Destroy();
+
     delete m_navigation;
     delete m_audioEngine;
     delete m_physicsEngine;
@@ -189,7 +193,6 @@ Application::~Application()
     Profiler::Destroy();
     Scribe::Destroy();
 
-    ThreadPool::Destroy();
     DeletionQueue::Destroy();
     FileCache::Destroy();
 
@@ -271,6 +274,12 @@ void Application::Run(int32_t a_argc, char* a_argv[])
                 m_physicsEngine->Update(delta);
             }
 
+            {
+                PROFILESTACK("Navigation");
+
+                m_navigation->Update();
+            }
+
             RuntimeManager::LateUpdate();
         }
 
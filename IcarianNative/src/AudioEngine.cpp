@@ -4,12 +4,18 @@
 
 #include "Audio/AudioEngine.h"
 
+#include <algorithm>
+#include <chrono>
 #include <cstddef>
+#include <functional>
+#include <glm/gtc/constants.hpp>
 #include <string.h>
 
 #include "Audio/AudioClips/AudioClip.h"
 #include "Audio/AudioEngineBindings.h"
-#include "DataTypes/RingAllocator.h"
+#include "Audio/AudioMixKernels.h"
+#include "Config.h"
+#include "DataTypes/FrameAllocator.h"
 #include "IcarianError.h"
 #include "ObjectManager.h"
 #include "Profiler.h"
@@ -28,10 +34,23 @@ static bool IsExtensionSupported(const std::string_view& a_extension)
     return (bool)alIsExtensionPresent(a_extension.data());
 }
 
-AudioEngine::AudioEngine()
+AudioEngine::AudioEngine(Config* a_config)
 {
     m_bindings = new AudioEngineBindings(this);   
 
+    m_shutdown = false;
+    m_playID = 0;
+    m_underrunCount = 0;
+
+    m_cacheSize = (uint64_t)a_config->GetAudioCacheSize() * 1024 * 1024;
+    m_cacheUsed = 0;
+
+    m_outputSource = 0;
+    m_outputRate = DefaultOutputRate;
+
+    m_listenerPosition = glm::vec3(0.0f);
+    m_listenerRight = glm::vec3(1.0f, 0.0f, 0.0f);
+
     TRACE("Creating AudioEngine...");
     m_device = alcOpenDevice(NULL);
     if (m_device == NULL)
@@ -65,11 +84,29 @@ AudioEngine::AudioEngine()
         return;
     }
 
+    // Mix at the rate the device runs at so OpenAL does not resample a second time
+    ALCint frequency = 0;
+    alcGetIntegerv(m_device, ALC_FREQUENCY, 1, &frequency);
+    if (frequency > 0)
+    {
+        m_outputRate = (uint32_t)frequency;
+    }
+
     // Flush Errors
     alGetError();
+
+    TRACE("Starting Audio Thread");
+    m_thread = std::thread(std::bind(&AudioEngine::Run, this));
 }
 AudioEngine::~AudioEngine()
 {
+    if (m_thread.joinable())
+    {
+        TRACE("Stopping Audio Thread");
+        m_shutdown = true;
+        m_thread.join();
+    }
+
     delete m_bindings;
 
     for (uint32_t i = 0; i < m_audioClips.Size(); ++i)
@@ -87,16 +124,6 @@ AudioEngine::~AudioEngine()
         if (m_audioSources.Exists(i))
         {
             IWARN("AudioSource was not destroyed.");
-
-            if (m_audioSources[i].Source != -1)
-            {
-                alSourceStop(m_audioSources[i].Source);
-                alDeleteSources(1, &m_audioSources[i].Source);
-            }
-            if (m_audioSources[i].Buffers[0] != -1)
-            {
-                alDeleteBuffers(AudioSourceBuffer::BufferCount, m_audioSources[i].Buffers);
-            }
         }
     }
 
@@ -128,301 +155,844 @@ AudioEngine::~AudioEngine()
     }
 }
 
-static constexpr ALenum GetALFormat(e_AudioFormat a_format, uint32_t a_channelCount)
+static uint8_t* GetAudioData(FrameAllocator* a_allocator, AudioClip* a_clip, AudioClipDecoder* a_decoder, uint64_t a_sampleOffset, uint32_t a_sampleSize, uint32_t* a_outSampleSize)
 {
-    switch (a_format)
+    if (a_decoder != nullptr)
     {
-    case AudioFormat_U8:
+        return a_decoder->GetAudioData(a_allocator, a_sampleOffset, a_sampleSize, a_outSampleSize);
+    }
+
+    return a_clip->GetAudioData(a_allocator, a_sampleOffset, a_sampleSize, a_outSampleSize);
+}
+
+static double GetResampleStep(const AudioClip* a_clip, uint32_t a_outputRate, uint32_t a_maxStep)
+{
+    return glm::min((double)a_clip->GetSampleRate() / a_outputRate, (double)a_maxStep);
+}
+
+static AudioCommand GetTransformCommand(e_AudioCommandType a_type, uint32_t a_addr, uint32_t a_transformAddr)
+{
+    const glm::mat4 transform = ObjectManager::GetGlobalMatrix(a_transformAddr);
+
+    AudioCommand command = { };
+    command.Type = a_type;
+    command.Addr = a_addr;
+    command.Position = transform[3].xyz();
+    command.Forward = transform[2].xyz();
+    command.Up = -transform[1].xyz();
+
+    return command;
+}
+
+bool AudioEngine::ReserveCache(uint64_t a_size)
+{
+    uint64_t used = m_cacheUsed.load(std::memory_order_relaxed);
+    do
     {
-        switch (a_channelCount)
-        {
-        case 1:
+        if (used + a_size > m_cacheSize)
         {
-            return AL_FORMAT_MONO8;
+            return false;
         }
-        case 2:
+    } 
+    while (!m_cacheUsed.compare_exchange_weak(used, used + a_size, std::memory_order_relaxed));
+
+    return true;
+}
+void AudioEngine::ReleaseCache(uint64_t a_size)
+{
+    m_cacheUsed.fetch_sub(a_size, std::memory_order_relaxed);
+}
+
+AudioSourceVoice* AudioEngine::GetVoice(uint32_t a_addr)
+{
+    const uint32_t voiceCount = m_voices.Size();
+    if (a_addr >= voiceCount)
+    {
+        // Zero initialised voices are stopped with no staging buffer
+        m_voices.Resize(a_addr + 1);
+        for (uint32_t i = voiceCount; i <= a_addr; ++i)
         {
-            return AL_FORMAT_STEREO8;
+            m_voices[i].AudioMixerAddr = uint32_t(-1);
         }
+    }
+
+    return &m_voices[a_addr];
+}
+AudioBus* AudioEngine::GetBus(uint32_t a_addr)
+{
+    const uint32_t busCount = m_buses.Size();
+    if (a_addr >= busCount)
+    {
+        m_buses.Resize(a_addr + 1);
+        for (uint32_t i = busCount; i <= a_addr; ++i)
+        {
+            m_buses[i].Gain = 1.0f;
+            m_buses[i].ParentAddr = uint32_t(-1);
         }
     }
-    case AudioFormat_S16:
+
+    return &m_buses[a_addr];
+}
+
+void AudioEngine::StopVoice(uint32_t a_addr, AudioSourceVoice* a_voice)
+{
+    if (a_voice->Decoder != nullptr)
+    {
+        delete a_voice->Decoder;
+
+        a_voice->Decoder = nullptr;
+    }
+
+    a_voice->StagingCount = 0;
+    a_voice->Fraction = 0.0;
+
+    if (a_voice->Flags & 0b1 << AudioSourceVoice::PlayingBitOffset)
+    {
+        a_voice->Flags &= ~(0b1 << AudioSourceVoice::PlayingBitOffset | 0b1 << AudioSourceVoice::VirtualBitOffset);
+
+        // Notification queue is drained every frame by the update thread so if it is full something has gone very wrong and the playing state will just be stale
+        m_finished.TryPush({ a_addr, a_voice->PlayID });
+    }
+}
+
+void AudioEngine::ProcessCommand(const AudioCommand& a_command)
+{
+    switch (a_command.Type)
+    {
+    case AudioCommandType_Play:
     {
-        switch (a_channelCount)
+        AudioSourceVoice* voice = GetVoice(a_command.Addr);
+        
+        // Address comes from script so can be stale or bad and the array does not bounds check
+        // The mixer only handles mono and stereo which is all OpenAL took before anyway
+        AudioClip* clip = a_command.Value < m_audioClips.Size() ? m_audioClips[a_command.Value] : nullptr;
+        if (clip == nullptr || clip->GetSampleRate() == 0 || clip->GetChannelCount() == 0 || clip->GetChannelCount() > 2)
         {
-        case 1:
+            m_finished.TryPush({ a_command.Addr, a_command.PlayID });
+
+            break;
+        }
+
+        StopVoice(a_command.Addr, voice);
+
+        if (voice->Staging == nullptr)
+        {
+            // Sized for stereo so it can be kept when the clip changes
+            voice->Staging = new float[StagingFrameCount * 2];
+        }
+
+        // Each voice gets its own decoder so sequential reads never have to seek
+        voice->Decoder = clip->CreateDecoder();
+
+        voice->AudioClipAddr = a_command.Value;
+        voice->PlayID = a_command.PlayID;
+        voice->Position = a_command.Position;
+        voice->SampleOffset = 0;
+        voice->Flags &= 0b1 << AudioSourceVoice::LoopBitOffset;
+        voice->Flags |= 0b1 << AudioSourceVoice::PlayingBitOffset;
+
+        break;
+    }
+    case AudioCommandType_Stop:
+    {
+        AudioSourceVoice* voice = GetVoice(a_command.Addr);
+
+        StopVoice(a_command.Addr, voice);
+
+        break;
+    }
+    case AudioCommandType_SetLoop:
+    {
+        AudioSourceVoice* voice = GetVoice(a_command.Addr);
+
+        if (a_command.Value != 0)
         {
-            return AL_FORMAT_MONO16;
+            voice->Flags |= 0b1 << AudioSourceVoice::LoopBitOffset;
         }
-        case 2:
+        else
         {
-            return AL_FORMAT_STEREO16;
+            voice->Flags &= ~(0b1 << AudioSourceVoice::LoopBitOffset);
         }
+
+        break;
+    }
+    case AudioCommandType_SetClip:
+    {
+        AudioSourceVoice* voice = GetVoice(a_command.Addr);
+
+        // Changing the clip under a playing source would read the new clip with the old offset so just stop it
+        if (voice->AudioClipAddr != a_command.Value)
+        {
+            StopVoice(a_command.Addr, voice);
         }
+
+        voice->AudioClipAddr = a_command.Value;
+
+        break;
     }
+    case AudioCommandType_SetMixer:
+    {
+        AudioSourceVoice* voice = GetVoice(a_command.Addr);
+
+        voice->AudioMixerAddr = a_command.Value;
+
+        break;
     }
+    case AudioCommandType_SetTransform:
+    {
+        AudioSourceVoice* voice = GetVoice(a_command.Addr);
 
-    return AL_FORMAT_MONO16;
-}
-static constexpr uint64_t GetAudioSize(e_AudioFormat a_format, uint32_t a_channelCount, uint32_t a_samples)
-{
-    switch (a_format)
+        voice->Position = a_command.Position;
+
+        break;
+    }
+    case AudioCommandType_DestroySource:
+    {
+        AudioSourceVoice* voice = GetVoice(a_command.Addr);
+
+        if (voice->Decoder != nullptr)
+        {
+            delete voice->Decoder;
+        }
+
+        if (voice->Staging != nullptr)
+        {
+            delete[] voice->Staging;
+        }
+
+        // Address can be reused so reset to a clean voice
+        *voice = { };
+        voice->AudioMixerAddr = uint32_t(-1);
+
+        break;
+    }
+    case AudioCommandType_SetMixerBus:
     {
-    case AudioFormat_U8:
+        AudioBus* bus = GetBus(a_command.Addr);
+
+        bus->Gain = a_command.Gain;
+        bus->ParentAddr = a_command.Value;
+
+        break;
+    }
+    case AudioCommandType_DestroyMixer:
     {
-        return a_samples * a_channelCount * sizeof(uint8_t);
+        AudioBus* bus = GetBus(a_command.Addr);
+
+        bus->Gain = 1.0f;
+        bus->ParentAddr = uint32_t(-1);
+
+        // Anything still routed through the mixer falls back to the master output
+        const uint32_t busCount = m_buses.Size();
+        for (uint32_t i = 0; i < busCount; ++i)
+        {
+            if (m_buses[i].ParentAddr == a_command.Addr)
+            {
+                m_buses[i].ParentAddr = uint32_t(-1);
+            }
+        }
+
+        const uint32_t voiceCount = m_voices.Size();
+        for (uint32_t i = 0; i < voiceCount; ++i)
+        {
+            if (m_voices[i].AudioMixerAddr == a_command.Addr)
+            {
+                m_voices[i].AudioMixerAddr = uint32_t(-1);
+            }
+        }
+
+        break;
     }
-    case AudioFormat_S16:
+    case AudioCommandType_SetListenerTransform:
     {
-        return a_samples * a_channelCount * sizeof(int16_t);
+        m_listenerPosition = a_command.Position;
+
+        // Same orientation OpenAL used so right is forward cross up
+        const glm::vec3 right = glm::cross(a_command.Forward, a_command.Up);
+        const float rightLength = glm::length(right);
+        if (rightLength > 0.0001f)
+        {
+            m_listenerRight = right / rightLength;
+        }
+
+        break;
     }
+    case AudioCommandType_DestroyClip:
+    {
+        const uint32_t voiceCount = m_voices.Size();
+        for (uint32_t i = 0; i < voiceCount; ++i)
+        {
+            AudioSourceVoice* voice = &m_voices[i];
+            if (voice->Flags & 0b1 << AudioSourceVoice::PlayingBitOffset && voice->AudioClipAddr == a_command.Addr)
+            {
+                StopVoice(i, voice);
+            }
+        }
+
+        // The clip is only freed once the audio thread is done with it
+        const AudioClip* clip = m_audioClips[a_command.Addr];
+        // Already destroyed by an earlier command so nothing left to release
+        if (clip == nullptr)
+        {
+            break;
+        }
+        IDEFER(delete clip);
+
+        ReleaseCache(clip->GetCachedSize());
+
+        m_audioClips.Erase(a_command.Addr);
+
+        break;
     }
+    default:
+    {
+        IERROR("Invalid audio command");
 
-    return 0;
+        break;
+    }
+    }
 }
 
-static uint64_t FillBuffers(RingAllocator* a_allocator, ALuint* a_buffer, uint32_t a_bufferCount, AudioClip* a_clip, uint64_t a_sampleOffset, uint32_t a_sampleSize, bool a_canLoop)
+void AudioEngine::FillStaging(FrameAllocator* a_allocator, AudioSourceVoice* a_voice, AudioClip* a_clip, uint32_t a_frameCount)
 {
-    uint32_t outSampleSize;
-    const uint32_t channelCount = a_clip->GetChannelCount();  
-    const uint32_t sampleRate = a_clip->GetSampleRate();
+    const uint32_t channelCount = a_clip->GetChannelCount();
     const e_AudioFormat format = a_clip->GetAudioFormat();
+    const uint64_t sampleSize = a_clip->GetSampleSize();
+    const bool canLoop = a_voice->Flags & 0b1 << AudioSourceVoice::LoopBitOffset;
 
-    const uint64_t maxSampleOffset = a_clip->GetSampleSize();
-
-    for (uint32_t i = 0; i < a_bufferCount; ++i)
+    while (a_voice->StagingCount < a_frameCount && !(a_voice->Flags & 0b1 << AudioSourceVoice::EndedBitOffset))
     {
-        // Do not need to de-allocate this as it is managed by the ring allocator.
-        uint8_t* data = a_clip->GetAudioData(a_allocator, a_sampleOffset, a_sampleSize, &outSampleSize);
-        if (data == nullptr)
+        if (a_voice->SampleOffset >= sampleSize)
         {
-            break;
+            if (!canLoop || sampleSize == 0)
+            {
+                a_voice->Flags |= 0b1 << AudioSourceVoice::EndedBitOffset;
+
+                break;
+            }
+
+            a_voice->SampleOffset = 0;
         }
-        
-        // Unlikely but if the sample size is less than the requested sample size, we need to loop.
-        // Not the most efficient way to do this but it works. KISS, right?
-        while (outSampleSize < a_sampleSize)
+
+        // Read in decent sized chunks so decoders are not called for a handful of frames at a time
+        const uint32_t space = StagingFrameCount - a_voice->StagingCount;
+        const uint32_t request = glm::min(space, glm::max(ReadFrameCount, a_frameCount - a_voice->StagingCount));
+
+        uint32_t outSampleSize = 0;
+        // Either points into the clip or comes from the frame allocator which is reset every audio thread update so nothing to free
+        const uint8_t* data = GetAudioData(a_allocator, a_clip, a_voice->Decoder, a_voice->SampleOffset, request, &outSampleSize);
+        if (data == nullptr || outSampleSize == 0)
         {
-            if (a_canLoop)
+            // Compressed clips can come up slightly short of the length in the header so an empty read is the end of the clip
+            if (canLoop && a_voice->SampleOffset != 0)
             {
-                a_sampleOffset = 0;
+                a_voice->SampleOffset = sampleSize;
 
-                uint32_t nextOutSampleSize;
-                const uint8_t* oldData = data;
-                // Do not need to de-allocate this as it is managed by the ring allocator.
-                const uint8_t* nextData = a_clip->GetAudioData(a_allocator, 0, a_sampleSize - outSampleSize, &nextOutSampleSize);
-                if (nextData == nullptr)
-                {
-                    break;
-                }
+                continue;
+            }
 
-                // Again no need to de-allocate as it is managed by the ring allocator.
-                uint8_t* newData = (uint8_t*)a_allocator->Allocate<int16_t>((outSampleSize + nextOutSampleSize) * channelCount);
+            a_voice->Flags |= 0b1 << AudioSourceVoice::EndedBitOffset;
 
-                const uint32_t count = GetAudioSize(format, channelCount, outSampleSize);
-                memcpy(newData, data, count);
+            break;
+        }
 
-                const uint32_t nextCount = GetAudioSize(format, channelCount, nextOutSampleSize);
-                memcpy(newData + count, nextData, nextCount);
+        outSampleSize = glm::min(outSampleSize, request);
 
-                data = newData;
-                outSampleSize += nextOutSampleSize;
-            }
-            else
-            {
-                break;
-            }       
+        float* staging = a_voice->Staging + a_voice->StagingCount * channelCount;
+        switch (format)
+        {
+        case AudioFormat_U8:
+        {
+            ConvertU8ToFloat(staging, data, outSampleSize * channelCount);
+
+            break;
         }
+        case AudioFormat_S16:
+        {
+            ConvertS16ToFloat(staging, (const int16_t*)data, outSampleSize * channelCount);
 
-        alBufferData(a_buffer[i], GetALFormat(format, channelCount), data, GetAudioSize(format, channelCount, outSampleSize), sampleRate);
+            break;
+        }
+        }
 
-        a_sampleOffset = (a_sampleOffset + outSampleSize) % maxSampleOffset;
+        a_voice->StagingCount += outSampleSize;
+        a_voice->SampleOffset += outSampleSize;
     }
-
-    return a_sampleOffset;
 }
 
-static void SetSourceTransform(const AudioSourceBuffer& a_source)
+bool AudioEngine::MixVoice(FrameAllocator* a_allocator, AudioSourceVoice* a_voice, AudioClip* a_clip, float* a_output)
 {
-    const glm::mat4 transform = ObjectManager::GetGlobalMatrix(a_source.TransformAddr);
+    const uint32_t channelCount = a_clip->GetChannelCount();
+    const double step = GetResampleStep(a_clip, m_outputRate, MaxResampleStep);
+
+    if (a_voice->Flags & 0b1 << AudioSourceVoice::LoopBitOffset)
+    {
+        a_voice->Flags &= ~(0b1 << AudioSourceVoice::EndedBitOffset);
+    }
+
+    const double end = a_voice->Fraction + OutputFrameCount * step;
+    const uint32_t consumed = (uint32_t)end;
 
-    const glm::vec3 position = transform[3].xyz();
-    alSource3f(a_source.Source, AL_POSITION, position.x, position.y, position.z);
+    // Interpolation reads one frame past the last position
+    const uint32_t required = consumed + 1;
+    FillStaging(a_allocator, a_voice, a_clip, required);
 
-    const glm::vec3 forward = transform[2].xyz();
-    const glm::vec3 up = -transform[1].xyz();
+    if (a_voice->StagingCount < required)
+    {
+        // Clip has ended so pad out with silence
+        float* pad = a_voice->Staging + a_voice->StagingCount * channelCount;
+        memset(pad, 0, (required - a_voice->StagingCount) * channelCount * sizeof(float));
+    }
+
+    ResampleLinear(m_voiceBuffer, a_voice->Staging, channelCount, a_voice->Fraction, step, OutputFrameCount);
+
+    if (channelCount == 1)
+    {
+        MixMonoToStereo(a_output, m_voiceBuffer, OutputFrameCount, a_voice->GainL, a_voice->GainR);
+    }
+    else
+    {
+        MixStereo(a_output, m_voiceBuffer, OutputFrameCount, a_voice->GainL, a_voice->GainR);
+    }
+
+    a_voice->Fraction = end - consumed;
 
-    const ALfloat orientation[6] = 
+    if (consumed >= a_voice->StagingCount)
     {
-        forward.x, forward.y, forward.z,
-        up.x,      up.y,      up.z
-    };
+        a_voice->StagingCount = 0;
 
-    alSourcefv(a_source.Source, AL_ORIENTATION, orientation);
-}
+        return a_voice->Flags & 0b1 << AudioSourceVoice::EndedBitOffset;
+    }
 
-void AudioEngine::Update()
+    a_voice->StagingCount -= consumed;
+    memmove(a_voice->Staging, a_voice->Staging + consumed * channelCount, a_voice->StagingCount * channelCount * sizeof(float));
+
+    return false;
+}
+bool AudioEngine::SkipVoice(AudioSourceVoice* a_voice, AudioClip* a_clip)
 {
-    if (m_device == NULL || m_context == NULL)
+    const uint64_t sampleSize = a_clip->GetSampleSize();
+    const double step = GetResampleStep(a_clip, m_outputRate, MaxResampleStep);
+
+    const double end = a_voice->Fraction + OutputFrameCount * step;
+    const uint32_t consumed = (uint32_t)end;
+    a_voice->Fraction = end - consumed;
+
+    // Staged frames are dropped and the read position moved instead so nothing gets decoded
+    // Decoders seek on the next read when the voice becomes real again
+    int64_t offset = (int64_t)a_voice->SampleOffset - a_voice->StagingCount + consumed;
+    a_voice->StagingCount = 0;
+    a_voice->Flags &= ~(0b1 << AudioSourceVoice::EndedBitOffset);
+
+    if (a_voice->Flags & 0b1 << AudioSourceVoice::LoopBitOffset)
     {
-        return;
+        if (sampleSize > 0)
+        {
+            offset %= (int64_t)sampleSize;
+            if (offset < 0)
+            {
+                offset += (int64_t)sampleSize;
+            }
+        }
     }
+    else if (offset >= (int64_t)sampleSize)
+    {
+        return true;
+    }
+
+    a_voice->SampleOffset = (uint64_t)offset;
+
+    return false;
+}
+
+void AudioEngine::UpdateBuses()
+{
+    const uint32_t busCount = m_buses.Size();
 
-    const ALenum error = alGetError();
-    if (error != AL_NO_ERROR)
+    m_busOrder.Clear();
+    for (uint32_t i = 0; i < busCount; ++i)
     {
-        IWARN(std::string("OpenAL Error: ") + alGetString(error));
+        AudioBus* bus = &m_buses[i];
 
-        return;
+        float gain = bus->Gain;
+        uint32_t depth = 0;
+        for (uint32_t parent = bus->ParentAddr; parent < busCount && depth < MaxBusDepth; parent = m_buses[parent].ParentAddr)
+        {
+            gain *= m_buses[parent].Gain;
+            ++depth;
+        }
+
+        // Anything too deep or in a cycle goes straight to the master output
+        if (depth >= MaxBusDepth)
+        {
+            gain = bus->Gain;
+        }
+
+        bus->EffectiveGain = gain;
+        bus->Depth = depth;
+
+        m_busOrder.Push(i);
     }
 
+    // Children need to be summed before their parents
+    std::sort(m_busOrder.begin(), m_busOrder.end(), [this](uint32_t a_lhs, uint32_t a_rhs)
     {
-        PROFILESTACK("Listener Update");
+        return m_buses[a_lhs].Depth > m_buses[a_rhs].Depth;
+    });
 
-        const std::vector<bool> listenerState = m_audioListeners.ToStateVector();
-        TLockArray<AudioListenerBuffer> listenerBuffers = m_audioListeners.ToLockArray();
+    const uint32_t sampleCount = busCount * OutputFrameCount * 2;
+    if (m_busBuffers.Size() < sampleCount)
+    {
+        m_busBuffers.Resize(sampleCount);
+    }
 
-        const uint32_t listenerBufferCount = (uint32_t)listenerState.size();
-        for (uint32_t i = 0; i < listenerBufferCount; ++i)
+    memset(m_busBuffers.Data(), 0, sampleCount * sizeof(float));
+}
+
+void AudioEngine::UpdateVoices()
+{
+    // Matches the OpenAL default inverse distance clamped model
+    constexpr float ReferenceDistance = 1.0f;
+    constexpr float RolloffFactor = 1.0f;
+
+    const uint32_t busCount = m_buses.Size();
+
+    m_realVoices.Clear();
+
+    const uint32_t voiceCount = m_voices.Size();
+    for (uint32_t i = 0; i < voiceCount; ++i)
+    {
+        AudioSourceVoice* voice = &m_voices[i];
+        if (!(voice->Flags & 0b1 << AudioSourceVoice::PlayingBitOffset))
         {
-            if (!listenerState[i])
+            continue;
+        }
+
+        const AudioClip* clip = m_audioClips[voice->AudioClipAddr];
+        if (clip->GetChannelCount() == 1)
+        {
+            const glm::vec3 dir = voice->Position - m_listenerPosition;
+            const float distance = glm::length(dir);
+
+            const float attenuation = ReferenceDistance / (ReferenceDistance + RolloffFactor * (glm::max(distance, ReferenceDistance) - ReferenceDistance));
+
+            float pan = 0.0f;
+            if (distance > 0.0001f)
             {
-                continue;
+                pan = glm::dot(dir / distance, m_listenerRight);
             }
 
-            const AudioListenerBuffer& buffer = listenerBuffers[i];
-            
-            const glm::mat4 transform = ObjectManager::GetGlobalMatrix(buffer.TransformAddr);
+            // Equal power so the volume does not dip in the middle
+            const float angle = (pan + 1.0f) * glm::quarter_pi<float>();
 
-            const glm::vec3 position = transform[3].xyz();
+            voice->GainL = glm::cos(angle) * attenuation;
+            voice->GainR = glm::sin(angle) * attenuation;
+        }
+        else
+        {
+            // OpenAL does not spatialize multi channel clips so neither do we
+            voice->GainL = 1.0f;
+            voice->GainR = 1.0f;
+        }
 
-            alListener3f(AL_POSITION, position.x, position.y, position.z);
+        float busGain = 1.0f;
+        if (voice->AudioMixerAddr < busCount)
+        {
+            busGain = m_buses[voice->AudioMixerAddr].EffectiveGain;
+        }
 
-            const glm::vec3 forward = transform[2].xyz();
-            const glm::vec3 up = -transform[1].xyz();
+        voice->Audibility = glm::max(voice->GainL, voice->GainR) * busGain;
+        voice->Flags |= 0b1 << AudioSourceVoice::VirtualBitOffset;
 
-            const ALfloat orientation[6] = { forward.x, forward.y, forward.z, up.x, up.y, up.z };
+        if (voice->Audibility >= AudibleThreshold)
+        {
+            m_realVoices.Push(i);
+        }
+    }
 
-            alListenerfv(AL_ORIENTATION, orientation);
+    // Only the loudest voices get decoded and mixed
+    if (m_realVoices.Size() > MaxRealVoices)
+    {
+        std::partial_sort(m_realVoices.begin(), m_realVoices.begin() + MaxRealVoices, m_realVoices.end(), [this](uint32_t a_lhs, uint32_t a_rhs)
+        {
+            return m_voices[a_lhs].Audibility > m_voices[a_rhs].Audibility;
+        });
 
-            // To my knowledge, OpenAL only supports one listener so we can break here.
-            break;
-        }
+        m_realVoices.Resize(MaxRealVoices);
     }
 
+    for (const uint32_t addr : m_realVoices)
     {
-        PROFILESTACK("Source Update");
-        
-        // 128KB should be enough for anyone.
-        // Size is an educated guess based on the sample rate and sample size with several channels.
-        // Has not caused any issues so far but may need to be adjusted if overruns occur.
-        // Was looking for an excuse to write a ring allocator.
-        // Just Ye' Ol' if allocation is too expensive just dont. It is that simple.
-        RingAllocator allocator = RingAllocator(1024 * 128);
+        m_voices[addr].Flags &= ~(0b1 << AudioSourceVoice::VirtualBitOffset);
+    }
+}
 
-        const std::vector<bool> sourceState = m_audioSources.ToStateVector();
-        TLockArray<AudioSourceBuffer> sourceBuffers = m_audioSources.ToLockArray();
+void AudioEngine::MixBlock(FrameAllocator* a_allocator)
+{
+    constexpr uint32_t SampleCount = OutputFrameCount * 2;
 
-        const uint32_t sourceBufferCount = (uint32_t)sourceState.size();
-        for (uint32_t i = 0; i < sourceBufferCount; ++i)
+    UpdateBuses();
+    UpdateVoices();
+
+    memset(m_masterBuffer, 0, SampleCount * sizeof(float));
+
+    float* busBuffers = m_busBuffers.Data();
+    const uint32_t busCount = m_buses.Size();
+
+    const uint32_t voiceCount = m_voices.Size();
+    for (uint32_t i = 0; i < voiceCount; ++i)
+    {
+        AudioSourceVoice* voice = &m_voices[i];
+        if (!(voice->Flags & 0b1 << AudioSourceVoice::PlayingBitOffset))
         {
-            if (!sourceState[i])
+            continue;
+        }
+
+        AudioClip* clip = m_audioClips[voice->AudioClipAddr];
+
+        bool finished;
+        if (voice->Flags & 0b1 << AudioSourceVoice::VirtualBitOffset)
+        {
+            finished = SkipVoice(voice, clip);
+        }
+        else
+        {
+            float* output = m_masterBuffer;
+            if (voice->AudioMixerAddr < busCount)
             {
-                continue;
+                output = busBuffers + voice->AudioMixerAddr * SampleCount;
             }
 
-            AudioSourceBuffer& buffer = sourceBuffers[i];
+            finished = MixVoice(a_allocator, voice, clip, output);
+        }
+
+        if (finished)
+        {
+            StopVoice(i, voice);
+        }
+    }
+
+    for (const uint32_t addr : m_busOrder)
+    {
+        const AudioBus& bus = m_buses[addr];
+
+        float* output = m_masterBuffer;
+        if (bus.ParentAddr < busCount && bus.Depth < MaxBusDepth)
+        {
+            output = busBuffers + bus.ParentAddr * SampleCount;
+        }
+
+        MixStereo(output, busBuffers + addr * SampleCount, OutputFrameCount, bus.Gain, bus.Gain);
+    }
+
+    ConvertFloatToS16(m_outputBuffer, m_masterBuffer, SampleCount);
+}
+
+void AudioEngine::UpdateOutput(FrameAllocator* a_allocator)
+{
+    ALint processed;
+    alGetSourcei(m_outputSource, AL_BUFFERS_PROCESSED, &processed);
+
+    for (ALint i = 0; i < processed; ++i)
+    {
+        ALuint buffer;
+        alSourceUnqueueBuffers(m_outputSource, 1, &buffer);
+
+        MixBlock(a_allocator);
+
+        alBufferData(buffer, AL_FORMAT_STEREO16, m_outputBuffer, OutputFrameCount * 2 * sizeof(int16_t), (ALsizei)m_outputRate);
+        alSourceQueueBuffers(m_outputSource, 1, &buffer);
+    }
 
-            const bool canLoop = buffer.Flags & 0b1 << AudioSourceBuffer::LoopBitOffset;
+    ALint state;
+    alGetSourcei(m_outputSource, AL_SOURCE_STATE, &state);
+    if (state != AL_PLAYING)
+    {
+        // Output ran dry before we got to it
+        m_underrunCount.fetch_add(1, std::memory_order_relaxed);
+
+        alSourcePlay(m_outputSource);
+    }
+}
+
+void AudioEngine::Run()
+{
+    // 128KB should be enough for anyone.
+    // Size is an educated guess based on the sample rate and sample size with several channels.
+    // Grows if a frame ever needs more so it is only a starting point.
+    // Just Ye' Ol' if allocation is too expensive just dont. It is that simple.
+    FrameAllocator allocator = FrameAllocator("Audio", 1024 * 128);
 
-            if (buffer.Flags & 0b1 << AudioSourceBuffer::PlayBitOffset)
+    m_masterBuffer = new float[OutputFrameCount * 2];
+    m_voiceBuffer = new float[OutputFrameCount * 2];
+    m_outputBuffer = new int16_t[OutputFrameCount * 2];
+
+    // Everything is mixed into a single stereo stream so OpenAL only ever sees one source no matter how many voices are playing
+    alGenSources(1, &m_outputSource);
+    alGenBuffers(OutputBufferCount, m_outputBuffers);
+
+    // Output is already spatialized so keep it on top of the listener
+    alSourcei(m_outputSource, AL_SOURCE_RELATIVE, AL_TRUE);
+    alSource3f(m_outputSource, AL_POSITION, 0.0f, 0.0f, 0.0f);
+
+    for (uint32_t i = 0; i < OutputBufferCount; ++i)
+    {
+        allocator.Reset();
+
+        MixBlock(&allocator);
+
+        alBufferData(m_outputBuffers[i], AL_FORMAT_STEREO16, m_outputBuffer, OutputFrameCount * 2 * sizeof(int16_t), (ALsizei)m_outputRate);
+    }
+
+    alSourceQueueBuffers(m_outputSource, OutputBufferCount, m_outputBuffers);
+    alSourcePlay(m_outputSource);
+
+    while (!m_shutdown)
+    {
+        const std::chrono::time_point start = std::chrono::high_resolution_clock::now();
+
+        {
+            Profiler::Start("Audio Thread");
+            IDEFER(Profiler::Stop());
+
+            allocator.Reset();
+
+            const ALenum error = alGetError();
+            if (error != AL_NO_ERROR)
             {
-                AudioClip* clip = m_audioClips[buffer.AudioClipAddr];
+                IWARN(std::string("OpenAL Error: ") + alGetString(error));
+            }
 
-                if (clip->GetChannelCount() == 0)
-                {
-                    continue;
-                }
+            {
+                PROFILESTACK("Commands");
 
-                if (buffer.Buffers[0] == -1)
+                AudioCommand command;
+                while (m_commands.TryPop(&command))
                 {
-                    alGenBuffers(AudioSourceBuffer::BufferCount, buffer.Buffers);                
+                    ProcessCommand(command);
                 }
+            }
 
-                // OpenAL does not seem to like restarting sources for some reason
-                // Probably just me but seems odd
-                if (buffer.Source != -1)
-                {
-                    alSourceStop(buffer.Source);
+            {
+                PROFILESTACK("Mix");
 
-                    alDeleteSources(1, &buffer.Source);
-                }
+                UpdateOutput(&allocator);
+            }
+        }
 
-                alGenSources(1, &buffer.Source);
+        std::this_thread::sleep_until(start + std::chrono::milliseconds(AudioThreadIntervalMs));
+    }
 
-                buffer.SampleOffset = FillBuffers(&allocator, buffer.Buffers, AudioSourceBuffer::BufferCount, clip, 0, AudioBufferSampleSize, canLoop);
+    // Flush anything left so sources and clips get cleaned up
+    AudioCommand command;
+    while (m_commands.TryPop(&command))
+    {
+        ProcessCommand(command);
+    }
 
-                alSourceQueueBuffers(buffer.Source, AudioSourceBuffer::BufferCount, buffer.Buffers);
+    alSourceStop(m_outputSource);
+    alDeleteSources(1, &m_outputSource);
+    alDeleteBuffers(OutputBufferCount, m_outputBuffers);
 
-                SetSourceTransform(buffer);
+    m_outputSource = 0;
 
-                if (buffer.AudioMixerAddr != -1)
-                {
-                    const AudioMixerBuffer& mixer = m_audioMixers[buffer.AudioMixerAddr];
+    const uint32_t voiceCount = m_voices.Size();
+    for (uint32_t i = 0; i < voiceCount; ++i)
+    {
+        AudioSourceVoice& voice = m_voices[i];
+        if (voice.Decoder != nullptr)
+        {
+            delete voice.Decoder;
+        }
+        if (voice.Staging != nullptr)
+        {
+            delete[] voice.Staging;
+        }
+    }
 
-                    alSourcef(buffer.Source, AL_GAIN, mixer.Gain);
-                }
-                else
-                {
-                    alSourcef(buffer.Source, AL_GAIN, 1.0f);
-                }
+    m_voices.Clear();
+
+    delete[] m_masterBuffer;
+    delete[] m_voiceBuffer;
+    delete[] m_outputBuffer;
+
+    TRACE("Audio Thread joining");
+}
+
+void AudioEngine::Update()
+{
+    if (m_device == NULL || m_context == NULL)
+    {
+        return;
+    }
 
-                alSourcePlay(buffer.Source);
+    {
+        PROFILESTACK("Finished Sources");
 
-                buffer.Flags &= ~(0b1 << AudioSourceBuffer::PlayBitOffset);
-                buffer.Flags |= (0b1 << AudioSourceBuffer::PlayingBitOffset);
+        AudioFinishedNotification notification;
+        while (m_finished.TryPop(&notification))
+        {
+            if (!m_audioSources.Exists(notification.Addr))
+            {
+                continue;
             }
-            else if (buffer.Flags & 0b1 << AudioSourceBuffer::PlayingBitOffset)
+
+            AudioSourceBuffer buffer = m_audioSources[notification.Addr];
+            // Source has been played again since so the notification is stale
+            if (buffer.PlayID != notification.PlayID)
             {
-                ALint processed;
-                alGetSourcei(buffer.Source, AL_BUFFERS_PROCESSED, &processed);
+                continue;
+            }
 
-                if (processed > 0)
-                {
-                    ALuint queueBuffer;
-                    alSourceUnqueueBuffers(buffer.Source, 1, &queueBuffer);
+            buffer.Flags &= ~(0b1 << AudioSourceBuffer::PlayingBitOffset);
+            m_audioSources.LockSet(notification.Addr, buffer);
+        }
+    }
 
-                    AudioClip* clip = m_audioClips[buffer.AudioClipAddr];
+    {
+        PROFILESTACK("Listener Update");
 
-                    buffer.SampleOffset = FillBuffers(&allocator, &queueBuffer, 1, clip, buffer.SampleOffset, AudioBufferSampleSize, canLoop);
+        const std::vector<bool> listenerState = m_audioListeners.ToStateVector();
+        TLockArray<AudioListenerBuffer> listenerBuffers = m_audioListeners.ToLockArray();
 
-                    alSourceQueueBuffers(buffer.Source, 1, &queueBuffer);
-                }
+        const uint32_t listenerBufferCount = (uint32_t)listenerState.size();
+        for (uint32_t i = 0; i < listenerBufferCount; ++i)
+        {
+            if (!listenerState[i])
+            {
+                continue;
+            }
 
-                SetSourceTransform(buffer);
+            const AudioListenerBuffer& buffer = listenerBuffers[i];
 
-                if (buffer.AudioMixerAddr != -1)
-                {
-                    const AudioMixerBuffer& mixer = m_audioMixers[buffer.AudioMixerAddr];
+            PushCommand(GetTransformCommand(AudioCommandType_SetListenerTransform, i, buffer.TransformAddr));
 
-                    alSourcef(buffer.Source, AL_GAIN, mixer.Gain);
-                }
-                else
-                {
-                    alSourcef(buffer.Source, AL_GAIN, 1.0f);
-                }
+            // To my knowledge, OpenAL only supports one listener so we can break here.
+            break;
+        }
+    }
 
-                if (!canLoop)
-                {
-                    ALint state;
-                    alGetSourcei(buffer.Source, AL_SOURCE_STATE, &state);
+    {
+        PROFILESTACK("Source Transforms");
 
-                    if (state == AL_STOPPED)
-                    {
-                        buffer.Flags &= ~(0b1 << AudioSourceBuffer::PlayingBitOffset);
-                    }
-                }
+        const std::vector<bool> sourceState = m_audioSources.ToStateVector();
+        TLockArray<AudioSourceBuffer> sourceBuffers = m_audioSources.ToLockArray();
+
+        const uint32_t sourceBufferCount = (uint32_t)sourceState.size();
+        for (uint32_t i = 0; i < sourceBufferCount; ++i)
+        {
+            if (!sourceState[i])
+            {
+                continue;
             }
+
+            const AudioSourceBuffer& buffer = sourceBuffers[i];
+            if (!(buffer.Flags & 0b1 << AudioSourceBuffer::PlayingBitOffset))
+            {
+                continue;
+            }
+
+            PushCommand(GetTransformCommand(AudioCommandType_SetTransform, i, buffer.TransformAddr));
         }
     }
 }
@@ -9,6 +9,7 @@
 #include "Audio/AudioEngine.h"
 #include "Core/IcarianAssert.h"
 #include "Core/IcarianDefer.h"
+#include "ObjectManager.h"
 #include "Runtime/RuntimeManager.h"
 #include "Trace.h"
 
@@ -23,10 +24,12 @@ static AudioEngineBindings* Instance = nullptr;
     F(uint32_t, IcarianEngine.Audio, AudioSource, GenerateAudioSource, { return Instance->GenerateAudioSource(a_transformAddr, a_clipAddr); }, uint32_t a_transformAddr, uint32_t a_clipAddr) \
     F(void, IcarianEngine.Audio, AudioSource, DestroyAudioSource, { Instance->DestroyAudioSource(a_addr); }, uint32_t a_addr) \
     F(void, IcarianEngine.Audio, AudioSource, PlayAudioSource, { Instance->PlayAudioSource(a_addr); }, uint32_t a_addr) \
+    F(void, IcarianEngine.Audio, AudioSource, StopAudioSource, { Instance->StopAudioSource(a_addr); }, uint32_t a_addr) \
     F(void, IcarianEngine.Audio, AudioSource, SetLoopAudioSource, { Instance->SetLoopAudioSource(a_addr, (bool)a_loop); }, uint32_t a_addr, uint32_t a_loop) \
     F(uint32_t, IcarianEngine.Audio, AudioSource, GetAudioSourcePlayingState, { return Instance->GetAudioSourcePlayingState(a_addr); }, uint32_t a_addr) \
     F(AudioSourceBuffer, IcarianEngine.Audio, AudioSource, GetAudioSourceBuffer, { return Instance->GetAudioSourceBuffer(a_addr); }, uint32_t a_addr) \
     F(void, IcarianEngine.Audio, AudioSource, SetAudioSourceBuffer, { Instance->SetAudioSourceBuffer(a_addr, a_buffer); }, uint32_t a_addr, AudioSourceBuffer a_buffer) \
+    F(uint32_t, IcarianEngine.Audio, AudioSource, GetAudioUnderrunCount, { return Instance->GetAudioUnderrunCount(); }) \
     \
     F(uint32_t, IcarianEngine.Audio, AudioMixer, GenerateAudioMixer, { return Instance->GenerateAudioMixer(); }) \
     F(void, IcarianEngine.Audio, AudioMixer, DestroyAudioMixer, { Instance->DestroyAudioMixer(a_addr); }, uint32_t a_addr) \
@@ -68,7 +71,19 @@ uint32_t AudioEngineBindings::GenerateAudioClipFromFile(const std::filesystem::p
 
     if (ext == ".ogg")
     {
-        return m_engine->m_audioClips.PushVal(new OGGAudioClip(a_path));
+        OGGAudioClip* clip = new OGGAudioClip(a_path);
+
+        // Short clips like sound effects are decoded up front so any number of voices can play them without decoding
+        const uint64_t decodedSize = clip->GetDecodedSize();
+        if (decodedSize > 0 && decodedSize <= AudioEngine::MaxPreDecodeSize && m_engine->ReserveCache(decodedSize))
+        {
+            if (!clip->PreDecode())
+            {
+                m_engine->ReleaseCache(decodedSize);
+            }
+        }
+
+        return m_engine->m_audioClips.PushVal(clip);
     }
     else if (ext == ".wav")
     {
@@ -83,9 +98,20 @@ void AudioEngineBindings::DestroyAudioClip(uint32_t a_addr) const
     ICARIAN_ASSERT_MSG(a_addr < m_engine->m_audioClips.Size(), "DestroyAudioClip out of bounds.");
     ICARIAN_ASSERT_MSG(m_engine->m_audioClips[a_addr] != nullptr, "DestroyAudioClip value does not exist.");
 
+    // Audio thread may still be reading from the clip so let it free it when it is done
+    AudioCommand command = { };
+    command.Type = AudioCommandType_DestroyClip;
+    command.Addr = a_addr;
+    if (m_engine->PushCommand(command))
+    {
+        return;
+    }
+
     const AudioClip* clip = m_engine->m_audioClips[a_addr];
     IDEFER(delete clip);
 
+    m_engine->ReleaseCache(clip->GetCachedSize());
+
     m_engine->m_audioClips.Erase(a_addr);
 }
 
@@ -121,13 +147,8 @@ uint32_t AudioEngineBindings::GenerateAudioSource(uint32_t a_transformAddr, uint
     buffer.TransformAddr = a_transformAddr;
     buffer.AudioClipAddr = a_clipAddr;
     buffer.AudioMixerAddr = -1;
-    buffer.SampleOffset = 0;
     buffer.Flags = 0;
-    for (uint32_t i = 0; i < AudioSourceBuffer::BufferCount; ++i)
-    {
-        buffer.Buffers[i] = -1;
-    }
-    buffer.Source = -1;
+    buffer.PlayID = 0;
 
     return m_engine->m_audioSources.PushVal(buffer);
 }
@@ -137,26 +158,34 @@ void AudioEngineBindings::DestroyAudioSource(uint32_t a_addr) const
     ICARIAN_ASSERT_MSG(a_addr < m_engine->m_audioSources.Size(), "DestroyAudioSource out of bounds.");
     ICARIAN_ASSERT_MSG(m_engine->m_audioSources.Exists(a_addr), "DestroyAudioSource value does not exist.");
 
-    const AudioSourceBuffer buffer = m_engine->m_audioSources[a_addr];
-    IDEFER(
-    {
-        alSourceStop(buffer.Source);
+    AudioCommand command = { };
+    command.Type = AudioCommandType_DestroySource;
+    command.Addr = a_addr;
+    m_engine->PushCommand(command);
 
-        for (uint32_t i = 0; i < AudioSourceBuffer::BufferCount; ++i)
-        {
-            if (buffer.Buffers[i] != -1)
-            {
-                alDeleteBuffers(1, &buffer.Buffers[i]);
-            }
-        }
+    m_engine->m_audioSources.Erase(a_addr);
+}
 
-        if (buffer.Source != -1)
-        {
-            alDeleteSources(1, &buffer.Source);
-        }
-    });
+void AudioEngineBindings::QueuePlay(uint32_t a_addr, AudioSourceBuffer* a_buffer) const
+{
+    a_buffer->Flags &= ~(0b1 << AudioSourceBuffer::PlayBitOffset);
 
-    m_engine->m_audioSources.Erase(a_addr);
+    const glm::mat4 transform = ObjectManager::GetGlobalMatrix(a_buffer->TransformAddr);
+
+    AudioCommand command = { };
+    command.Type = AudioCommandType_Play;
+    command.Addr = a_addr;
+    command.Value = a_buffer->AudioClipAddr;
+    command.PlayID = m_engine->m_playID.fetch_add(1, std::memory_order_relaxed) + 1;
+    command.Position = transform[3].xyz();
+    command.Forward = transform[2].xyz();
+    command.Up = -transform[1].xyz();
+
+    if (m_engine->PushCommand(command))
+    {
+        a_buffer->PlayID = command.PlayID;
+        a_buffer->Flags |= 0b1 << AudioSourceBuffer::PlayingBitOffset;
+    }
 }
 
 void AudioEngineBindings::PlayAudioSource(uint32_t a_addr) const
@@ -166,7 +195,22 @@ void AudioEngineBindings::PlayAudioSource(uint32_t a_addr) const
     ICARIAN_ASSERT_MSG(m_engine->m_audioSources.Exists(a_addr), "PlayAudioSource value does not exist.");
 
     AudioSourceBuffer buffer = m_engine->m_audioSources[a_addr];
-    buffer.Flags |= (0b1 << AudioSourceBuffer::PlayBitOffset);
+    QueuePlay(a_addr, &buffer);
+    m_engine->m_audioSources.LockSet(a_addr, buffer);
+}
+void AudioEngineBindings::StopAudioSource(uint32_t a_addr) const
+{
+    TRACE("Stopping AudioSource");
+    ICARIAN_ASSERT_MSG(a_addr < m_engine->m_audioSources.Size(), "StopAudioSource out of bounds.");
+    ICARIAN_ASSERT_MSG(m_engine->m_audioSources.Exists(a_addr), "StopAudioSource value does not exist.");
+
+    AudioCommand command = { };
+    command.Type = AudioCommandType_Stop;
+    command.Addr = a_addr;
+    m_engine->PushCommand(command);
+
+    AudioSourceBuffer buffer = m_engine->m_audioSources[a_addr];
+    buffer.Flags &= ~(0b1 << AudioSourceBuffer::PlayBitOffset | 0b1 << AudioSourceBuffer::PlayingBitOffset);
     m_engine->m_audioSources.LockSet(a_addr, buffer);
 }
 void AudioEngineBindings::SetLoopAudioSource(uint32_t a_addr, bool a_loop) const
@@ -184,6 +228,12 @@ void AudioEngineBindings::SetLoopAudioSource(uint32_t a_addr, bool a_loop) const
         buffer.Flags &= ~(0b1 << AudioSourceBuffer::LoopBitOffset);
     }
     m_engine->m_audioSources.LockSet(a_addr, buffer);
+
+    AudioCommand command = { };
+    command.Type = AudioCommandType_SetLoop;
+    command.Addr = a_addr;
+    command.Value = (uint32_t)a_loop;
+    m_engine->PushCommand(command);
 }
 bool AudioEngineBindings::GetAudioSourcePlayingState(uint32_t a_addr) const
 {
@@ -205,7 +255,49 @@ void AudioEngineBindings::SetAudioSourceBuffer(uint32_t a_addr, const AudioSourc
     ICARIAN_ASSERT_MSG(a_addr < m_engine->m_audioSources.Size(), "SetAudioSourceBuffer out of bounds.");
     ICARIAN_ASSERT_MSG(m_engine->m_audioSources.Exists(a_addr), "SetAudioSourceBuffer value does not exist.");
 
-    m_engine->m_audioSources.LockSet(a_addr, a_buffer);
+    const AudioSourceBuffer oldBuffer = m_engine->m_audioSources[a_addr];
+
+    // The runtime sets the whole buffer so work out what changed and forward it to the audio thread
+    AudioSourceBuffer buffer = a_buffer;
+    // Playing state and play id are owned by the engine
+    buffer.PlayID = oldBuffer.PlayID;
+    buffer.Flags = (buffer.Flags & ~(0b1 << AudioSourceBuffer::PlayingBitOffset)) | (oldBuffer.Flags & 0b1 << AudioSourceBuffer::PlayingBitOffset);
+
+    AudioCommand command = { };
+    command.Addr = a_addr;
+
+    if (buffer.AudioClipAddr != oldBuffer.AudioClipAddr)
+    {
+        command.Type = AudioCommandType_SetClip;
+        command.Value = buffer.AudioClipAddr;
+        m_engine->PushCommand(command);
+    }
+
+    if (buffer.AudioMixerAddr != oldBuffer.AudioMixerAddr)
+    {
+        command.Type = AudioCommandType_SetMixer;
+        command.Value = buffer.AudioMixerAddr;
+        m_engine->PushCommand(command);
+    }
+
+    const uint32_t loop = buffer.Flags & 0b1 << AudioSourceBuffer::LoopBitOffset;
+    if (loop != (oldBuffer.Flags & 0b1 << AudioSourceBuffer::LoopBitOffset))
+    {
+        command.Type = AudioCommandType_SetLoop;
+        command.Value = (uint32_t)(loop != 0);
+        m_engine->PushCommand(command);
+    }
+
+    if (buffer.Flags & 0b1 << AudioSourceBuffer::PlayBitOffset)
+    {
+        QueuePlay(a_addr, &buffer);
+    }
+
+    m_engine->m_audioSources.LockSet(a_addr, buffer);
+}
+uint32_t AudioEngineBindings::GetAudioUnderrunCount() const
+{
+    return m_engine->GetUnderrunCount();
 }
 
 uint32_t AudioEngineBindings::GenerateAudioMixer() const
@@ -213,8 +305,19 @@ uint32_t AudioEngineBindings::GenerateAudioMixer() const
     TRACE("Creating AudioMixer");
     AudioMixerBuffer buffer;
     buffer.Gain = 1.0f;
+    buffer.ParentAddr = uint32_t(-1);
+
+    const uint32_t addr = m_engine->m_audioMixers.PushVal(buffer);
 
-    return m_engine->m_audioMixers.PushVal(buffer);
+    // Address may be reused so make sure the audio thread is not holding onto an old bus
+    AudioCommand command = { };
+    command.Type = AudioCommandType_SetMixerBus;
+    command.Addr = addr;
+    command.Value = buffer.ParentAddr;
+    command.Gain = buffer.Gain;
+    m_engine->PushCommand(command);
+
+    return addr;
 }
 void AudioEngineBindings::DestroyAudioMixer(uint32_t a_addr) const
 {
@@ -223,6 +326,11 @@ void AudioEngineBindings::DestroyAudioMixer(uint32_t a_addr) const
     ICARIAN_ASSERT_MSG(m_engine->m_audioMixers.Exists(a_addr), "DestroyAudioMixer value does not exist.");
 
     m_engine->m_audioMixers.Erase(a_addr);
+
+    AudioCommand command = { };
+    command.Type = AudioCommandType_DestroyMixer;
+    command.Addr = a_addr;
+    m_engine->PushCommand(command);
 }
 AudioMixerBuffer AudioEngineBindings::GetAudioMixerBuffer(uint32_t a_addr) const
 {
@@ -237,6 +345,13 @@ void AudioEngineBindings::SetAudioMixerBuffer(uint32_t a_addr, const AudioMixerB
     ICARIAN_ASSERT_MSG(m_engine->m_audioMixers.Exists(a_addr), "SetAudioMixerBuffer value does not exist.");
 
     m_engine->m_audioMixers.LockSet(a_addr, a_buffer);
+
+    AudioCommand command = { };
+    command.Type = AudioCommandType_SetMixerBus;
+    command.Addr = a_addr;
+    command.Value = a_buffer.ParentAddr;
+    command.Gain = a_buffer.Gain;
+    m_engine->PushCommand(command);
 }
 
 uint32_t AudioEngineBindings::GenerateAudioListener(uint32_t a_transformAddr) const
@@ -54,6 +54,12 @@ Config::Config(const std::string_view& a_path)
 
                 break;
             }
+            case StringHash("AudioCacheSize"):
+            {
+                m_audioCacheSize = (uint32_t)element->IntText();
+
+                break;
+            }
             case StringHash("FixedTimeStep"):
             {
                 m_fixedTimeStep = element->DoubleText();
@@ -9,6 +9,15 @@
 
 #include <cstring>
 
+#ifdef WIN32
+#include "Core/WindowsHeaders.h"
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 #include "Core/IcarianDefer.h"
 #include "DataTypes/ThreadGuard.h"
 #include "IcarianError.h"
@@ -124,6 +133,76 @@ bool ReadFileHandle::EndOfFile() const
     return feof(m_file) != 0;
 }
 
+MappedFile::MappedFile(void* a_data, uint64_t a_size)
+{
+    m_data = a_data;
+    m_size = a_size;
+}
+MappedFile::~MappedFile()
+{
+#ifdef WIN32
+    UnmapViewOfFile(m_data);
+#else
+    munmap(m_data, (size_t)m_size);
+#endif
+}
+
+MappedFile* MappedFile::Open(const std::filesystem::path& a_path)
+{
+#ifdef WIN32
+    const HANDLE file = CreateFileW(a_path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return nullptr;
+    }
+    IDEFER(CloseHandle(file));
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart <= 0)
+    {
+        return nullptr;
+    }
+
+    const HANDLE mapping = CreateFileMappingW(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (mapping == NULL)
+    {
+        return nullptr;
+    }
+    // The view keeps the mapping alive
+    IDEFER(CloseHandle(mapping));
+
+    void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (data == NULL)
+    {
+        return nullptr;
+    }
+
+    return new MappedFile(data, (uint64_t)fileSize.QuadPart);
+#else
+    const int fd = open(a_path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return nullptr;
+    }
+    // The mapping keeps the file alive
+    IDEFER(close(fd));
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0)
+    {
+        return nullptr;
+    }
+
+    void* data = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED)
+    {
+        return nullptr;
+    }
+
+    return new MappedFile(data, (uint64_t)st.st_size);
+#endif
+}
+
 FileCache::FileCache(uint32_t a_sizeMiB)
 {
     m_size = (uint64_t)a_sizeMiB << MiBToByteShift;
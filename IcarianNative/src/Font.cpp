@@ -14,13 +14,16 @@
 
 #include "Core/Bitfield.h"
 #include "Core/IcarianDefer.h"
+#include "DataTypes/ThreadGuard.h"
 #include "FileCache.h"
 #include "IcarianError.h"
+#include "Rendering/UI/GlyphAtlas.h"
 #include "Trace.h"
 
 Font::Font(uint8_t* a_data)
 {
     m_data = a_data;
+    m_atlas = nullptr;
 
     const int offset = stbtt_GetFontOffsetForIndex(a_data, 0);
     if (stbtt_InitFont(&m_fontInfo, m_data, offset) == 0)
@@ -30,6 +33,11 @@ Font::Font(uint8_t* a_data)
 }
 Font::~Font()
 {
+    if (m_atlas != nullptr)
+    {
+        delete m_atlas;
+    }
+
     delete[] m_data;
 }
 
@@ -121,82 +129,17 @@ std::unordered_map<char32_t, CodePointTexture> GetTextures(const stbtt_fontinfo*
     return codePointTextures;
 }
 
-uint8_t* Font::StringToTexture(const std::u32string_view& a_string, float a_fontSize, uint32_t a_width, uint32_t a_height) const
+GlyphAtlas* Font::GetGlyphAtlas()
 {
-    // Changes have negative effects with small strings but alot faster with large strings with alot of repeating characters
-    // Worth it as small string are fast enough anyway
-    // Anyway the performance rat in me wants to use a chunk allocator but will hold off for now
-    const std::unordered_map<char32_t, CodePointTexture> codePointTextures = GetTextures(&m_fontInfo, a_fontSize, a_string);
-    IDEFER(
-    for (const auto iter : codePointTextures)
-    {
-        delete[] iter.second.Data;
-    });
-    
-    const float scale = stbtt_ScaleForPixelHeight(&m_fontInfo, a_fontSize);
+    // Distance field atlas is size independent so is created on first use and shared by all text using the font
+    const ThreadGuard g = ThreadGuard(m_atlasLock);
 
-    int ascent;
-    stbtt_GetFontVMetrics(&m_fontInfo, &ascent, NULL, NULL);
-
-    const uint32_t size = a_width * a_height;
-    uint8_t* tex = new uint8_t[size] { 0 };
-    
-    uint32_t xPos = 0;
-    uint32_t yPos = (uint32_t)(ascent * scale);
-    for (const char32_t codePoint : a_string)
+    if (m_atlas == nullptr)
     {
-        switch (codePoint) 
-        {
-        case '\n':
-        {
-            xPos = 0;
-            yPos += (uint32_t)(ascent * scale);
-
-            break;
-        }
-        case ' ':
-        {
-            const CodePointTexture& cpt = codePointTextures.at(codePoint);
-
-            xPos += (uint32_t)(cpt.Advance * scale);
-
-            break;
-        }
-        default:
-        {
-            const CodePointTexture& cpt = codePointTextures.at(codePoint);
-
-            for (uint32_t y = 0; y < cpt.Height; ++y)
-            {
-                const uint32_t cYPos = (uint32_t)(y + yPos + cpt.yOffset);
-                if (cYPos >= a_height)
-                {
-                    break;
-                }
-
-                for (uint32_t x = 0; x < cpt.Width; ++x)
-                {
-                    const uint32_t cXPos = x + xPos;
-                    if (cXPos >= a_width)
-                    {
-                        break;
-                    }
-
-                    const uint32_t index = x + (y * cpt.Width);
-                    const uint32_t cIndex = cXPos + (cYPos * a_width);
-
-                    tex[cIndex] = (uint8_t)glm::min((uint32_t)UINT8_MAX, cpt.Data[index] + (uint32_t)tex[cIndex]);
-                }
-            }
-
-            xPos += (uint32_t)(cpt.Advance * scale);
-
-            break;
-        }   
-        }        
+        m_atlas = new GlyphAtlas(&m_fontInfo);
     }
 
-    return tex;
+    return m_atlas;
 }
 
 constexpr float ISOValue = 10.0f;
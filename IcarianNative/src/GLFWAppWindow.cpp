@@ -284,6 +284,8 @@ void GLFWAppWindow::Update()
             UIControl::SubmitRelease((glm::vec2)cPos, (glm::vec2)winSize);
         }
 
+        UIControl::FlushEvents();
+
         inputManager->SetMouseButton(MouseButton_Left, leftDown);
         inputManager->SetMouseButton(MouseButton_Middle, glfwGetMouseButton(m_window, GLFW_MOUSE_BUTTON_MIDDLE) == GLFW_PRESS);
         inputManager->SetMouseButton(MouseButton_Right, glfwGetMouseButton(m_window, GLFW_MOUSE_BUTTON_RIGHT) == GLFW_PRESS);
@@ -0,0 +1,218 @@
+// Icarian Engine - C# Game Engine
+// 
+// License at end of file.
+
+#include "Rendering/UI/GlyphAtlas.h"
+
+#include <cstring>
+
+#include "Core/IcarianDefer.h"
+#include "Logger.h"
+#include "Rendering/RenderEngine.h"
+#include "Trace.h"
+
+GlyphAtlas::GlyphAtlas(const stbtt_fontinfo* a_fontInfo)
+{
+    TRACE("Creating GlyphAtlas");
+    m_fontInfo = a_fontInfo;
+    m_renderEngine = nullptr;
+
+    m_height = InitialAtlasHeight;
+    m_data = new uint8_t[AtlasWidth * m_height];
+    memset(m_data, 0, AtlasWidth * m_height);
+
+    m_shelfX = 0;
+    m_shelfY = 0;
+    m_shelfHeight = 0;
+
+    m_scale = stbtt_ScaleForPixelHeight(m_fontInfo, BaseFontSize);
+
+    int ascent;
+    stbtt_GetFontVMetrics(m_fontInfo, &ascent, NULL, NULL);
+    m_lineHeight = ascent * m_scale;
+
+    m_textureAddr = -1;
+    m_samplerAddr = -1;
+
+    m_dirty = true;
+
+    // Warm the printable ASCII range up front so most text never touches the atlas after the first upload
+    for (char32_t c = ' '; c <= '~'; ++c)
+    {
+        Rasterize(c);
+    }
+}
+GlyphAtlas::~GlyphAtlas()
+{
+    if (m_renderEngine != nullptr)
+    {
+        if (m_samplerAddr != -1)
+        {
+            m_renderEngine->DestroyTextureSampler(m_samplerAddr);
+        }
+        if (m_textureAddr != -1)
+        {
+            m_renderEngine->DestroyTexture(m_textureAddr);
+        }
+    }
+
+    delete[] m_data;
+}
+
+bool GlyphAtlas::Pack(uint32_t a_width, uint32_t a_height, uint32_t* a_x, uint32_t* a_y)
+{
+    const uint32_t width = a_width + GlyphPadding;
+    const uint32_t height = a_height + GlyphPadding;
+
+    if (width > AtlasWidth)
+    {
+        return false;
+    }
+
+    // Simple shelf packer glyphs at a single size are close enough in height that anything fancier is not worth it
+    if (m_shelfX + width > AtlasWidth)
+    {
+        m_shelfY += m_shelfHeight;
+        m_shelfX = 0;
+        m_shelfHeight = 0;
+    }
+
+    while (m_shelfY + height > m_height)
+    {
+        if (m_height >= MaxAtlasHeight)
+        {
+            return false;
+        }
+
+        // Width is fixed so growing is just appending rows and texel coordinates stay valid
+        const uint32_t newHeight = m_height * 2;
+        uint8_t* data = new uint8_t[AtlasWidth * newHeight];
+        memcpy(data, m_data, AtlasWidth * m_height);
+        memset(data + AtlasWidth * m_height, 0, AtlasWidth * (newHeight - m_height));
+
+        delete[] m_data;
+        m_data = data;
+        m_height = newHeight;
+    }
+
+    *a_x = m_shelfX;
+    *a_y = m_shelfY;
+
+    m_shelfX += width;
+    if (height > m_shelfHeight)
+    {
+        m_shelfHeight = height;
+    }
+
+    return true;
+}
+
+const GlyphInfo* GlyphAtlas::Rasterize(char32_t a_codepoint)
+{
+    int advance;
+    int lsb;
+    stbtt_GetCodepointHMetrics(m_fontInfo, (int)a_codepoint, &advance, &lsb);
+
+    int width = 0;
+    int height = 0;
+    int xOffset = 0;
+    int yOffset = 0;
+    // Returns null for glyphs with no outline eg. space
+    uint8_t* sdf = (uint8_t*)stbtt_GetCodepointSDF(m_fontInfo, m_scale, (int)a_codepoint, SDFSpread, SDFOnEdgeValue, SDFPixelDistScale, &width, &height, &xOffset, &yOffset);
+    IDEFER(stbtt_FreeSDF(sdf, NULL));
+
+    GlyphInfo info = 
+    {
+        .TexMin = glm::vec2(0.0f),
+        .TexMax = glm::vec2(0.0f),
+        .Offset = glm::vec2((float)xOffset, (float)yOffset),
+        .Size = glm::vec2(0.0f),
+        .Advance = advance * m_scale
+    };
+
+    if (sdf != nullptr && width > 0 && height > 0)
+    {
+        uint32_t x;
+        uint32_t y;
+        if (Pack((uint32_t)width, (uint32_t)height, &x, &y))
+        {
+            for (int i = 0; i < height; ++i)
+            {
+                memcpy(m_data + x + (y + i) * AtlasWidth, sdf + i * width, (size_t)width);
+            }
+
+            info.TexMin = glm::vec2((float)x, (float)y);
+            info.TexMax = glm::vec2((float)(x + width), (float)(y + height));
+            info.Size = glm::vec2((float)width, (float)height);
+
+            m_dirty = true;
+        }
+        else
+        {
+            // Still cache it so we only warn once and the glyph just advances the pen
+            Logger::Warning("GlyphAtlas full");
+        }
+    }
+
+    return &m_glyphs.emplace(a_codepoint, info).first->second;
+}
+
+const GlyphInfo* GlyphAtlas::GetGlyph(char32_t a_codepoint)
+{
+    const auto iter = m_glyphs.find(a_codepoint);
+    if (iter != m_glyphs.end())
+    {
+        return &iter->second;
+    }
+
+    return Rasterize(a_codepoint);
+}
+
+void GlyphAtlas::Flush(RenderEngine* a_renderEngine)
+{
+    if (!m_dirty)
+    {
+        return;
+    }
+
+    TRACE("Uploading GlyphAtlas");
+
+    if (m_samplerAddr != -1)
+    {
+        m_renderEngine->DestroyTextureSampler(m_samplerAddr);
+    }
+    if (m_textureAddr != -1)
+    {
+        m_renderEngine->DestroyTexture(m_textureAddr);
+    }
+
+    m_renderEngine = a_renderEngine;
+
+    m_textureAddr = m_renderEngine->GenerateTexture(AtlasWidth, m_height, TextureFormat_Alpha, m_data);
+    m_samplerAddr = m_renderEngine->GenerateTextureSampler(m_textureAddr, TextureMode_Texture, TextureFilter_Linear, TextureAddress_ClampToEdge);
+
+    m_dirty = false;
+}
+
+
+// MIT License
+// 
+// Copyright (c) 2024 River Govers
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
\ No newline at end of file
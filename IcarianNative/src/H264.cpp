@@ -355,7 +355,7 @@ namespace H264
 
         a_bitstream->Ignore(1);
 
-        a_bitstream->Ignore(a_bitstream->BitsLeft);
+        a_bitstream->Ignore(a_bitstream->BitsLeft());
 
         return sps;
     }
@@ -526,7 +526,7 @@ namespace H264
 
         a_bitstream->Ignore(1);
 
-        a_bitstream->Ignore(a_bitstream->BitsLeft);
+        a_bitstream->Ignore(a_bitstream->BitsLeft());
 
         return pps;
     }
@@ -7,9 +7,14 @@
 #define GLM_FORCE_SWIZZLE 
 #include <glm/glm.hpp>
 
+#include <cstring>
 #include <filesystem>
 #include <string>
 
+#ifndef WIN32
+#include <unistd.h>
+#endif
+
 #include "Application.h"
 #include "Core/IcarianAssert.h"
 #include "Core/IcarianDefer.h"
@@ -23,6 +28,17 @@ static std::string GetAddr(const std::string_view& a_addr)
 {
     return (std::filesystem::temp_directory_path() / a_addr).string();
 }
+static std::string GetFrameBufferName(uint32_t a_generation)
+{
+#if WIN32
+    const uint32_t pid = (uint32_t)GetCurrentProcessId();
+#else
+    const uint32_t pid = (uint32_t)getpid();
+#endif
+
+    // New name each time so the editor can keep its old mapping until it switches over
+    return "IcarianEngine-Frame-" + std::to_string(pid) + "-" + std::to_string(a_generation);
+}
 
 void HeadlessAppWindow::MessageCallback(const std::string_view& a_message, e_LoggerMessageType a_type)
 {
@@ -84,6 +100,14 @@ HeadlessAppWindow::HeadlessAppWindow(Application* a_app) : AppWindow(a_app)
 
     m_frameData = nullptr;
     m_unlockWindow = false;
+
+    m_frameBuffer = nullptr;
+    m_frameBufferGeneration = 0;
+    m_frameSlotSize = 0;
+    m_readSlot = -1;
+    m_readySlot = -1;
+    m_useFrameBuffer = false;
+    m_announceFrameBuffer = false;
     
     m_delta = 0.0;
     m_time = 0.0;
@@ -130,6 +154,12 @@ HeadlessAppWindow::~HeadlessAppWindow()
         m_frameData = nullptr;
     }
 
+    if (m_frameBuffer != nullptr)
+    {
+        delete m_frameBuffer;
+        m_frameBuffer = nullptr;
+    }
+
     delete Logger::CallbackFunc;
     Logger::CallbackFunc = nullptr;
     delete Profiler::CallbackFunc;
@@ -172,6 +202,42 @@ void HeadlessAppWindow::PushMessageQueue()
     }
 }
 
+void HeadlessAppWindow::CreateFrameBuffer()
+{
+    const uint32_t size = m_width * m_height * 4;
+    if (m_frameBuffer != nullptr && size <= m_frameSlotSize)
+    {
+        return;
+    }
+
+    if (m_frameBuffer != nullptr)
+    {
+        delete m_frameBuffer;
+        m_frameBuffer = nullptr;
+    }
+
+    m_readSlot = -1;
+    m_readySlot = -1;
+
+    // Rounded up to a page so growing the window a little does not recreate it every time
+    constexpr uint32_t PageSize = 4096;
+    m_frameSlotSize = (size + PageSize - 1) / PageSize * PageSize;
+
+    m_frameBuffer = IcarianCore::SharedMemory::Create(GetFrameBufferName(m_frameBufferGeneration++), (uint64_t)m_frameSlotSize * FrameSlotCount);
+    if (m_frameBuffer == nullptr)
+    {
+        IWARN("Failed to create shared frame buffer, falling back to sending frames over the pipe");
+
+        m_useFrameBuffer = false;
+        m_frameSlotSize = 0;
+        m_announceFrameBuffer = false;
+
+        return;
+    }
+
+    m_announceFrameBuffer = true;
+}
+
 bool HeadlessAppWindow::ShouldClose() const
 {
     return m_close || m_pipe == nullptr;
@@ -254,6 +320,35 @@ bool HeadlessAppWindow::PollMessage()
                 m_frameData = nullptr;
             }
 
+            // Waiting frame is the old size so drop it
+            m_readySlot = -1;
+
+            if (m_useFrameBuffer)
+            {
+                CreateFrameBuffer();
+            }
+
+            break;
+        }
+        case IcarianCore::PipeMessageType_RequestFrameBuffer:
+        {
+            const std::lock_guard g = std::lock_guard(m_fLock);
+
+            if (m_useFrameBuffer)
+            {
+                break;
+            }
+
+            m_useFrameBuffer = true;
+            CreateFrameBuffer();
+
+            // Frames go through the shared frame buffer from now on
+            if (m_frameBuffer != nullptr && m_frameData != nullptr)
+            {
+                delete[] m_frameData;
+                m_frameData = nullptr;
+            }
+
             break;
         }
         case IcarianCore::PipeMessageType_CursorPos:
@@ -341,6 +436,8 @@ void HeadlessAppWindow::Update()
         {
             return;
         }
+
+        UIControl::FlushEvents();
     }
 
     {
@@ -371,7 +468,51 @@ void HeadlessAppWindow::Update()
 
     {
         PROFILESTACK("Frame Data");
-        if (m_frameData != nullptr && m_unlockWindow)
+        if (m_frameBuffer != nullptr && m_unlockWindow)
+        {
+            const std::lock_guard g = std::lock_guard(m_fLock);
+
+            if (m_readySlot != -1)
+            {
+                m_unlockWindow = false;
+
+                // The editor is done with the old slot once it unlocks so it can be written to again
+                m_readSlot = m_readySlot;
+                m_readySlot = -1;
+
+                IcarianCore::FrameBufferInfo bufferInfo = { };
+                if (m_announceFrameBuffer)
+                {
+                    const std::string name = GetFrameBufferName(m_frameBufferGeneration - 1);
+                    strncpy(bufferInfo.Name, name.c_str(), IcarianCore::FrameBufferNameMax - 1);
+                    bufferInfo.SlotCount = FrameSlotCount;
+                    bufferInfo.SlotSize = m_frameSlotSize;
+                }
+
+                IcarianCore::FrameSlotInfo slotInfo;
+                slotInfo.Slot = m_readSlot;
+                slotInfo.Width = m_width;
+                slotInfo.Height = m_height;
+
+                const bool announced = !m_announceFrameBuffer || m_pipe->Send({ IcarianCore::PipeMessageType_FrameBuffer, sizeof(bufferInfo), (char*)&bufferInfo });
+                m_announceFrameBuffer = false;
+
+                if (!announced || !m_pipe->Send({ IcarianCore::PipeMessageType_PushFrameSlot, sizeof(slotInfo), (char*)&slotInfo }))
+                {
+                    m_close = true;
+
+                    delete m_pipe;
+                    m_pipe = nullptr;
+
+                    printf("Failed to send frame slot \n");
+
+                    assert(0);
+
+                    return;
+                }
+            }
+        }
+        else if (m_frameData != nullptr && m_unlockWindow)
         {
             m_unlockWindow = false;
 
@@ -417,22 +558,37 @@ void HeadlessAppWindow::PushFrameData(uint32_t a_width, uint32_t a_height, const
     (*(glm::dvec2*)msg.Data).y = a_time;
     m_queuedMessages.Push(msg);
 
-    // TODO: Implement a better way of doing this 
-    // Can end up ~32MiB which cannot keep up with a copy
-    // Assuming I can do maths ~6GiB/s so yeah not upto par
-    // Probably end up with a syncronised direct push at some point
     const std::lock_guard g = std::lock_guard(m_fLock);
-    if (m_width == a_width && m_height == a_height)
+    if (m_width != a_width || m_height != a_height)
     {
-        const uint32_t size = m_width * m_height * 4;
+        return;
+    }
+
+    const uint32_t size = m_width * m_height * 4;
 
-        if (m_frameData == nullptr)
+    // Goes straight from the mapped readback buffer into the slot the editor reads from
+    if (m_frameBuffer != nullptr)
+    {
+        uint32_t slot = 0;
+        while (slot == m_readSlot || slot == m_readySlot)
         {
-            m_frameData = new char[size];
+            ++slot;
         }
 
-        memcpy(m_frameData, a_buffer, size);
+        memcpy((char*)m_frameBuffer->GetData() + (uint64_t)slot * m_frameSlotSize, a_buffer, size);
+
+        // Replaces any frame that did not get sent in time
+        m_readySlot = slot;
+
+        return;
     }
+
+    if (m_frameData == nullptr)
+    {
+        m_frameData = new char[size];
+    }
+
+    memcpy(m_frameData, a_buffer, size);
 }
 
 // MIT License
@@ -5,16 +5,15 @@
 #include "Physics/IcContactListener.h"
 
 #include "Physics/PhysicsEngine.h"
-#include "Runtime/RuntimeFunction.h"
 #include "Runtime/RuntimeManager.h"
 
 IcContactListener::IcContactListener(PhysicsEngine* a_engine)
 {
     m_engine = a_engine;
 
-    m_onCollisionEnterFunc = RuntimeManager::GetFunction("IcarianEngine.Physics", "PhysicsBody", ":OnCollisionEnter");
-    m_onCollisionStayFunc = RuntimeManager::GetFunction("IcarianEngine.Physics", "PhysicsBody", ":OnCollisionStay");
-    m_onCollisionExitFunc = RuntimeManager::GetFunction("IcarianEngine.Physics", "PhysicsBody", ":OnCollisionExit");
+    m_onCollisionEnterFunc = RuntimeManager::GetThunk<CollisionDataBuffer*>("IcarianEngine.Physics", "PhysicsBody", ":OnCollisionEnter");
+    m_onCollisionStayFunc = RuntimeManager::GetThunk<CollisionDataBuffer*>("IcarianEngine.Physics", "PhysicsBody", ":OnCollisionStay");
+    m_onCollisionExitFunc = RuntimeManager::GetThunk<CollisionDataBuffer*>("IcarianEngine.Physics", "PhysicsBody", ":OnCollisionExit");
 }
 IcContactListener::~IcContactListener()
 {
@@ -44,12 +43,7 @@ void IcContactListener::OnContactAdded(const JPH::Body& a_lhs, const JPH::Body&
         .Depth = (float)a_manifold.mPenetrationDepth
     };
 
-    void* args[] =
-    {
-        &data
-    };
-
-    m_onCollisionEnterFunc->Exec(args);
+    m_onCollisionEnterFunc->Exec(&data);
 }
 void IcContactListener::OnContactPersisted(const JPH::Body& a_lhs, const JPH::Body& a_rhs, const JPH::ContactManifold& a_manifold, JPH::ContactSettings& a_ioSettings)
 {
@@ -66,12 +60,7 @@ void IcContactListener::OnContactPersisted(const JPH::Body& a_lhs, const JPH::Bo
         .Depth = (float)a_manifold.mPenetrationDepth
     };
 
-    void* args[] =
-    {
-        &data
-    };
-
-    m_onCollisionStayFunc->Exec(args);
+    m_onCollisionStayFunc->Exec(&data);
 }
 void IcContactListener::OnContactRemoved(const JPH::SubShapeIDPair& a_shapePair)
 {
@@ -80,12 +69,7 @@ void IcContactListener::OnContactRemoved(const JPH::SubShapeIDPair& a_shapePair)
     data.BodyAddrA = (uint32_t)m_engine->GetBodyAddr(a_shapePair.GetBody1ID().GetIndex());
     data.BodyAddrB = (uint32_t)m_engine->GetBodyAddr(a_shapePair.GetBody2ID().GetIndex());
 
-    void* args[] =
-    {
-        &data
-    };
-
-    m_onCollisionExitFunc->Exec(args);
+    m_onCollisionExitFunc->Exec(&data);
 }
 
 // MIT License
@@ -6,14 +6,18 @@
 
 #include "AI/NavigationBindings.h"
 #include "AI/NavigationMesh.h"
+#include "AI/NavigationPathQueue.h"
 
 Navigation::Navigation()
 {
     m_bindings = new NavigationBindings(this);
+    m_pathQueue = new NavigationPathQueue(this);
 }
 Navigation::~Navigation()
 {
     delete m_bindings;
+    // Need to wait for outstanding requests before the meshes go
+    delete m_pathQueue;
 
     for (uint32_t i = 0; i < m_meshes.Size(); ++i)
     {
@@ -25,6 +29,11 @@ Navigation::~Navigation()
     }
 }
 
+void Navigation::Update()
+{
+    m_pathQueue->Update();
+}
+
 // MIT License
 // 
 // Copyright (c) 2024 River Govers
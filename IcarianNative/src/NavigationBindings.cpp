@@ -6,13 +6,16 @@
 
 #include "AI/Navigation.h"
 #include "AI/NavigationMesh.h"
+#include "AI/NavigationPathQueue.h"
 #include "IcarianError.h"
 #include "Runtime/RuntimeManager.h"
 
 static NavigationBindings* Instance = nullptr;
 
+#include "EngineNavigationInterop.h"
 #include "EngineNavigationMeshInterop.h"
 
+ENGINE_NAVIGATION_EXPORT_TABLE(RUNTIME_FUNCTION_DEFINITION);
 ENGINE_NAVIGATIONMESH_EXPORT_TABLE(RUNTIME_FUNCTION_DEFINITION);
 
 RUNTIME_FUNCTION(MonoArray*, Navigation, GetPath, 
@@ -32,6 +35,7 @@ NavigationBindings::NavigationBindings(Navigation* a_navigation)
 {
     m_navigation = a_navigation;
     
+    ENGINE_NAVIGATION_EXPORT_TABLE(RUNTIME_FUNCTION_ATTACH);
     ENGINE_NAVIGATIONMESH_EXPORT_TABLE(RUNTIME_FUNCTION_ATTACH);
 
     BIND_FUNCTION(IcarianEngine.AI, Navigation, GetPath);
@@ -58,6 +62,10 @@ void NavigationBindings::DestroyNavMesh(uint32_t a_addr) const
     IDEFER(delete mesh);
     m_navigation->m_meshes.Erase(a_addr);
 }
+bool NavigationBindings::BakeNavMesh(const std::filesystem::path& a_modelPath, const std::filesystem::path& a_cookedPath) const
+{
+    return NavigationMesh::Bake(a_modelPath, a_cookedPath);
+}
 Array<glm::vec3> NavigationBindings::GetNavMeshPath(uint32_t a_addr, const glm::vec3& a_startPoint, const glm::vec3& a_endPoint, float a_agentRadius) const
 {
     IVERIFY(a_addr < m_navigation->m_meshes.Size());
@@ -98,6 +106,30 @@ Array<glm::vec3> NavigationBindings::GetNavigationPath(const glm::vec3& a_startP
     return Array<glm::vec3>();
 }
 
+uint32_t NavigationBindings::RequestNavMeshPath(uint32_t a_addr, const glm::vec3& a_startPoint, const glm::vec3& a_endPoint, float a_agentRadius) const
+{
+    IVERIFY(a_addr < m_navigation->m_meshes.Size());
+    IVERIFY(m_navigation->m_meshes.Exists(a_addr));
+
+    return m_navigation->m_pathQueue->PushRequest(a_addr, a_startPoint, a_endPoint, a_agentRadius);
+}
+uint32_t NavigationBindings::RequestNavigationPath(const glm::vec3& a_startPoint, const glm::vec3& a_endPoint, float a_agentRadius) const
+{
+    return m_navigation->m_pathQueue->PushRequest(-1, a_startPoint, a_endPoint, a_agentRadius);
+}
+e_PathRequestState NavigationBindings::GetPathRequestState(uint32_t a_addr) const
+{
+    return m_navigation->m_pathQueue->GetState(a_addr);
+}
+Array<glm::vec3> NavigationBindings::TakePathRequestPath(uint32_t a_addr) const
+{
+    return m_navigation->m_pathQueue->TakePath(a_addr);
+}
+void NavigationBindings::DestroyPathRequest(uint32_t a_addr) const
+{
+    m_navigation->m_pathQueue->DestroyRequest(a_addr);
+}
+
 // MIT License
 // 
 // Copyright (c) 2024 River Govers
@@ -4,6 +4,8 @@
 
 #include "AI/NavigationMesh.h"
 
+#include <algorithm>
+#include <cmath>
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
@@ -15,234 +17,694 @@
 #include "IcarianError.h"
 #include "Trace.h"
 
-NavigationMesh::NavigationMesh(const std::filesystem::path& a_path)
+// Cooked nav mesh layout
+// Header, vertices, faces, grid cell offsets then grid faces
+// Everything is 4 byte aligned so the arrays can be used straight out of the mapped file
+struct NavigationMeshHeader
 {
+    static constexpr uint32_t MagicValue = 0x564E4349; // ICNV
+    static constexpr uint32_t VersionValue = 1;
+
+    uint32_t Magic;
+    uint32_t Version;
+    uint32_t VertexCount;
+    uint32_t FaceCount;
+    glm::vec2 GridMin;
+    float GridInvCellSize;
+    uint32_t GridWidth;
+    uint32_t GridHeight;
+    uint32_t GridFaceCount;
+};
+
+static_assert(sizeof(NavigationFace) % 4 == 0);
+
+NavigationMesh::NavigationMesh()
+{
+    m_mappedFile = nullptr;
+
     m_vertexCount = 0;
     m_vertices = nullptr;
     m_faceCount = 0;
     m_faces = nullptr;
 
+    m_gridMin = glm::vec2(0.0f);
+    m_gridInvCellSize = 0.0f;
+    m_gridWidth = 0;
+    m_gridHeight = 0;
+    m_gridCellOffsets = nullptr;
+    m_gridFaceCount = 0;
+    m_gridFaces = nullptr;
+}
+NavigationMesh::NavigationMesh(const std::filesystem::path& a_path) : NavigationMesh()
+{
     TRACE("Creating Nav Mesh");
     const std::filesystem::path ext = a_path.extension();
     const std::string extStr = ext.string();
 
     switch (StringHash<uint32_t>(extStr.c_str()))
     {
+    case StringHash<uint32_t>(CookedExtension):
+    {
+        if (!LoadCooked(a_path))
+        {
+            IERROR("Failed loading cooked nav mesh: " + a_path.string());
+        }
+
+        break;
+    }
     case StringHash<uint32_t>(".obj"):
     case StringHash<uint32_t>(".dae"):
     case StringHash<uint32_t>(".fbx"):
     case StringHash<uint32_t>(".glb"):
     case StringHash<uint32_t>(".gltf"):
     {
-        FileHandle* handle = FileCache::LoadFile(a_path);
-        IVERIFY(handle != nullptr);
-        IDEFER(delete handle);
-
-        const uint64_t size = handle->GetSize();
-        uint8_t* dat = new uint8_t[size];
-        IDEFER(delete[] dat);
-        if (handle->Read(dat, size) != size)
+        std::filesystem::path cookedPath = a_path;
+        cookedPath.replace_extension(CookedExtension);
+
+        // Only trust the cooked file if it was baked after the model was last touched
+        std::error_code cookedErr;
+        std::error_code modelErr;
+        const std::filesystem::file_time_type cookedTime = std::filesystem::last_write_time(cookedPath, cookedErr);
+        const std::filesystem::file_time_type modelTime = std::filesystem::last_write_time(a_path, modelErr);
+        if (!cookedErr && (modelErr || cookedTime >= modelTime))
         {
-            IERROR("Failed reading mesh data: " + a_path.string());
+            if (LoadCooked(cookedPath))
+            {
+                break;
+            }
 
-            break;
+            IWARN("Invalid cooked nav mesh falling back to model: " + cookedPath.string());
         }
 
-        Assimp::Importer importer;
-
-        const aiScene* scene = importer.ReadFileFromMemory(dat, (size_t)size, aiProcess_Triangulate | aiProcess_PreTransformVertices, extStr.c_str() + 1);
-        IVERIFY(scene != nullptr);
-        if (scene->mNumMeshes <= 0)
+        if (LoadModel(a_path))
         {
-            break;
+            BuildSpatialGrid();
         }
 
-        struct EdgeTable
-        {
-            uint32_t Index[2];
-            uint32_t Edge[2];  
-        };
+        break;
+    }
+    default:
+    {
+        IERROR("Invalid model file extension: " + a_path.string());
 
-        std::unordered_map<uint64_t, EdgeTable> edgeMap;
-        
-        const aiMesh* mesh = scene->mMeshes[0];
+        break;
+    }
+    }
+}
+NavigationMesh::~NavigationMesh()
+{
+    if (m_mappedFile != nullptr)
+    {
+        delete m_mappedFile;
+
+        return;
+    }
+
+    if (m_vertices != nullptr)
+    {
+        delete[] m_vertices;
+    }
+
+    if (m_faces != nullptr)
+    {
+        delete[] m_faces;
+    }
+
+    if (m_gridCellOffsets != nullptr)
+    {
+        delete[] m_gridCellOffsets;
+    }
+
+    if (m_gridFaces != nullptr)
+    {
+        delete[] m_gridFaces;
+    }
+}
+
+bool NavigationMesh::Bake(const std::filesystem::path& a_modelPath, const std::filesystem::path& a_cookedPath)
+{
+    TRACE("Baking Nav Mesh");
+
+    NavigationMesh mesh;
+    if (!mesh.LoadModel(a_modelPath))
+    {
+        IERROR("Failed baking nav mesh: " + a_modelPath.string());
+
+        return false;
+    }
 
-        const uint32_t vertexCount = (uint32_t)mesh->mNumVertices;
+    mesh.BuildSpatialGrid();
 
-        glm::vec3* vertices = new glm::vec3[vertexCount];
-        IDEFER(delete[] vertices);
+    if (!mesh.WriteCooked(a_cookedPath))
+    {
+        IERROR("Failed writing cooked nav mesh: " + a_cookedPath.string());
+
+        return false;
+    }
 
-        uint32_t* vertexMap = new uint32_t[vertexCount];
-        IDEFER(delete[] vertexMap);
-        memset(vertexMap, -1, vertexCount * sizeof(uint32_t));
+    return true;
+}
 
-        const uint32_t faceCount = (uint32_t)mesh->mNumFaces;
+bool NavigationMesh::LoadModel(const std::filesystem::path& a_path)
+{
+    const std::filesystem::path ext = a_path.extension();
+    const std::string extStr = ext.string();
 
-        NavigationFace* faces = new NavigationFace[faceCount];
-        IDEFER(delete[] faces);
+    switch (StringHash<uint32_t>(extStr.c_str()))
+    {
+    case StringHash<uint32_t>(".obj"):
+    case StringHash<uint32_t>(".dae"):
+    case StringHash<uint32_t>(".fbx"):
+    case StringHash<uint32_t>(".glb"):
+    case StringHash<uint32_t>(".gltf"):
+    {
+        break;
+    }
+    default:
+    {
+        IERROR("Invalid model file extension: " + a_path.string());
 
-        // First pass load in the model data and cull faces pointing down as they will not be navigable so no point having them in the nav mesh
-        // Cannot guarantee normals so we calculate them ourselves
-        for (uint32_t i = 0; i < faceCount; ++i)
+        return false;
+    }
+    }
+
+    FileHandle* handle = FileCache::LoadFile(a_path);
+    if (handle == nullptr)
+    {
+        IERROR("Failed opening mesh file: " + a_path.string());
+
+        return false;
+    }
+    IDEFER(delete handle);
+
+    const uint64_t size = handle->GetSize();
+    uint8_t* dat = new uint8_t[size];
+    IDEFER(delete[] dat);
+    if (handle->Read(dat, size) != size)
+    {
+        IERROR("Failed reading mesh data: " + a_path.string());
+
+        return false;
+    }
+
+    Assimp::Importer importer;
+
+    const aiScene* scene = importer.ReadFileFromMemory(dat, (size_t)size, aiProcess_Triangulate | aiProcess_PreTransformVertices, extStr.c_str() + 1);
+    IVERIFY(scene != nullptr);
+    if (scene == nullptr || scene->mNumMeshes <= 0)
+    {
+        return false;
+    }
+
+    // Shared edges are found by sorting instead of hashing as it is a lot faster on large meshes
+    struct EdgeEntry
+    {
+        uint64_t Key;
+        uint32_t Face;
+        uint32_t Edge;
+    };
+
+    const aiMesh* mesh = scene->mMeshes[0];
+
+    const uint32_t vertexCount = (uint32_t)mesh->mNumVertices;
+    const uint32_t faceCount = (uint32_t)mesh->mNumFaces;
+
+    // Sized for the worst case and written into directly to avoid copying after culling
+    m_vertices = new glm::vec3[vertexCount];
+    m_faces = new NavigationFace[faceCount];
+
+    uint32_t* vertexMap = new uint32_t[vertexCount];
+    IDEFER(delete[] vertexMap);
+    memset(vertexMap, -1, vertexCount * sizeof(uint32_t));
+
+    EdgeEntry* edges = new EdgeEntry[faceCount * 3];
+    IDEFER(delete[] edges);
+    uint32_t edgeCount = 0;
+
+    // First pass load in the model data and cull faces pointing down as they will not be navigable so no point having them in the nav mesh
+    // Cannot guarantee normals so we calculate them ourselves
+    for (uint32_t i = 0; i < faceCount; ++i)
+    {
+        const aiFace& face = mesh->mFaces[i];
+        
+        glm::vec3 positions[3];
+        for (uint32_t j = 0; j < 3; ++j)
         {
-            const aiFace& face = mesh->mFaces[i];
-            
-            glm::vec3 positions[3];
-            for (uint32_t j = 0; j < 3; ++j)
-            {
-                const uint32_t index = face.mIndices[j];
+            const uint32_t index = face.mIndices[j];
 
-                const aiVector3D& pos = mesh->mVertices[index];
-                positions[j] = glm::vec3(pos.x, -pos.y, pos.z);
-            }
+            const aiVector3D& pos = mesh->mVertices[index];
+            positions[j] = glm::vec3(pos.x, -pos.y, pos.z);
+        }
+
+        const glm::vec3 dirA = positions[0] - positions[1];
+        const glm::vec3 dirB = positions[0] - positions[2];
+        const glm::vec3 norm = glm::cross(dirB, dirA);
+
+        const float dot = glm::dot(norm, glm::vec3(0.0f, -1.0f, 0.0f));
+        if (dot <= 0.0f)
+        {
+            continue;
+        }
 
-            const glm::vec3 dirA = positions[0] - positions[1];
-            const glm::vec3 dirB = positions[0] - positions[2];
-            const glm::vec3 norm = glm::cross(dirB, dirA);
+        const glm::vec3 center = (positions[0] + positions[1] + positions[2]) * 0.33f;
+        NavigationFace navFace =
+        {
+            .Connections = { uint32_t(-1), uint32_t(-1), uint32_t(-1) },
+            .Center = center,
+            .Dot = dot
+        };
 
-            const float dot = glm::dot(norm, glm::vec3(0.0f, -1.0f, 0.0f));
-            if (dot <= 0.0f)
+        for (uint32_t j = 0; j < 3; ++j)
+        {
+            const uint32_t index = face.mIndices[j];
+            const uint32_t vMapIndex = vertexMap[index];
+            if (vMapIndex != -1)
             {
+                navFace.Indicies[j] = vMapIndex;
+                
                 continue;
             }
+            
+            navFace.Indicies[j] = m_vertexCount;
+            vertexMap[index] = m_vertexCount;
+            m_vertices[m_vertexCount++] = positions[j];
+        }
 
-            const glm::vec3 center = (positions[0] + positions[1] + positions[2]) * 0.33f;
-            NavigationFace navFace =
+        for (uint32_t j = 0; j < 3; ++j)
+        {
+            const uint32_t index = navFace.Indicies[j];
+            const uint32_t nextIndex = navFace.Indicies[(j + 1) % 3];
+
+            const uint32_t indexA = glm::min(index, nextIndex);
+            const uint32_t indexB = glm::max(index, nextIndex);
+
+            edges[edgeCount++] = 
             {
-                .Connections = { uint32_t(-1), uint32_t(-1), uint32_t(-1) },
-                .Center = center,
-                .Dot = dot
+                .Key = (uint64_t)indexA << 32 | (uint64_t)indexB,
+                .Face = m_faceCount,
+                .Edge = j
             };
+        }
 
-            for (uint32_t j = 0; j < 3; ++j)
-            {
-                const uint32_t index = face.mIndices[j];
-                const uint32_t vMapIndex = vertexMap[index];
-                if (vMapIndex != -1)
-                {
-                    navFace.Indicies[j] = vMapIndex;
-                    
-                    continue;
-                }
-                
-                navFace.Indicies[j] = m_vertexCount;
-                vertexMap[index] = m_vertexCount;
-                vertices[m_vertexCount++] = positions[j];
-            }
+        m_faces[m_faceCount++] = navFace;
+    }
 
-            for (uint32_t j = 0; j < 3; ++j)
-            {
-                const uint32_t index = navFace.Indicies[j];
-                const uint32_t nextIndex = navFace.Indicies[(j + 1) % 3];
+    std::sort(edges, edges + edgeCount, [](const EdgeEntry& a_lhs, const EdgeEntry& a_rhs)
+    {
+        return a_lhs.Key < a_rhs.Key;
+    });
 
-                uint32_t indexA;
-                uint32_t indexB;
-                if (index < nextIndex)
-                {
-                    indexA = index;
-                    indexB = nextIndex;
-                }
-                else
-                {
-                    indexA = nextIndex;
-                    indexB = index;
-                }
+    // Second pass we want to link all the face connections
+    // Matching edges end up next to each other after sorting
+    for (uint32_t i = 1; i < edgeCount; ++i)
+    {
+        const EdgeEntry& edgeA = edges[i - 1];
+        const EdgeEntry& edgeB = edges[i];
 
-                const uint64_t key = (uint64_t)indexA << 31 | (uint64_t)indexB;
-                const auto iter = edgeMap.find(key);
-                if (iter != edgeMap.end())
-                {
-                    iter->second.Edge[1] = j;
-                    iter->second.Index[1] = m_faceCount;
+        if (edgeA.Key != edgeB.Key)
+        {
+            continue;
+        }
 
-                    continue;
-                }
+        m_faces[edgeA.Face].Connections[edgeA.Edge] = edgeB.Face;
+        m_faces[edgeB.Face].Connections[edgeB.Edge] = edgeA.Face;
 
-                const EdgeTable table = 
-                {
-                    .Index = { m_faceCount, uint32_t(-1) },
-                    .Edge = { j, uint32_t(-1) },
-                };
+        ++i;
+    }
 
-                edgeMap.emplace(key, table);
-            }
+    return true;
+}
 
-            faces[m_faceCount++] = navFace;
-        }
+bool NavigationMesh::ValidateCooked(const NavigationMeshHeader* a_header, const uint8_t* a_faces, const uint8_t* a_cellOffsets, const uint8_t* a_gridFaces)
+{
+    const uint32_t vertexCount = a_header->VertexCount;
+    const uint32_t faceCount = a_header->FaceCount;
 
-        // Second pass we want to link all the face connections
-        for (const auto iter : edgeMap)
+    const NavigationFace* faces = (const NavigationFace*)a_faces;
+    for (uint32_t i = 0; i < faceCount; ++i)
+    {
+        const NavigationFace& face = faces[i];
+        for (uint32_t j = 0; j < 3; ++j)
         {
-            const EdgeTable table = iter.second;
-
-            const uint32_t indexA = table.Index[0];
-            const uint32_t indexB = table.Index[1];
+            if (face.Indicies[j] >= vertexCount)
+            {
+                return false;
+            }
 
-            if (indexA == -1 || indexB == -1)
+            if (face.Connections[j] != -1 && face.Connections[j] >= faceCount)
             {
-                continue;
+                return false;
             }
+        }
+    }
+
+    if (faceCount <= 0)
+    {
+        return true;
+    }
+
+    if (a_header->GridWidth <= 0 || a_header->GridWidth > MaxGridDimension || a_header->GridHeight <= 0 || a_header->GridHeight > MaxGridDimension)
+    {
+        return false;
+    }
+    if (!std::isfinite(a_header->GridInvCellSize) || a_header->GridInvCellSize <= 0.0f || !std::isfinite(a_header->GridMin.x) || !std::isfinite(a_header->GridMin.y))
+    {
+        return false;
+    }
+
+    // Offsets have to walk forward through the grid faces and finish exactly at the end
+    const uint32_t cellCount = a_header->GridWidth * a_header->GridHeight;
+    const uint32_t* cellOffsets = (const uint32_t*)a_cellOffsets;
+    if (cellOffsets[0] != 0 || cellOffsets[cellCount] != a_header->GridFaceCount)
+    {
+        return false;
+    }
+    for (uint32_t i = 0; i < cellCount; ++i)
+    {
+        if (cellOffsets[i] > cellOffsets[i + 1])
+        {
+            return false;
+        }
+    }
 
-            faces[indexA].Connections[table.Edge[0]] = indexB;
-            faces[indexB].Connections[table.Edge[1]] = indexA;
+    const uint32_t* gridFaces = (const uint32_t*)a_gridFaces;
+    for (uint32_t i = 0; i < a_header->GridFaceCount; ++i)
+    {
+        if (gridFaces[i] >= faceCount)
+        {
+            return false;
         }
+    }
 
-        m_vertices = new glm::vec3[m_vertexCount];
-        std::copy(vertices, vertices + m_vertexCount, m_vertices);
-        m_faces = new NavigationFace[m_faceCount];
-        std::copy(faces, faces + m_faceCount, m_faces);
+    return true;
+}
 
-        break;
+bool NavigationMesh::LoadCooked(const std::filesystem::path& a_path)
+{
+    TRACE("Mapping Cooked Nav Mesh");
+
+    MappedFile* file = MappedFile::Open(a_path);
+    if (file == nullptr)
+    {
+        return false;
     }
-    default:
+
+    const uint64_t size = file->GetSize();
+    if (size < sizeof(NavigationMeshHeader))
     {
-        IERROR("Invalid model file extension: " + a_path.string());
+        delete file;
 
-        break;
+        return false;
+    }
+
+    const uint8_t* data = (const uint8_t*)file->GetData();
+
+    const NavigationMeshHeader* header = (const NavigationMeshHeader*)data;
+    if (header->Magic != NavigationMeshHeader::MagicValue || header->Version != NavigationMeshHeader::VersionValue)
+    {
+        IWARN("Cooked nav mesh version mismatch: " + a_path.string());
+        delete file;
+
+        return false;
+    }
+
+    const uint64_t cellCount = (uint64_t)header->GridWidth * header->GridHeight;
+
+    const uint64_t vertexOffset = sizeof(NavigationMeshHeader);
+    const uint64_t faceOffset = vertexOffset + header->VertexCount * sizeof(glm::vec3);
+    const uint64_t cellOffset = faceOffset + header->FaceCount * sizeof(NavigationFace);
+    const uint64_t gridFaceOffset = cellOffset + (header->FaceCount > 0 ? (cellCount + 1) * sizeof(uint32_t) : 0);
+    const uint64_t endOffset = gridFaceOffset + header->GridFaceCount * sizeof(uint32_t);
+    if (endOffset > size)
+    {
+        IWARN("Cooked nav mesh truncated: " + a_path.string());
+        delete file;
+
+        return false;
+    }
+
+    // Indices are used without bounds checks at runtime so a stale or corrupt file has to be caught here
+    if (!ValidateCooked(header, data + faceOffset, data + cellOffset, data + gridFaceOffset))
+    {
+        IWARN("Cooked nav mesh corrupt: " + a_path.string());
+        delete file;
+
+        return false;
     }
+
+    m_mappedFile = file;
+
+    uint8_t* bytes = (uint8_t*)data;
+
+    m_vertexCount = header->VertexCount;
+    m_vertices = (glm::vec3*)(bytes + vertexOffset);
+    m_faceCount = header->FaceCount;
+    m_faces = (NavigationFace*)(bytes + faceOffset);
+
+    // Empty meshes do not have a grid and GetIndex relies on the offsets being null to early out
+    if (m_faceCount > 0)
+    {
+        m_gridMin = header->GridMin;
+        m_gridInvCellSize = header->GridInvCellSize;
+        m_gridWidth = header->GridWidth;
+        m_gridHeight = header->GridHeight;
+        m_gridCellOffsets = (uint32_t*)(bytes + cellOffset);
+        m_gridFaceCount = header->GridFaceCount;
+        m_gridFaces = (uint32_t*)(bytes + gridFaceOffset);
     }
+
+    return true;
 }
-NavigationMesh::~NavigationMesh()
+
+bool NavigationMesh::WriteCooked(const std::filesystem::path& a_path) const
 {
-    if (m_vertices != nullptr)
+    const std::string str = a_path.string();
+
+    FILE* fp = fopen(str.c_str(), "wb");
+    if (fp == NULL)
     {
-        delete[] m_vertices;
+        return false;
     }
+    IDEFER(fclose(fp));
 
-    if (m_faces != nullptr)
+    const NavigationMeshHeader header = 
     {
-        delete[] m_faces;
+        .Magic = NavigationMeshHeader::MagicValue,
+        .Version = NavigationMeshHeader::VersionValue,
+        .VertexCount = m_vertexCount,
+        .FaceCount = m_faceCount,
+        .GridMin = m_gridMin,
+        .GridInvCellSize = m_gridInvCellSize,
+        .GridWidth = m_gridWidth,
+        .GridHeight = m_gridHeight,
+        .GridFaceCount = m_gridFaceCount
+    };
+
+    if (fwrite(&header, sizeof(NavigationMeshHeader), 1, fp) != 1)
+    {
+        return false;
+    }
+
+    if (fwrite(m_vertices, sizeof(glm::vec3), m_vertexCount, fp) != m_vertexCount)
+    {
+        return false;
     }
+
+    if (fwrite(m_faces, sizeof(NavigationFace), m_faceCount, fp) != m_faceCount)
+    {
+        return false;
+    }
+
+    if (m_gridCellOffsets != nullptr)
+    {
+        const uint32_t cellCount = m_gridWidth * m_gridHeight + 1;
+        if (fwrite(m_gridCellOffsets, sizeof(uint32_t), cellCount, fp) != cellCount)
+        {
+            return false;
+        }
+
+        if (fwrite(m_gridFaces, sizeof(uint32_t), m_gridFaceCount, fp) != m_gridFaceCount)
+        {
+            return false;
+        }
+    }
+
+    return true;
 }
 
-uint32_t NavigationMesh::GetIndex(const glm::vec3& a_point) const
+void NavigationMesh::BuildSpatialGrid()
 {
-    float dist = std::numeric_limits<float>::max();
-    uint32_t triangle = -1;
-    // Do not want the first tri we collide with incase have 2 tris stacked
-    // May change to use a spatial hash to narrow down the line if we have large meshes
+    if (m_faceCount <= 0)
+    {
+        return;
+    }
+
+    TRACE("Building Nav Mesh Grid");
+
+    // Point tests have a bit of slack so pad the bounds to make sure edge cases land in the cell
+    constexpr float Padding = 0.01f;
+
+    glm::vec2 min = glm::vec2(std::numeric_limits<float>::max());
+    glm::vec2 max = glm::vec2(-std::numeric_limits<float>::max());
+    float extentSum = 0.0f;
+
+    for (uint32_t i = 0; i < m_faceCount; ++i)
+    {
+        const NavigationFace& face = m_faces[i];
+
+        glm::vec2 fMin = m_vertices[face.Indicies[0]].xz();
+        glm::vec2 fMax = fMin;
+        for (uint32_t j = 1; j < 3; ++j)
+        {
+            const glm::vec2 pos = m_vertices[face.Indicies[j]].xz();
+
+            fMin = glm::min(fMin, pos);
+            fMax = glm::max(fMax, pos);
+        }
+
+        const glm::vec2 extent = fMax - fMin;
+        extentSum += glm::max(extent.x, extent.y);
+
+        min = glm::min(min, fMin);
+        max = glm::max(max, fMax);
+    }
+
+    min -= glm::vec2(Padding);
+    max += glm::vec2(Padding);
+
+    const glm::vec2 size = max - min;
+
+    // Cells around the size of the average face keeps the amount of faces per cell low without duplicating faces across lots of cells
+    const float avgExtent = extentSum / m_faceCount;
+    const float minCellSize = glm::max(size.x, size.y) / MaxGridDimension;
+    const float cellSize = glm::max(glm::max(avgExtent, minCellSize), Padding);
+
+    m_gridMin = min;
+    m_gridInvCellSize = 1.0f / cellSize;
+    m_gridWidth = glm::clamp((uint32_t)glm::ceil(size.x * m_gridInvCellSize), 1U, MaxGridDimension);
+    m_gridHeight = glm::clamp((uint32_t)glm::ceil(size.y * m_gridInvCellSize), 1U, MaxGridDimension);
+
+    const uint32_t cellCount = m_gridWidth * m_gridHeight;
+
+    m_gridCellOffsets = new uint32_t[cellCount + 1];
+    memset(m_gridCellOffsets, 0, (cellCount + 1) * sizeof(uint32_t));
+
+    glm::uvec4* faceCells = new glm::uvec4[m_faceCount];
+    IDEFER(delete[] faceCells);
+
+    // First pass count the faces in each cell
     for (uint32_t i = 0; i < m_faceCount; ++i)
     {
         const NavigationFace& face = m_faces[i];
 
-        const glm::vec3& vertA = m_vertices[face.Indicies[0]];
-        const glm::vec3& vertB = m_vertices[face.Indicies[1]];
-        const glm::vec3& vertC = m_vertices[face.Indicies[2]];
+        glm::vec2 fMin = m_vertices[face.Indicies[0]].xz();
+        glm::vec2 fMax = fMin;
+        for (uint32_t j = 1; j < 3; ++j)
+        {
+            const glm::vec2 pos = m_vertices[face.Indicies[j]].xz();
+
+            fMin = glm::min(fMin, pos);
+            fMax = glm::max(fMax, pos);
+        }
+
+        const glm::vec2 cMin = (fMin - Padding - m_gridMin) * m_gridInvCellSize;
+        const glm::vec2 cMax = (fMax + Padding - m_gridMin) * m_gridInvCellSize;
 
-        const float orig = glm::abs((vertB.x - vertA.x) * (vertC.z - vertA.z) - (vertC.x - vertA.x) * (vertB.z - vertA.z));
+        const glm::uvec4 cells = glm::uvec4
+        (
+            glm::min((uint32_t)glm::max(cMin.x, 0.0f), m_gridWidth - 1),
+            glm::min((uint32_t)glm::max(cMin.y, 0.0f), m_gridHeight - 1),
+            glm::min((uint32_t)glm::max(cMax.x, 0.0f), m_gridWidth - 1),
+            glm::min((uint32_t)glm::max(cMax.y, 0.0f), m_gridHeight - 1)
+        );
+        faceCells[i] = cells;
 
-        const float a1 = glm::abs((vertA.x - a_point.x) * (vertB.z - a_point.z) - (vertB.x - a_point.x) * (vertA.z - a_point.z));
-        const float a2 = glm::abs((vertB.x - a_point.x) * (vertC.z - a_point.z) - (vertC.x - a_point.x) * (vertB.z - a_point.z));
-        const float a3 = glm::abs((vertC.x - a_point.x) * (vertA.z - a_point.z) - (vertA.x - a_point.x) * (vertC.z - a_point.z));
+        for (uint32_t y = cells.y; y <= cells.w; ++y)
+        {
+            for (uint32_t x = cells.x; x <= cells.z; ++x)
+            {
+                ++m_gridCellOffsets[y * m_gridWidth + x + 1];
+            }
+        }
+    }
+
+    for (uint32_t i = 0; i < cellCount; ++i)
+    {
+        m_gridCellOffsets[i + 1] += m_gridCellOffsets[i];
+    }
+
+    m_gridFaceCount = m_gridCellOffsets[cellCount];
+    m_gridFaces = new uint32_t[m_gridFaceCount];
 
-        // Do not trust floating point values
-        if (glm::abs((a1 + a2 + a3) - orig) < 0.001f)
+    uint32_t* cellFill = new uint32_t[cellCount];
+    IDEFER(delete[] cellFill);
+    memcpy(cellFill, m_gridCellOffsets, cellCount * sizeof(uint32_t));
+
+    // Second pass fill the cells
+    for (uint32_t i = 0; i < m_faceCount; ++i)
+    {
+        const glm::uvec4 cells = faceCells[i];
+
+        for (uint32_t y = cells.y; y <= cells.w; ++y)
         {
-            const float mag = a_point.y - face.Center.y;
+            for (uint32_t x = cells.x; x <= cells.z; ++x)
+            {
+                m_gridFaces[cellFill[y * m_gridWidth + x]++] = i;
+            }
+        }
+    }
+}
+
+bool NavigationMesh::IsPointInFace(const glm::vec3& a_point, uint32_t a_index) const
+{
+    const NavigationFace& face = m_faces[a_index];
+
+    const glm::vec3& vertA = m_vertices[face.Indicies[0]];
+    const glm::vec3& vertB = m_vertices[face.Indicies[1]];
+    const glm::vec3& vertC = m_vertices[face.Indicies[2]];
+
+    const float orig = glm::abs((vertB.x - vertA.x) * (vertC.z - vertA.z) - (vertC.x - vertA.x) * (vertB.z - vertA.z));
+
+    const float a1 = glm::abs((vertA.x - a_point.x) * (vertB.z - a_point.z) - (vertB.x - a_point.x) * (vertA.z - a_point.z));
+    const float a2 = glm::abs((vertB.x - a_point.x) * (vertC.z - a_point.z) - (vertC.x - a_point.x) * (vertB.z - a_point.z));
+    const float a3 = glm::abs((vertC.x - a_point.x) * (vertA.z - a_point.z) - (vertA.x - a_point.x) * (vertC.z - a_point.z));
+
+    // Do not trust floating point values
+    return glm::abs((a1 + a2 + a3) - orig) < 0.001f;
+}
+
+uint32_t NavigationMesh::GetIndex(const glm::vec3& a_point) const
+{
+    if (m_gridCellOffsets == nullptr)
+    {
+        return -1;
+    }
+
+    const glm::vec2 cell = (a_point.xz() - m_gridMin) * m_gridInvCellSize;
+    if (cell.x < 0.0f || cell.y < 0.0f || cell.x >= m_gridWidth || cell.y >= m_gridHeight)
+    {
+        return -1;
+    }
+
+    const uint32_t cellIndex = (uint32_t)cell.y * m_gridWidth + (uint32_t)cell.x;
+
+    const uint32_t start = m_gridCellOffsets[cellIndex];
+    const uint32_t end = m_gridCellOffsets[cellIndex + 1];
+
+    float dist = std::numeric_limits<float>::max();
+    uint32_t triangle = -1;
+    // Do not want the first tri we collide with incase have 2 tris stacked
+    for (uint32_t i = start; i < end; ++i)
+    {
+        const uint32_t faceIndex = m_gridFaces[i];
+
+        if (IsPointInFace(a_point, faceIndex))
+        {
+            const float mag = a_point.y - m_faces[faceIndex].Center.y;
             
             if (mag < dist)
             {
-                triangle = i;
+                triangle = faceIndex;
                 dist = mag;
             }
         }
@@ -251,59 +713,207 @@ uint32_t NavigationMesh::GetIndex(const glm::vec3& a_point) const
     return triangle;
 }
 
-struct PathNode
+// Scratch space for path searches kept per thread so searches can run in parallel without reallocating each query
+// Nodes are only valid if their generation matches the current search so there is no need to clear between searches
+class PathScratch
 {
-    float Weight;
-    uint32_t Index;
-};
+private:
+    uint32_t  m_capacity;
+    uint32_t  m_generation;
+    uint32_t  m_heapSize;
+
+    uint32_t* m_generations;
+    uint32_t* m_parents;
+    float*    m_costs;
+    float*    m_scores;
+    uint32_t* m_heapIndices;
+    uint32_t* m_heap;
+
+    inline void Swap(uint32_t a_lhs, uint32_t a_rhs)
+    {
+        const uint32_t lhsNode = m_heap[a_lhs];
+        const uint32_t rhsNode = m_heap[a_rhs];
 
-static void PushPathValue(uint32_t a_index, const NavigationFace* a_faces, const glm::vec3& a_end, Array<PathNode>* a_queue, std::unordered_map<uint32_t, uint32_t>* a_stepMap)
-{
-    const NavigationFace& face = a_faces[a_index];
+        m_heap[a_lhs] = rhsNode;
+        m_heap[a_rhs] = lhsNode;
+
+        m_heapIndices[rhsNode] = a_lhs;
+        m_heapIndices[lhsNode] = a_rhs;
+    }
 
-    for (uint32_t i = 0; i < 3; ++i)
+    void SiftUp(uint32_t a_heapIndex)
     {
-        const uint32_t con = face.Connections[i];
-        if (con == -1)
+        while (a_heapIndex > 0)
         {
-            continue;
+            const uint32_t parent = (a_heapIndex - 1) >> 1;
+            if (m_scores[m_heap[parent]] <= m_scores[m_heap[a_heapIndex]])
+            {
+                break;
+            }
+
+            Swap(parent, a_heapIndex);
+
+            a_heapIndex = parent;
         }
+    }
+    void SiftDown(uint32_t a_heapIndex)
+    {
+        while (true)
+        {
+            const uint32_t left = (a_heapIndex << 1) + 1;
+            const uint32_t right = left + 1;
+
+            uint32_t smallest = a_heapIndex;
+            if (left < m_heapSize && m_scores[m_heap[left]] < m_scores[m_heap[smallest]])
+            {
+                smallest = left;
+            }
+            if (right < m_heapSize && m_scores[m_heap[right]] < m_scores[m_heap[smallest]])
+            {
+                smallest = right;
+            }
 
-        const auto iter = a_stepMap->find(con);
-        if (iter != a_stepMap->end())
+            if (smallest == a_heapIndex)
+            {
+                break;
+            }
+
+            Swap(smallest, a_heapIndex);
+
+            a_heapIndex = smallest;
+        }
+    }
+
+protected:
+
+public:
+    static constexpr uint32_t ClosedIndex = -1;
+
+    PathScratch()
+    {
+        m_capacity = 0;
+        m_generation = 0;
+        m_heapSize = 0;
+
+        m_generations = nullptr;
+        m_parents = nullptr;
+        m_costs = nullptr;
+        m_scores = nullptr;
+        m_heapIndices = nullptr;
+        m_heap = nullptr;
+    }
+    ~PathScratch()
+    {
+        delete[] m_generations;
+        delete[] m_parents;
+        delete[] m_costs;
+        delete[] m_scores;
+        delete[] m_heapIndices;
+        delete[] m_heap;
+    }
+
+    void Begin(uint32_t a_nodeCount)
+    {
+        m_heapSize = 0;
+
+        if (a_nodeCount > m_capacity)
         {
-            continue;
+            delete[] m_generations;
+            delete[] m_parents;
+            delete[] m_costs;
+            delete[] m_scores;
+            delete[] m_heapIndices;
+            delete[] m_heap;
+
+            m_capacity = a_nodeCount;
+
+            m_generations = new uint32_t[m_capacity];
+            m_parents = new uint32_t[m_capacity];
+            m_costs = new float[m_capacity];
+            m_scores = new float[m_capacity];
+            m_heapIndices = new uint32_t[m_capacity];
+            m_heap = new uint32_t[m_capacity];
+
+            memset(m_generations, 0, m_capacity * sizeof(uint32_t));
+            m_generation = 0;
         }
 
-        a_stepMap->emplace(con, a_index);
+        ++m_generation;
+        // Wrapped around so old stamps could be mistaken for the current search
+        if (m_generation == 0)
+        {
+            memset(m_generations, 0, m_capacity * sizeof(uint32_t));
+            m_generation = 1;
+        }
+    }
 
-        const NavigationFace& conFace = a_faces[con];
+    inline bool IsVisited(uint32_t a_node) const
+    {
+        return m_generations[a_node] == m_generation;
+    }
+    inline bool IsClosed(uint32_t a_node) const
+    {
+        return IsVisited(a_node) && m_heapIndices[a_node] == ClosedIndex;
+    }
+    inline bool Empty() const
+    {
+        return m_heapSize == 0;
+    }
 
-        const glm::vec3 diff = a_end - conFace.Center;
-        const float d = glm::length2(diff);
+    inline uint32_t GetParent(uint32_t a_node) const
+    {
+        return m_parents[a_node];
+    }
+    inline float GetCost(uint32_t a_node) const
+    {
+        return m_costs[a_node];
+    }
 
-        const PathNode value = 
+    // Either adds the node to the open list or updates it if a cheaper route has been found
+    void Push(uint32_t a_node, uint32_t a_parent, float a_cost, float a_score)
+    {
+        if (IsVisited(a_node))
         {
-            .Weight = d,
-            .Index = con
-        };
+            m_parents[a_node] = a_parent;
+            m_costs[a_node] = a_cost;
+            m_scores[a_node] = a_score;
+
+            SiftUp(m_heapIndices[a_node]);
+
+            return;
+        }
 
-        const uint32_t queueSize = a_queue->Size();
-        for (int32_t j = queueSize - 1; j >= 0; --j)
+        m_generations[a_node] = m_generation;
+        m_parents[a_node] = a_parent;
+        m_costs[a_node] = a_cost;
+        m_scores[a_node] = a_score;
+
+        const uint32_t heapIndex = m_heapSize++;
+        m_heap[heapIndex] = a_node;
+        m_heapIndices[a_node] = heapIndex;
+
+        SiftUp(heapIndex);
+    }
+    uint32_t Pop()
+    {
+        const uint32_t node = m_heap[0];
+
+        --m_heapSize;
+        if (m_heapSize > 0)
         {
-            if (d < a_queue->Get(j).Weight)
-            {
-                a_queue->Insert(j, value);
+            m_heap[0] = m_heap[m_heapSize];
+            m_heapIndices[m_heap[0]] = 0;
 
-                goto NextIter;
-            }
+            SiftDown(0);
         }
 
-        a_queue->Push(value);
+        m_heapIndices[node] = ClosedIndex;
 
-NextIter:;
-    }    
-}   
+        return node;
+    }
+};
+
+static thread_local PathScratch Scratch;
 
 static float TriToAreaSqr(const glm::vec3& a_vertA, const glm::vec3& a_vertB, const glm::vec3& a_vertC)
 {
@@ -330,53 +940,112 @@ Array<glm::vec3> NavigationMesh::GeneratePath(const glm::vec3& a_startPoint, con
 
     return GeneratePath(a_startPoint, a_endPoint, indexA, indexB, a_agentRadius);
 }
-// 2.5D Pathfinding
-Array<glm::vec3> NavigationMesh::GeneratePath(const glm::vec3& a_startPoint, const glm::vec3& a_endPoint, uint32_t a_startIndex, uint32_t a_endIndex, float a_agentRadius) const
+bool NavigationMesh::FindCorridor(uint32_t a_startIndex, uint32_t a_endIndex, Array<uint32_t>* a_corridor) const
 {
     if (a_startIndex == -1 || a_endIndex == -1)
     {
-        return Array<glm::vec3>();
+        return false;
     }
 
+    a_corridor->Clear();
+
     if (a_startIndex == a_endIndex)
     {
-        Array<glm::vec3> path;
+        a_corridor->Push(a_startIndex);
 
-        path.Push(a_startPoint);
-        path.Push(a_endPoint);
-
-        return path;
+        return true;
     }
 
-    // Find path
-    Array<PathNode> queue;
-    std::unordered_map<uint32_t, uint32_t> stepMap;
-    PushPathValue(a_startIndex, m_faces, a_endPoint, &queue, &stepMap);
-    while (!queue.Empty())
+    // A* over the face centers with the straight line distance to the end face as the heuristic
+    const glm::vec3 endCenter = m_faces[a_endIndex].Center;
+
+    PathScratch& scratch = Scratch;
+    scratch.Begin(m_faceCount);
+    scratch.Push(a_startIndex, -1, 0.0f, glm::distance(m_faces[a_startIndex].Center, endCenter));
+
+    bool found = false;
+    while (!scratch.Empty())
     {
-        const PathNode value = queue.Get(0);
-        queue.Erase(0);
-        if (value.Index == a_endIndex)
+        const uint32_t index = scratch.Pop();
+        if (index == a_endIndex)
         {
+            found = true;
+
             break;
         }
 
-        PushPathValue(value.Index, m_faces, a_endPoint, &queue, &stepMap);
+        const NavigationFace& face = m_faces[index];
+        const float cost = scratch.GetCost(index);
+
+        for (uint32_t i = 0; i < 3; ++i)
+        {
+            const uint32_t con = face.Connections[i];
+            if (con == -1 || scratch.IsClosed(con))
+            {
+                continue;
+            }
+
+            const NavigationFace& conFace = m_faces[con];
+
+            const float conCost = cost + glm::distance(face.Center, conFace.Center);
+            if (scratch.IsVisited(con) && conCost >= scratch.GetCost(con))
+            {
+                continue;
+            }
+
+            scratch.Push(con, index, conCost, conCost + glm::distance(conFace.Center, endCenter));
+        }
     }
 
-    // Backtrace path
-    Array<uint32_t> pathIndices;
+    if (!found)
+    {
+        return false;
+    }
 
+    // Backtrace path
     uint32_t node = a_endIndex;
-    pathIndices.Push(node);
-    while (node != a_startIndex)
+    while (node != -1)
+    {
+        a_corridor->Push(node);
+
+        node = scratch.GetParent(node);
+    }
+
+    // Built backwards so flip it
+    const uint32_t corridorSize = a_corridor->Size();
+    for (uint32_t i = 0; i < corridorSize / 2; ++i)
+    {
+        const uint32_t tmp = a_corridor->Get(i);
+        a_corridor->Set(i, a_corridor->Get(corridorSize - i - 1));
+        a_corridor->Set(corridorSize - i - 1, tmp);
+    }
+
+    return true;
+}
+
+// 2.5D Pathfinding
+Array<glm::vec3> NavigationMesh::GeneratePath(const glm::vec3& a_startPoint, const glm::vec3& a_endPoint, uint32_t a_startIndex, uint32_t a_endIndex, float a_agentRadius) const
+{
+    Array<uint32_t> corridor;
+    if (!FindCorridor(a_startIndex, a_endIndex, &corridor))
     {
-        const uint32_t index = stepMap[node];
-        IDEFER(node = index);
+        return Array<glm::vec3>();
+    }
 
-        pathIndices.Insert(0, index);
+    return BuildPath(corridor, a_startPoint, a_endPoint, a_agentRadius);
+}
+Array<glm::vec3> NavigationMesh::BuildPath(const Array<uint32_t>& a_corridor, const glm::vec3& a_startPoint, const glm::vec3& a_endPoint, float a_agentRadius) const
+{
+    const uint32_t pathIndexCount = a_corridor.Size();
+    if (pathIndexCount <= 1)
+    {
+        Array<glm::vec3> path;
+
+        path.Push(a_startPoint);
+        path.Push(a_endPoint);
+
+        return path;
     }
-    pathIndices.Insert(0, a_startIndex);
 
     struct Portal
     {
@@ -388,15 +1057,13 @@ Array<glm::vec3> NavigationMesh::GeneratePath(const glm::vec3& a_startPoint, con
     // TODO: Adjust portals based off agent radius and take agent radius as a parameter
     // NOTE: While should build meshes based off the agent gets messy when dealing with agent of varying size as can have several meshes and alot of "wasted" memory
     // In reality building the mesh based off the biggest agent and adjusting portals should be fine outside of extreme size differences
-    const uint32_t pathIndexCount = pathIndices.Size();
-    
     Array<Portal> portals;
     portals.Reserve(pathIndexCount);
 
     for (uint32_t i = 1; i < pathIndexCount; ++i)
     {
-        const uint32_t pastIndex = pathIndices[i - 1];
-        const uint32_t curIndex = pathIndices[i];
+        const uint32_t pastIndex = a_corridor[i - 1];
+        const uint32_t curIndex = a_corridor[i];
 
         const NavigationFace& pastFace = m_faces[pastIndex];
         const NavigationFace& curFace = m_faces[curIndex];
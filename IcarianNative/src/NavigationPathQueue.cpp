@@ -0,0 +1,459 @@
+// Icarian Engine - C# Game Engine
+// 
+// License at end of file.
+
+#include "AI/NavigationPathQueue.h"
+
+#include <algorithm>
+
+#include "AI/Navigation.h"
+#include "AI/NavigationMesh.h"
+#include "Core/IcarianDefer.h"
+#include "DataTypes/ThreadGuard.h"
+#include "ThreadJob.h"
+#include "ThreadPool.h"
+
+class PathQueryJob : public ThreadJob
+{
+private:
+    NavigationPathQueue* m_queue;
+
+protected:
+
+public:
+    PathQueryJob(NavigationPathQueue* a_queue) : ThreadJob(JobPriority_EngineMedium)
+    {
+        m_queue = a_queue;
+    }
+    virtual ~PathQueryJob() { }
+
+    virtual void Execute()
+    {
+        m_queue->RunWorker();
+    }
+};
+
+NavigationPathQueue::NavigationPathQueue(Navigation* a_navigation)
+{
+    m_navigation = a_navigation;
+
+    m_groupCursor = 0;
+    m_activeJobs = 0;
+}
+NavigationPathQueue::~NavigationPathQueue()
+{
+    // Thread pool is destroyed before navigation so there are no jobs left that can reference the queue
+    // Released requests that have already been processed are gone so only the leftovers need cleaning up
+    RequeueBatch();
+
+    for (NavigationPathRequest* request : m_pending)
+    {
+        if (request->Released)
+        {
+            delete request;
+        }
+    }
+
+    const uint32_t size = m_requests.Size();
+    for (uint32_t i = 0; i < size; ++i)
+    {
+        if (m_requests.Exists(i))
+        {
+            delete m_requests[i];
+        }
+    }
+}
+
+uint32_t NavigationPathQueue::PushRequest(uint32_t a_meshAddr, const glm::vec3& a_startPoint, const glm::vec3& a_endPoint, float a_agentRadius)
+{
+    NavigationPathRequest* request = new NavigationPathRequest();
+    request->MeshAddr = a_meshAddr;
+    request->StartFace = -1;
+    request->EndFace = -1;
+    request->StartPoint = a_startPoint;
+    request->EndPoint = a_endPoint;
+    request->AgentRadius = a_agentRadius;
+    request->State = PathRequestState_Pending;
+    request->Released = false;
+
+    const ThreadGuard g = ThreadGuard(m_lock);
+
+    m_pending.Push(request);
+
+    return m_requests.PushVal(request);
+}
+
+e_PathRequestState NavigationPathQueue::GetState(uint32_t a_addr)
+{
+    const ThreadGuard g = ThreadGuard(m_lock);
+
+    if (a_addr >= m_requests.Size() || !m_requests.Exists(a_addr))
+    {
+        return PathRequestState_Invalid;
+    }
+
+    return m_requests[a_addr]->State;
+}
+Array<glm::vec3> NavigationPathQueue::TakePath(uint32_t a_addr)
+{
+    const ThreadGuard g = ThreadGuard(m_lock);
+
+    if (a_addr >= m_requests.Size() || !m_requests.Exists(a_addr))
+    {
+        return Array<glm::vec3>();
+    }
+
+    NavigationPathRequest* request = m_requests[a_addr];
+    if (request->State == PathRequestState_Pending)
+    {
+        return Array<glm::vec3>();
+    }
+
+    IDEFER(delete request);
+    m_requests.Erase(a_addr);
+
+    return request->Path;
+}
+void NavigationPathQueue::DestroyRequest(uint32_t a_addr)
+{
+    const ThreadGuard g = ThreadGuard(m_lock);
+
+    if (a_addr >= m_requests.Size() || !m_requests.Exists(a_addr))
+    {
+        return;
+    }
+
+    NavigationPathRequest* request = m_requests[a_addr];
+    m_requests.Erase(a_addr);
+
+    // Still referenced by the queue so let it get cleaned up when it comes back around
+    if (request->State == PathRequestState_Pending)
+    {
+        request->Released = true;
+
+        return;
+    }
+
+    delete request;
+}
+
+void NavigationPathQueue::RunWorker()
+{
+    const uint32_t groupCount = m_groups.Size();
+
+    // Always take at least one group so a backed up thread pool cannot starve the queue
+    do
+    {
+        const uint32_t index = m_groupCursor.fetch_add(1);
+        if (index >= groupCount)
+        {
+            break;
+        }
+
+        ProcessGroup(index);
+    }
+    while (std::chrono::steady_clock::now() < m_deadline);
+
+    --m_activeJobs;
+}
+
+void NavigationPathQueue::ProcessGroup(uint32_t a_index)
+{
+    const PathGroup& group = m_groups[a_index];
+
+    bool found = false;
+    {
+        // Holding the lock stops the mesh getting destroyed out from under us
+        const TReadLockArray<NavigationMesh*> a = m_navigation->m_meshes.ToReadLockArray();
+
+        const NavigationMesh* mesh = nullptr;
+        if (group.MeshAddr < a.Size())
+        {
+            mesh = a[group.MeshAddr];
+        }
+
+        if (mesh != nullptr)
+        {
+            Array<uint32_t> corridor;
+            found = mesh->FindCorridor(group.StartFace, group.EndFace, &corridor);
+            if (found)
+            {
+                for (uint32_t i = 0; i < group.Count; ++i)
+                {
+                    NavigationPathRequest* request = m_batch[group.Start + i];
+
+                    // Nothing else touches the path until the state changes
+                    request->Path = mesh->BuildPath(corridor, request->StartPoint, request->EndPoint, request->AgentRadius);
+                }
+            }
+        }
+    }
+
+    const ThreadGuard g = ThreadGuard(m_lock);
+
+    for (uint32_t i = 0; i < group.Count; ++i)
+    {
+        NavigationPathRequest* request = m_batch[group.Start + i];
+        if (request->Released)
+        {
+            delete request;
+
+            continue;
+        }
+
+        if (found)
+        {
+            request->State = PathRequestState_Ready;
+        }
+        else
+        {
+            request->State = PathRequestState_Failed;
+        }
+    }
+}
+
+void NavigationPathQueue::RequeueBatch()
+{
+    const uint32_t groupCount = m_groups.Size();
+    const uint32_t processed = glm::min((uint32_t)m_groupCursor, groupCount);
+    if (processed >= groupCount)
+    {
+        m_groups.Clear();
+        m_batch.Clear();
+
+        return;
+    }
+
+    // Ran out of time so put what is left at the front of the queue to be processed next frame
+    Array<NavigationPathRequest*> pending;
+
+    const ThreadGuard g = ThreadGuard(m_lock);
+
+    for (uint32_t i = processed; i < groupCount; ++i)
+    {
+        const PathGroup& group = m_groups[i];
+
+        for (uint32_t j = 0; j < group.Count; ++j)
+        {
+            NavigationPathRequest* request = m_batch[group.Start + j];
+            if (request->Released)
+            {
+                delete request;
+
+                continue;
+            }
+
+            pending.Push(request);
+        }
+    }
+
+    for (NavigationPathRequest* request : m_pending)
+    {
+        pending.Push(request);
+    }
+
+    m_pending = pending;
+
+    m_groups.Clear();
+    m_batch.Clear();
+}
+
+void NavigationPathQueue::BuildBatch()
+{
+    {
+        const ThreadGuard g = ThreadGuard(m_lock);
+
+        for (NavigationPathRequest* request : m_pending)
+        {
+            if (request->Released)
+            {
+                delete request;
+
+                continue;
+            }
+
+            m_batch.Push(request);
+        }
+
+        m_pending.Clear();
+    }
+
+    if (m_batch.Empty())
+    {
+        return;
+    }
+
+    Array<NavigationPathRequest*> failed;
+    {
+        const Array<bool> state = m_navigation->m_meshes.ToStateArray();
+        const TReadLockArray<NavigationMesh*> a = m_navigation->m_meshes.ToReadLockArray();
+
+        const uint32_t meshCount = a.Size();
+
+        const uint32_t batchSize = m_batch.Size();
+        for (uint32_t i = 0; i < batchSize; ++i)
+        {
+            NavigationPathRequest* request = m_batch[i];
+
+            if (request->MeshAddr != -1)
+            {
+                if (request->MeshAddr < meshCount && state[request->MeshAddr])
+                {
+                    const NavigationMesh* mesh = a[request->MeshAddr];
+
+                    request->StartFace = mesh->GetIndex(request->StartPoint);
+                    request->EndFace = mesh->GetIndex(request->EndPoint);
+                }
+
+                continue;
+            }
+
+            // Not bound to a mesh so use the first one that contains both points
+            for (uint32_t j = 0; j < meshCount; ++j)
+            {
+                if (!state[j])
+                {
+                    continue;
+                }
+
+                const NavigationMesh* mesh = a[j];
+
+                const uint32_t startFace = mesh->GetIndex(request->StartPoint);
+                const uint32_t endFace = mesh->GetIndex(request->EndPoint);
+                if (startFace != -1 && endFace != -1)
+                {
+                    request->MeshAddr = j;
+                    request->StartFace = startFace;
+                    request->EndFace = endFace;
+
+                    break;
+                }
+            }
+        }
+    }
+
+    // Sort so requests for the same faces end up next to each other
+    std::sort(m_batch.begin(), m_batch.end(), [](const NavigationPathRequest* a_lhs, const NavigationPathRequest* a_rhs)
+    {
+        if (a_lhs->MeshAddr != a_rhs->MeshAddr)
+        {
+            return a_lhs->MeshAddr < a_rhs->MeshAddr;
+        }
+        if (a_lhs->StartFace != a_rhs->StartFace)
+        {
+            return a_lhs->StartFace < a_rhs->StartFace;
+        }
+
+        return a_lhs->EndFace < a_rhs->EndFace;
+    });
+
+    Array<NavigationPathRequest*> batch;
+
+    const uint32_t batchSize = m_batch.Size();
+    for (uint32_t i = 0; i < batchSize; ++i)
+    {
+        NavigationPathRequest* request = m_batch[i];
+        if (request->MeshAddr == -1 || request->StartFace == -1 || request->EndFace == -1)
+        {
+            failed.Push(request);
+
+            continue;
+        }
+
+        const uint32_t index = batch.Size();
+        batch.Push(request);
+
+        const uint32_t groupCount = m_groups.Size();
+        if (groupCount > 0)
+        {
+            PathGroup& group = m_groups[groupCount - 1];
+            if (group.MeshAddr == request->MeshAddr && group.StartFace == request->StartFace && group.EndFace == request->EndFace)
+            {
+                ++group.Count;
+
+                continue;
+            }
+        }
+
+        const PathGroup group = 
+        {
+            .MeshAddr = request->MeshAddr,
+            .StartFace = request->StartFace,
+            .EndFace = request->EndFace,
+            .Start = index,
+            .Count = 1
+        };
+
+        m_groups.Push(group);
+    }
+
+    m_batch = batch;
+
+    if (!failed.Empty())
+    {
+        const ThreadGuard g = ThreadGuard(m_lock);
+
+        for (NavigationPathRequest* request : failed)
+        {
+            if (request->Released)
+            {
+                delete request;
+
+                continue;
+            }
+
+            request->State = PathRequestState_Failed;
+        }
+    }
+}
+
+void NavigationPathQueue::Update()
+{
+    // Workers are still going from the last batch so leave them to it
+    if (m_activeJobs > 0)
+    {
+        return;
+    }
+
+    RequeueBatch();
+    BuildBatch();
+
+    const uint32_t groupCount = m_groups.Size();
+    if (groupCount <= 0)
+    {
+        return;
+    }
+
+    const uint32_t jobCount = glm::min(groupCount, ThreadPool::GetThreadCount());
+
+    m_groupCursor = 0;
+    m_activeJobs = jobCount;
+    m_deadline = std::chrono::steady_clock::now() + FrameBudget;
+
+    for (uint32_t i = 0; i < jobCount; ++i)
+    {
+        ThreadPool::PushJob(new PathQueryJob(this));
+    }
+}
+
+// MIT License
+// 
+// Copyright (c) 2024 River Govers
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
\ No newline at end of file
@@ -4,15 +4,42 @@
 
 #include "Networking/NetworkClient.h"
 
+#include <cstring>
 #include <string>
 
 #include "Core/IcarianDefer.h"
+#include "DataTypes/ThreadGuard.h"
 #include "Networking/NetworkManager.h"
+#include "ObjectManager.h"
+
+// Lower bound by NetID so it doubles as the insert position
+template<typename T>
+static uint32_t FindNetID(const T* a_data, uint32_t a_size, uint32_t a_netID)
+{
+    uint32_t low = 0;
+    uint32_t high = a_size;
+    while (low < high)
+    {
+        const uint32_t mid = (low + high) / 2;
+        if (a_data[mid].NetID < a_netID)
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+
+    return low;
+}
 
 NetworkClient::NetworkClient()
 {
     m_server = -1;
     m_addr = -1;
+
+    m_appliedTick = 0;
 }
 NetworkClient::NetworkClient(NetworkManager* a_manager, uint32_t a_server, const ENetEvent& a_event)
 {
@@ -21,34 +48,16 @@ NetworkClient::NetworkClient(NetworkManager* a_manager, uint32_t a_server, const
 
     m_host = a_event.peer->host;
     m_peer = a_event.peer;
+
+    m_appliedTick = 0;
 }
 NetworkClient::~NetworkClient()
 {
     if (m_peer != NULL)
     {
-        enet_peer_disconnect(m_peer, 0);
-
-        ENetEvent event;
-        while (enet_host_service(m_host, &event, 3000) > 0)
-        {
-            switch (event.type)
-            {
-            case ENET_EVENT_TYPE_RECEIVE:
-            {
-                enet_packet_destroy(event.packet);
-
-                break;
-            }
-            case ENET_EVENT_TYPE_DISCONNECT:
-            {
-                goto End;
-            }
-            }
-        }
-
-        enet_peer_reset(m_peer);
-
-End:;
+        // Destroyed on the network thread so cannot sit around waiting for the disconnect to be acknowledged
+        // Sends the disconnect straight away and resets the peer
+        enet_peer_disconnect_now(m_peer, 0);
     }
 
     const bool isServerSocket = m_server != -1;
@@ -60,7 +69,7 @@ End:;
 
 NetworkClient* NetworkClient::Connect(NetworkManager* a_manager, const NetworkAddress& a_address)
 {
-    ENetHost* host = enet_host_create(NULL, 1, 2, 0, 0);
+    ENetHost* host = enet_host_create(NULL, 1, NetworkChannelCount, 0, 0);
 
     if (host != NULL)
     {
@@ -72,7 +81,7 @@ NetworkClient* NetworkClient::Connect(NetworkManager* a_manager, const NetworkAd
         enet_address_set_host_ip(&enetAddress, ip.c_str());
         enetAddress.port = (enet_uint16)a_address.Port;
 
-        ENetPeer* peer = enet_host_connect(host, &enetAddress, 2, 0);
+        ENetPeer* peer = enet_host_connect(host, &enetAddress, NetworkChannelCount, 0);
 
         if (peer != NULL)
         {
@@ -97,30 +106,135 @@ NetworkClient* NetworkClient::Connect(NetworkManager* a_manager, const NetworkAd
     return nullptr;
 }
 
-void NetworkClient::Send(const uint8_t* a_data, uint32_t a_size, e_PacketFlags a_flags)
+void NetworkClient::Send(ENetPacket* a_packet, uint32_t a_channel)
+{
+    // ENet only takes ownership if the send succeeds
+    if (m_peer == NULL || enet_peer_send(m_peer, (enet_uint8)a_channel, a_packet) < 0)
+    {
+        enet_packet_destroy(a_packet);
+    }
+}
+
+void NetworkClient::Replicate(uint32_t a_netID, uint32_t a_transformAddr)
 {
-    if (m_peer == NULL)
+    const ThreadGuard g = ThreadGuard(m_replicationLock);
+
+    const uint32_t index = FindNetID(m_replicationTargets.Data(), m_replicationTargets.Size(), a_netID);
+    if (index < m_replicationTargets.Size() && m_replicationTargets[index].NetID == a_netID)
     {
+        m_replicationTargets[index].TransformAddr = a_transformAddr;
+
         return;
     }
 
-    enet_uint32 flags = 0;
+    m_replicationTargets.Insert(index, { a_netID, a_transformAddr });
+}
+void NetworkClient::StopReplicating(uint32_t a_netID)
+{
+    const ThreadGuard g = ThreadGuard(m_replicationLock);
 
-    if (a_flags & PacketFlags_Reliable)
+    const uint32_t index = FindNetID(m_replicationTargets.Data(), m_replicationTargets.Size(), a_netID);
+    if (index < m_replicationTargets.Size() && m_replicationTargets[index].NetID == a_netID)
     {
-        flags |= ENET_PACKET_FLAG_RELIABLE;
+        m_replicationTargets.Erase(index);
     }
-    if (a_flags & PacketFlags_Unsequenced)
+}
+uint32_t NetworkClient::GetReplicatedData(uint32_t a_netID, uint8_t* a_data)
+{
+    const ThreadGuard g = ThreadGuard(m_replicationLock);
+
+    const ReplicationSnapshot* snapshot = m_history.GetLatest();
+    if (snapshot == nullptr)
     {
-        flags |= ENET_PACKET_FLAG_UNSEQUENCED;
+        return -1;
     }
-    if (a_flags & PacketFlags_UnreliableFragment)
+
+    const uint32_t index = FindNetID(snapshot->States.Data(), snapshot->States.Size(), a_netID);
+    if (index >= snapshot->States.Size() || snapshot->States[index].NetID != a_netID)
     {
-        flags |= ENET_PACKET_FLAG_UNRELIABLE_FRAGMENT;
+        return -1;
     }
 
-    ENetPacket* packet = enet_packet_create(a_data, a_size, flags);
-    enet_peer_send(m_peer, 0, packet);
+    const ReplicationState& state = snapshot->States[index];
+    memcpy(a_data, state.Data, state.DataSize);
+
+    return state.DataSize;
+}
+
+void NetworkClient::ReceiveSnapshot(const ENetPacket* a_packet)
+{
+    ReplicationSnapshot* snapshot = ReplicationDecodeDelta(m_history, (uint8_t*)a_packet->data, (uint32_t)a_packet->dataLength);
+    if (snapshot == nullptr)
+    {
+        return;
+    }
+
+    // Late snapshots are already out of date
+    if (snapshot->Tick <= m_history.GetLatestTick())
+    {
+        delete snapshot;
+
+        return;
+    }
+
+    {
+        // Transforms belong to the game thread so only hand the snapshot over here and apply it in ApplySnapshot
+        const ThreadGuard g = ThreadGuard(m_replicationLock);
+
+        m_history.Push(snapshot);
+    }
+
+    // Acks are sent every snapshot so losing one only costs a slightly larger delta
+    const uint32_t tick = snapshot->Tick;
+    ENetPacket* packet = enet_packet_create(&tick, sizeof(uint32_t), 0);
+    if (enet_peer_send(m_peer, ReplicationChannel, packet) < 0)
+    {
+        enet_packet_destroy(packet);
+    }
+}
+
+void NetworkClient::ApplySnapshot()
+{
+    const ThreadGuard g = ThreadGuard(m_replicationLock);
+
+    // Only the latest one matters, anything received in between has already been superseded
+    const ReplicationSnapshot* snapshot = m_history.GetLatest();
+    if (snapshot == nullptr || snapshot->Tick == m_appliedTick)
+    {
+        return;
+    }
+
+    m_appliedTick = snapshot->Tick;
+
+    // Both sorted so can walk them together
+    const uint32_t targetCount = m_replicationTargets.Size();
+    const uint32_t stateCount = snapshot->States.Size();
+
+    uint32_t i = 0;
+    uint32_t j = 0;
+    while (i < targetCount && j < stateCount)
+    {
+        const ReplicationTarget& target = m_replicationTargets[i];
+        const ReplicationState& state = snapshot->States[j];
+
+        if (target.NetID < state.NetID)
+        {
+            ++i;
+        }
+        else if (state.NetID < target.NetID)
+        {
+            ++j;
+        }
+        else
+        {
+            TransformBuffer buffer = ObjectManager::GetTransformBuffer(target.TransformAddr);
+            ReplicationDequantize(state, &buffer);
+            ObjectManager::SetTransformBuffer(target.TransformAddr, buffer);
+
+            ++i;
+            ++j;
+        }
+    }
 }
 
 void NetworkClient::Update()
@@ -146,16 +260,43 @@ void NetworkClient::Update()
         {
         case ENET_EVENT_TYPE_RECEIVE:
         {
-            IDEFER(enet_packet_destroy(event.packet));
+            if (event.channelID == ReplicationChannel)
+            {
+                IDEFER(enet_packet_destroy(event.packet));
+
+                ReceiveSnapshot(event.packet);
 
-            m_manager->NetworkClientReceive(m_addr, (uint8_t*)event.packet->data, (uint32_t)event.packet->dataLength);
+                break;
+            }
+
+            // Packet is destroyed by the game thread once it has been handed to managed code
+            NetworkEvent e = { };
+            e.Type = NetworkEventType_Receive;
+            e.Addr = m_addr;
+            e.ServerAddr = m_server;
+            e.Packet = event.packet;
+            e.Timestamp = NetworkManager::GetTimestamp();
+
+            m_manager->PushEvent(e);
 
             break;
         }
         case ENET_EVENT_TYPE_DISCONNECT:
         {
-            m_manager->NetworkClientDisconnect(m_addr);
+            m_peer = NULL;
+
+            NetworkEvent e = { };
+            e.Type = NetworkEventType_Disconnect;
+            e.Addr = m_addr;
+            e.ServerAddr = m_server;
+            e.Timestamp = NetworkManager::GetTimestamp();
+
+            m_manager->PushEvent(e);
 
+            return;
+        }
+        default:
+        {
             break;
         }
         }
@@ -165,11 +306,18 @@ void NetworkClient::Update()
 
     if (result < 0)
     {
-        m_manager->NetworkClientDisconnect(m_addr, true);
-
         enet_peer_reset(m_peer);
         m_peer = NULL;
 
+        NetworkEvent e = { };
+        e.Type = NetworkEventType_Disconnect;
+        e.Addr = m_addr;
+        e.ServerAddr = m_server;
+        e.Error = 1;
+        e.Timestamp = NetworkManager::GetTimestamp();
+
+        m_manager->PushEvent(e);
+
         return;
     }
 }
@@ -4,12 +4,18 @@
 
 #include "Networking/NetworkManager.h"
 
+#include <chrono>
+#include <cstring>
+#include <functional>
+
 #include "Core/IcarianAssert.h"
 #include "Core/IcarianDefer.h"
 #include "DeletionQueue.h"
 #include "Logger.h"
 #include "Networking/NetworkClient.h"
+#include "Networking/NetworkReplication.h"
 #include "Networking/NetworkServer.h"
+#include "Profiler.h"
 #include "Runtime/RuntimeFunction.h"
 #include "Runtime/RuntimeManager.h"
 
@@ -64,6 +70,34 @@ public:
     }
 };
 
+static constexpr uint32_t ReceiveDataInitialSize = 1024 * 64;
+static constexpr uint32_t ReceivePacketInitialCount = 256;
+
+// Pinned so the GC cannot move it while it is being written to
+static MonoArray* CreatePinnedArray(MonoClass* a_class, uint32_t a_size, uint32_t* a_handle)
+{
+    MonoArray* array = mono_array_new(RuntimeManager::GetDomain(), a_class, (uintptr_t)a_size);
+    *a_handle = mono_gchandle_new((MonoObject*)array, true);
+
+    return array;
+}
+static MonoArray* GrowPinnedArray(MonoClass* a_class, MonoArray* a_array, uint32_t* a_handle, uint32_t a_elementSize, uint32_t a_used, uint32_t a_required)
+{
+    uint32_t size = (uint32_t)mono_array_length(a_array);
+    while (size < a_required)
+    {
+        size <<= 1;
+    }
+
+    const uint32_t oldHandle = *a_handle;
+    IDEFER(mono_gchandle_free(oldHandle));
+
+    MonoArray* array = CreatePinnedArray(a_class, size, a_handle);
+    memcpy(mono_array_addr_with_size(array, a_elementSize, 0), mono_array_addr_with_size(a_array, a_elementSize, 0), (size_t)a_used * a_elementSize);
+
+    return array;
+}
+
 ENGINE_NETWORKMANAGER_EXPORT_TABLE(RUNTIME_FUNCTION_DEFINITION);
 ENGINE_NETWORKCLIENT_EXPORT_TABLE(RUNTIME_FUNCTION_DEFINITION);
 ENGINE_NETWORKSERVER_EXPORT_TABLE(RUNTIME_FUNCTION_DEFINITION);
@@ -72,24 +106,73 @@ NetworkManager::NetworkManager()
 {
     Instance = this;
 
+    m_shutdown = false;
+
+    m_inboundLatency = 0.0f;
+    m_outboundLatency = 0;
+
     m_initialized = enet_initialize() == 0;
 
     ENGINE_NETWORKMANAGER_EXPORT_TABLE(RUNTIME_FUNCTION_ATTACH);
     ENGINE_NETWORKCLIENT_EXPORT_TABLE(RUNTIME_FUNCTION_ATTACH);
     ENGINE_NETWORKSERVER_EXPORT_TABLE(RUNTIME_FUNCTION_ATTACH);
 
-    m_networkClientReceiveFunction = RuntimeManager::GetFunction("IcarianEngine.Networking", "NetworkClient", ":Receive(uint,byte[])");
+    m_receiveData = CreatePinnedArray(mono_get_byte_class(), ReceiveDataInitialSize, &m_receiveDataHandle);
+    m_receiveDataSize = 0;
+    m_receivePackets = CreatePinnedArray(mono_get_uint32_class(), ReceivePacketInitialCount * 3, &m_receivePacketsHandle);
+    m_receivePacketCount = 0;
+
+    m_networkClientReceiveFunction = RuntimeManager::GetThunk<MonoArray*, MonoArray*, uint32_t>("IcarianEngine.Networking", "NetworkClient", ":ReceiveBatch(byte[],uint[],uint)");
     m_networkClientDisconnectFunction = RuntimeManager::GetFunction("IcarianEngine.Networking", "NetworkClient", ":Disconnect(uint,uint)");
 
     m_networkServerConnectFunction = RuntimeManager::GetFunction("IcarianEngine.Networking", "NetworkServer", ":Connect(uint,uint)");
+
+    if (m_initialized)
+    {
+        // ENet is serviced on its own thread so acks and resends do not depend on the frame rate
+        m_thread = std::thread(std::bind(&NetworkManager::Run, this));
+    }
 }
 NetworkManager::~NetworkManager()
 {
+    if (m_thread.joinable())
+    {
+        m_shutdown = true;
+        m_thread.join();
+    }
+
+    // Nothing is servicing the hosts anymore so finish off anything still queued
+    NetworkCommand command;
+    while (m_commands.TryPop(&command))
+    {
+        ProcessCommand(command);
+    }
+
+    for (const NetworkEvent& event : m_eventBacklog)
+    {
+        if (event.Packet != NULL)
+        {
+            enet_packet_destroy(event.Packet);
+        }
+    }
+
+    NetworkEvent event;
+    while (m_events.TryPop(&event))
+    {
+        if (event.Packet != NULL)
+        {
+            enet_packet_destroy(event.Packet);
+        }
+    }
+
     delete m_networkClientReceiveFunction;
     delete m_networkClientDisconnectFunction;
 
     delete m_networkServerConnectFunction;
 
+    mono_gchandle_free(m_receiveDataHandle);
+    mono_gchandle_free(m_receivePacketsHandle);
+
     for (uint32_t i = 0; i < m_servers.Size(); ++i)
     {
         if (m_servers.Exists(i))
@@ -116,6 +199,235 @@ NetworkManager::~NetworkManager()
     }
 }
 
+uint64_t NetworkManager::GetTimestamp()
+{
+    return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static constexpr enet_uint32 GetFlags(e_PacketFlags a_flags)
+{
+    enet_uint32 flags = 0;
+    if (a_flags & PacketFlags_Reliable)
+    {
+        flags |= ENET_PACKET_FLAG_RELIABLE;
+    }
+    if (a_flags & PacketFlags_Unsequenced)
+    {
+        flags |= ENET_PACKET_FLAG_UNSEQUENCED;
+    }
+    if (a_flags & PacketFlags_UnreliableFragment)
+    {
+        flags |= ENET_PACKET_FLAG_UNRELIABLE_FRAGMENT;
+    }
+
+    return flags;
+}
+
+void NetworkManager::PushEvent(const NetworkEvent& a_event)
+{
+    // Keep ordering if there is already a backlog
+    if (!m_eventBacklog.Empty() || !m_events.TryPush(a_event))
+    {
+        m_eventBacklog.Push(a_event);
+    }
+}
+void NetworkManager::FlushEventBacklog()
+{
+    const uint32_t count = m_eventBacklog.Size();
+
+    uint32_t pushed = 0;
+    while (pushed < count && m_events.TryPush(m_eventBacklog[pushed]))
+    {
+        ++pushed;
+    }
+
+    if (pushed == count)
+    {
+        m_eventBacklog.Clear();
+    }
+    else if (pushed > 0)
+    {
+        memmove(m_eventBacklog.Data(), m_eventBacklog.Data() + pushed, (count - pushed) * sizeof(NetworkEvent));
+        m_eventBacklog.Resize(count - pushed);
+    }
+}
+
+void NetworkManager::ProcessCommand(const NetworkCommand& a_command)
+{
+    switch (a_command.Type)
+    {
+    case NetworkCommandType_ClientSend:
+    {
+        NetworkClient* client = GetNetworkClient(a_command.Addr);
+        if (client == nullptr)
+        {
+            enet_packet_destroy(a_command.Packet);
+
+            break;
+        }
+
+        client->Send(a_command.Packet, a_command.Channel);
+
+        break;
+    }
+    case NetworkCommandType_ServerSend:
+    {
+        NetworkServer* server = GetNetworkServer(a_command.Addr);
+        if (server == nullptr)
+        {
+            enet_packet_destroy(a_command.Packet);
+
+            break;
+        }
+
+        server->Send(a_command.Packet, a_command.Channel);
+
+        break;
+    }
+    case NetworkCommandType_ServerMulticast:
+    {
+        IDEFER(delete[] a_command.Clients);
+
+        NetworkServer* server = GetNetworkServer(a_command.Addr);
+        if (server == nullptr)
+        {
+            enet_packet_destroy(a_command.Packet);
+
+            break;
+        }
+
+        server->SendTo(a_command.Packet, a_command.Channel, a_command.Clients, a_command.ClientCount);
+
+        break;
+    }
+    case NetworkCommandType_DestroyClient:
+    {
+        NetworkClient* client = GetNetworkClient(a_command.Addr);
+        if (client == nullptr)
+        {
+            break;
+        }
+
+        // Free the slot on the server if the client was kicked rather than disconnected
+        const uint32_t serverAddr = client->GetServerAddress();
+        if (serverAddr != -1)
+        {
+            NetworkServer* server = GetNetworkServer(serverAddr);
+            if (server != nullptr)
+            {
+                server->ReleaseClient(client->GetPeer());
+            }
+        }
+
+        EraseNetworkClient(a_command.Addr);
+
+        break;
+    }
+    case NetworkCommandType_ServerSnapshot:
+    {
+        NetworkServer* server = GetNetworkServer(a_command.Addr);
+        if (server == nullptr)
+        {
+            delete a_command.Snapshot;
+
+            break;
+        }
+
+        server->SendSnapshot(a_command.Snapshot);
+
+        break;
+    }
+    case NetworkCommandType_DestroyServer:
+    {
+        if (!m_servers.Exists(a_command.Addr))
+        {
+            break;
+        }
+
+        const NetworkServer* server = m_servers[a_command.Addr];
+        IDEFER(delete server);
+
+        m_servers.Erase(a_command.Addr);
+
+        break;
+    }
+    default:
+    {
+        ICARIAN_ASSERT_MSG(0, "Invalid network command");
+
+        break;
+    }
+    }
+
+    if (a_command.Timestamp != 0)
+    {
+        const uint32_t latency = (uint32_t)(GetTimestamp() - a_command.Timestamp);
+        const uint32_t average = m_outboundLatency.load(std::memory_order_relaxed);
+
+        m_outboundLatency.store((uint32_t)(average + ((int64_t)latency - average) / 16), std::memory_order_relaxed);
+    }
+}
+
+void NetworkManager::Run()
+{
+    while (!m_shutdown)
+    {
+        const std::chrono::time_point start = std::chrono::high_resolution_clock::now();
+
+        {
+            Profiler::Start("Network Thread");
+            IDEFER(Profiler::Stop());
+
+            FlushEventBacklog();
+
+            {
+                PROFILESTACK("Commands");
+
+                NetworkCommand command;
+                while (m_commands.TryPop(&command))
+                {
+                    ProcessCommand(command);
+                }
+            }
+
+            {
+                PROFILESTACK("Clients");
+
+                const std::vector<bool> states = m_clients.ToStateVector();
+                TReadLockArray<NetworkClient*> clients = m_clients.ToReadLockArray();
+                const uint32_t size = (uint32_t)states.size();
+
+                // Reserved slots are empty until the client has been set up
+                for (uint32_t i = 0; i < size; ++i)
+                {
+                    if (states[i] && clients[i] != nullptr)
+                    {
+                        clients[i]->Update();
+                    }
+                }
+            }
+
+            {
+                PROFILESTACK("Servers");
+
+                const std::vector<bool> states = m_servers.ToStateVector();
+                TReadLockArray<NetworkServer*> servers = m_servers.ToReadLockArray();
+                const uint32_t size = (uint32_t)states.size();
+
+                for (uint32_t i = 0; i < size; ++i)
+                {
+                    if (states[i] && servers[i] != nullptr)
+                    {
+                        servers[i]->Update();
+                    }
+                }
+            }
+        }
+
+        std::this_thread::sleep_until(start + std::chrono::milliseconds(NetworkThreadIntervalMs));
+    }
+}
+
 uint32_t NetworkManager::CreateNetworkClient(const NetworkAddress& a_address)
 {
     if (!m_initialized)
@@ -129,24 +441,54 @@ uint32_t NetworkManager::CreateNetworkClient(const NetworkAddress& a_address)
         return -1;
     }
 
-    const uint32_t addr = m_clients.PushVal(client);
+    // Slot is reserved empty so the address is set before the network thread can see the client
+    const uint32_t addr = m_clients.PushVal(nullptr);
     client->SetBufferAddress(addr);
+    m_clients.LockSet(addr, client);
 
     return addr;
 }
 uint32_t NetworkManager::CreateNetworkClientConnection(uint32_t a_hostAddr, const ENetEvent& a_event)
 {
-    if (!m_initialized)
-    {
-        return -1;
-    }
-
     NetworkClient* client = new NetworkClient(this, a_hostAddr, a_event);
-    const uint32_t addr = m_clients.PushVal(client);
+    const uint32_t addr = m_clients.PushVal(nullptr);
     client->SetBufferAddress(addr);
+    m_clients.LockSet(addr, client);
 
     return addr;
 }
+NetworkServer* NetworkManager::GetNetworkServer(uint32_t a_addr)
+{
+    TReadLockArray<NetworkServer*> a = m_servers.ToReadLockArray();
+    if (a_addr >= a.Size())
+    {
+        return nullptr;
+    }
+
+    return a[a_addr];
+}
+NetworkClient* NetworkManager::GetNetworkClient(uint32_t a_addr)
+{
+    TReadLockArray<NetworkClient*> a = m_clients.ToReadLockArray();
+    if (a_addr >= a.Size())
+    {
+        return nullptr;
+    }
+
+    return a[a_addr];
+}
+void NetworkManager::EraseNetworkClient(uint32_t a_addr)
+{
+    if (!m_clients.Exists(a_addr))
+    {
+        return;
+    }
+
+    const NetworkClient* client = m_clients[a_addr];
+    IDEFER(delete client);
+
+    m_clients.Erase(a_addr);
+}
 void NetworkManager::DestroyNetworkClient(uint32_t a_addr)
 {
     if (!m_initialized)
@@ -157,10 +499,12 @@ void NetworkManager::DestroyNetworkClient(uint32_t a_addr)
     ICARIAN_ASSERT_MSG(a_addr < m_clients.Size(), "DestroyNetworkClient out of bounds.");
     ICARIAN_ASSERT_MSG(m_clients.Exists(a_addr), "DestroyNetworkClient already destroyed.");
 
-    const NetworkClient* client = m_clients[a_addr];
-    IDEFER(delete client);
+    // The network thread owns the connection so it has to be the one to close it
+    NetworkCommand command = { };
+    command.Type = NetworkCommandType_DestroyClient;
+    command.Addr = a_addr;
 
-    m_clients.Erase(a_addr);
+    m_commands.Push(command);
 }
 uint32_t NetworkManager::NetworkClientGetServerAddress(uint32_t a_addr)
 {
@@ -177,7 +521,7 @@ uint32_t NetworkManager::NetworkClientGetServerAddress(uint32_t a_addr)
     return a[a_addr]->GetServerAddress();
 }
 
-void NetworkManager::NetworkClientSend(uint32_t a_addr, const uint8_t* a_data, uint32_t a_size, e_PacketFlags a_flags)
+void NetworkManager::NetworkClientSend(uint32_t a_addr, const uint8_t* a_data, uint32_t a_size, e_PacketFlags a_flags, uint32_t a_channel)
 {
     if (!m_initialized)
     {
@@ -186,12 +530,61 @@ void NetworkManager::NetworkClientSend(uint32_t a_addr, const uint8_t* a_data, u
 
     ICARIAN_ASSERT_MSG(a_addr < m_clients.Size(), "NetworkClientSend out of bounds.");
     ICARIAN_ASSERT_MSG(m_clients.Exists(a_addr), "NetworkClientSend already destroyed.");
+    ICARIAN_ASSERT_MSG(a_channel < NetworkUserChannelCount, "NetworkClientSend invalid channel.");
+
+    NetworkCommand command = { };
+    command.Type = NetworkCommandType_ClientSend;
+    command.Addr = a_addr;
+    command.Channel = a_channel;
+    command.Packet = enet_packet_create(a_data, a_size, GetFlags(a_flags));
+    command.Timestamp = GetTimestamp();
+
+    m_commands.Push(command);
+}
+void NetworkManager::NetworkClientReplicate(uint32_t a_addr, uint32_t a_netID, uint32_t a_transformAddr)
+{
+    if (!m_initialized)
+    {
+        return;
+    }
+
+    ICARIAN_ASSERT_MSG(a_addr < m_clients.Size(), "NetworkClientReplicate out of bounds.");
+    ICARIAN_ASSERT_MSG(m_clients.Exists(a_addr), "NetworkClientReplicate already destroyed.");
+
+    // Held so the network thread cannot destroy the client while it is in use
+    const TReadLockArray<NetworkClient*> a = m_clients.ToReadLockArray();
+
+    a[a_addr]->Replicate(a_netID, a_transformAddr);
+}
+void NetworkManager::NetworkClientStopReplicating(uint32_t a_addr, uint32_t a_netID)
+{
+    if (!m_initialized)
+    {
+        return;
+    }
 
-    TLockArray<NetworkClient*> a = m_clients.ToLockArray();
+    ICARIAN_ASSERT_MSG(a_addr < m_clients.Size(), "NetworkClientStopReplicating out of bounds.");
+    ICARIAN_ASSERT_MSG(m_clients.Exists(a_addr), "NetworkClientStopReplicating already destroyed.");
 
-    NetworkClient* client = a[a_addr];
-    client->Send(a_data, a_size, a_flags);
+    const TReadLockArray<NetworkClient*> a = m_clients.ToReadLockArray();
+
+    a[a_addr]->StopReplicating(a_netID);
 }
+uint32_t NetworkManager::NetworkClientGetReplicatedData(uint32_t a_addr, uint32_t a_netID, uint8_t* a_data)
+{
+    if (!m_initialized)
+    {
+        return -1;
+    }
+
+    ICARIAN_ASSERT_MSG(a_addr < m_clients.Size(), "NetworkClientGetReplicatedData out of bounds.");
+    ICARIAN_ASSERT_MSG(m_clients.Exists(a_addr), "NetworkClientGetReplicatedData already destroyed.");
+
+    const TReadLockArray<NetworkClient*> a = m_clients.ToReadLockArray();
+
+    return a[a_addr]->GetReplicatedData(a_netID, a_data);
+}
+
 void NetworkManager::NetworkClientReceive(uint32_t a_addr, const uint8_t* a_data, uint32_t a_size)
 {
     if (!m_initialized)
@@ -199,21 +592,43 @@ void NetworkManager::NetworkClientReceive(uint32_t a_addr, const uint8_t* a_data
         return;
     }
 
-    MonoDomain* domain = RuntimeManager::GetDomain();
-    MonoArray* array = mono_array_new(domain, mono_get_byte_class(), a_size);
+    const uint32_t offset = m_receiveDataSize;
+    const uint32_t dataSize = offset + a_size;
+    if (dataSize > (uint32_t)mono_array_length(m_receiveData))
+    {
+        m_receiveData = GrowPinnedArray(mono_get_byte_class(), m_receiveData, &m_receiveDataHandle, sizeof(uint8_t), offset, dataSize);
+    }
 
-    for (uint32_t i = 0; i < a_size; ++i)
+    memcpy(mono_array_addr(m_receiveData, uint8_t, offset), a_data, a_size);
+    m_receiveDataSize = dataSize;
+
+    const uint32_t index = m_receivePacketCount * 3;
+    if (index + 3 > (uint32_t)mono_array_length(m_receivePackets))
     {
-        mono_array_set(array, mono_byte, i, a_data[i]);
+        m_receivePackets = GrowPinnedArray(mono_get_uint32_class(), m_receivePackets, &m_receivePacketsHandle, sizeof(uint32_t), index, index + 3);
     }
 
-    void* args[] =
+    uint32_t* packet = mono_array_addr(m_receivePackets, uint32_t, index);
+    packet[0] = a_addr;
+    packet[1] = offset;
+    packet[2] = a_size;
+
+    ++m_receivePacketCount;
+}
+void NetworkManager::FlushReceive()
+{
+    if (m_receivePacketCount == 0)
     {
-        &a_addr,
-        array
-    };
+        return;
+    }
 
-    m_networkClientReceiveFunction->Exec(args);
+    IDEFER(
+    {
+        m_receiveDataSize = 0;
+        m_receivePacketCount = 0;
+    });
+
+    m_networkClientReceiveFunction->Exec(m_receiveData, m_receivePackets, m_receivePacketCount);
 }
 void NetworkManager::NetworkClientDisconnect(uint32_t a_addr, bool a_error)
 {
@@ -222,6 +637,9 @@ void NetworkManager::NetworkClientDisconnect(uint32_t a_addr, bool a_error)
         return;
     }
 
+    // Anything received before the disconnect needs to arrive first
+    FlushReceive();
+
     uint32_t error = (uint32_t)a_error;
 
     void* args[] =
@@ -246,8 +664,10 @@ uint32_t NetworkManager::CreateNetworkServer(uint16_t a_port, uint32_t a_maxClie
         return -1;
     }
 
-    const uint32_t addr = m_servers.PushVal(server);
+    // Slot is reserved empty so the address is set before the network thread can see the server
+    const uint32_t addr = m_servers.PushVal(nullptr);
     server->SetBufferAddress(addr);
+    m_servers.LockSet(addr, server);
 
     return addr;
 }
@@ -261,13 +681,14 @@ void NetworkManager::DestroyNetworkServer(uint32_t a_addr)
     ICARIAN_ASSERT_MSG(a_addr < m_servers.Size(), "DestroyNetworkServer out of bounds.");
     ICARIAN_ASSERT_MSG(m_servers.Exists(a_addr), "DestroyNetworkServer already destroyed.");
 
-    const NetworkServer* server = m_servers[a_addr];
-    IDEFER(delete server);
+    NetworkCommand command = { };
+    command.Type = NetworkCommandType_DestroyServer;
+    command.Addr = a_addr;
 
-    m_servers.Erase(a_addr);
+    m_commands.Push(command);
 }
 
-void NetworkManager::NetworkServerSend(uint32_t a_addr, const uint8_t* a_data, uint32_t a_size, e_PacketFlags a_flags)
+void NetworkManager::NetworkServerSend(uint32_t a_addr, const uint8_t* a_data, uint32_t a_size, e_PacketFlags a_flags, uint32_t a_channel)
 {
     if (!m_initialized)
     {
@@ -276,11 +697,41 @@ void NetworkManager::NetworkServerSend(uint32_t a_addr, const uint8_t* a_data, u
 
     ICARIAN_ASSERT_MSG(a_addr < m_servers.Size(), "NetworkServerSend out of bounds.");
     ICARIAN_ASSERT_MSG(m_servers.Exists(a_addr), "NetworkServerSend already destroyed.");
+    ICARIAN_ASSERT_MSG(a_channel < NetworkUserChannelCount, "NetworkServerSend invalid channel.");
+
+    NetworkCommand command = { };
+    command.Type = NetworkCommandType_ServerSend;
+    command.Addr = a_addr;
+    command.Channel = a_channel;
+    command.Packet = enet_packet_create(a_data, a_size, GetFlags(a_flags));
+    command.Timestamp = GetTimestamp();
+
+    m_commands.Push(command);
+}
+void NetworkManager::NetworkServerSendTo(uint32_t a_addr, const uint32_t* a_clients, uint32_t a_clientCount, const uint8_t* a_data, uint32_t a_size, e_PacketFlags a_flags, uint32_t a_channel)
+{
+    if (!m_initialized || a_clientCount == 0)
+    {
+        return;
+    }
+
+    ICARIAN_ASSERT_MSG(a_addr < m_servers.Size(), "NetworkServerSendTo out of bounds.");
+    ICARIAN_ASSERT_MSG(m_servers.Exists(a_addr), "NetworkServerSendTo already destroyed.");
+    ICARIAN_ASSERT_MSG(a_channel < NetworkUserChannelCount, "NetworkServerSendTo invalid channel.");
+
+    uint32_t* clients = new uint32_t[a_clientCount];
+    memcpy(clients, a_clients, a_clientCount * sizeof(uint32_t));
 
-    TLockArray<NetworkServer*> a = m_servers.ToLockArray();
+    NetworkCommand command = { };
+    command.Type = NetworkCommandType_ServerMulticast;
+    command.Addr = a_addr;
+    command.Channel = a_channel;
+    command.ClientCount = a_clientCount;
+    command.Clients = clients;
+    command.Packet = enet_packet_create(a_data, a_size, GetFlags(a_flags));
+    command.Timestamp = GetTimestamp();
 
-    NetworkServer* server = a[a_addr];
-    server->Send(a_data, a_size, a_flags);
+    m_commands.Push(command);
 }
 void NetworkManager::NetworkServerConnect(uint32_t a_addr, uint32_t a_clientAddr)
 {
@@ -289,6 +740,8 @@ void NetworkManager::NetworkServerConnect(uint32_t a_addr, uint32_t a_clientAddr
         return;
     }
 
+    FlushReceive();
+
     void* args[] =
     {
         &a_addr,
@@ -311,11 +764,11 @@ uint32_t NetworkManager::NetworkServerGetMaxClients(uint32_t a_addr)
 
     return a[a_addr]->GetMaxClients();
 }
-NetworkPeer* NetworkManager::NetworkServerGetClients(uint32_t a_addr)
+Array<uint32_t> NetworkManager::NetworkServerGetClients(uint32_t a_addr)
 {
     if (!m_initialized)
     {
-        return nullptr;
+        return Array<uint32_t>();
     }
 
     ICARIAN_ASSERT_MSG(a_addr < m_servers.Size(), "NetworkServerGetClients out of bounds.");
@@ -323,7 +776,66 @@ NetworkPeer* NetworkManager::NetworkServerGetClients(uint32_t a_addr)
 
     const TReadLockArray<NetworkServer*> a = m_servers.ToReadLockArray();
 
-    return a[a_addr]->GetPeers();
+    return a[a_addr]->GetClientAddresses();
+}
+
+void NetworkManager::NetworkServerReplicate(uint32_t a_addr, uint32_t a_netID, uint32_t a_transformAddr)
+{
+    if (!m_initialized)
+    {
+        return;
+    }
+
+    ICARIAN_ASSERT_MSG(a_addr < m_servers.Size(), "NetworkServerReplicate out of bounds.");
+    ICARIAN_ASSERT_MSG(m_servers.Exists(a_addr), "NetworkServerReplicate already destroyed.");
+
+    const TReadLockArray<NetworkServer*> a = m_servers.ToReadLockArray();
+
+    a[a_addr]->Replicate(a_netID, a_transformAddr);
+}
+void NetworkManager::NetworkServerStopReplicating(uint32_t a_addr, uint32_t a_netID)
+{
+    if (!m_initialized)
+    {
+        return;
+    }
+
+    ICARIAN_ASSERT_MSG(a_addr < m_servers.Size(), "NetworkServerStopReplicating out of bounds.");
+    ICARIAN_ASSERT_MSG(m_servers.Exists(a_addr), "NetworkServerStopReplicating already destroyed.");
+
+    const TReadLockArray<NetworkServer*> a = m_servers.ToReadLockArray();
+
+    a[a_addr]->StopReplicating(a_netID);
+}
+void NetworkManager::NetworkServerSetReplicatedData(uint32_t a_addr, uint32_t a_netID, const uint8_t* a_data, uint32_t a_size)
+{
+    if (!m_initialized)
+    {
+        return;
+    }
+
+    ICARIAN_ASSERT_MSG(a_addr < m_servers.Size(), "NetworkServerSetReplicatedData out of bounds.");
+    ICARIAN_ASSERT_MSG(m_servers.Exists(a_addr), "NetworkServerSetReplicatedData already destroyed.");
+    ICARIAN_ASSERT_MSG(a_size <= ReplicationMaxDataSize, "NetworkServerSetReplicatedData data too large.");
+
+    const TReadLockArray<NetworkServer*> a = m_servers.ToReadLockArray();
+
+    a[a_addr]->SetReplicatedData(a_netID, a_data, a_size);
+}
+void NetworkManager::NetworkServerSetSnapshotRate(uint32_t a_addr, uint32_t a_rate)
+{
+    if (!m_initialized)
+    {
+        return;
+    }
+
+    ICARIAN_ASSERT_MSG(a_addr < m_servers.Size(), "NetworkServerSetSnapshotRate out of bounds.");
+    ICARIAN_ASSERT_MSG(m_servers.Exists(a_addr), "NetworkServerSetSnapshotRate already destroyed.");
+    ICARIAN_ASSERT_MSG(a_rate > 0, "NetworkServerSetSnapshotRate rate must be greater than 0.");
+
+    const TReadLockArray<NetworkServer*> a = m_servers.ToReadLockArray();
+
+    a[a_addr]->SetSnapshotRate(a_rate);
 }
 
 void NetworkManager::Update()
@@ -333,33 +845,109 @@ void NetworkManager::Update()
         return;
     }
 
+    const uint64_t now = GetTimestamp();
+
+    NetworkEvent event;
+    while (m_events.TryPop(&event))
     {
-        const std::vector<bool> states = m_clients.ToStateVector();
-        TLockArray<NetworkClient*> clients = m_clients.ToLockArray();
-        const uint32_t size = (uint32_t)states.size();
+        const float latency = (float)(now - event.Timestamp);
+        m_inboundLatency += (latency - m_inboundLatency) * 0.0625f;
 
-        for (uint32_t i = 0; i < size; ++i)
+        switch (event.Type)
+        {
+        case NetworkEventType_Connect:
         {
-            if (states[i])
+            NetworkServerConnect(event.Addr, event.ClientAddr);
+
+            break;
+        }
+        case NetworkEventType_Receive:
+        {
+            IDEFER(enet_packet_destroy(event.Packet));
+
+            NetworkClientReceive(event.Addr, (uint8_t*)event.Packet->data, (uint32_t)event.Packet->dataLength);
+
+            break;
+        }
+        case NetworkEventType_Disconnect:
+        {
+            NetworkClientDisconnect(event.Addr, event.Error != 0);
+
+            // Server side connections only live as long as the peer
+            if (event.ServerAddr != -1 && m_clients.Exists(event.Addr))
             {
-                clients[i]->Update();
+                DestroyNetworkClient(event.Addr);
             }
+
+            break;
+        }
+        default:
+        {
+            ICARIAN_ASSERT_MSG(0, "Invalid network event");
+
+            break;
+        }
         }
     }
-    
+
+    FlushReceive();
+
     {
-        const std::vector<bool> states = m_servers.ToStateVector();
-        TLockArray<NetworkServer*> servers = m_servers.ToLockArray();
-        const uint32_t size = (uint32_t)states.size();
+        PROFILESTACK("Replication Apply");
+
+        const TReadLockArray<NetworkClient*> clients = m_clients.ToReadLockArray();
+        const uint32_t size = clients.Size();
 
         for (uint32_t i = 0; i < size; ++i)
         {
-            if (states[i])
+            NetworkClient* client = clients[i];
+            if (client != nullptr)
+            {
+                client->ApplySnapshot();
+            }
+        }
+    }
+
+    {
+        PROFILESTACK("Replication Snapshots");
+
+        // Captured on the game thread so every object in a snapshot is from the same frame
+        // The network thread can destroy a server at any point so only go off what is visible under the read lock
+        // Erased slots are cleared so a null check is enough
+        Array<NetworkCommand> commands;
+        {
+            const TReadLockArray<NetworkServer*> servers = m_servers.ToReadLockArray();
+            const uint32_t size = servers.Size();
+
+            for (uint32_t i = 0; i < size; ++i)
             {
-                servers[i]->Update();
+                NetworkServer* server = servers[i];
+                if (server == nullptr)
+                {
+                    continue;
+                }
+
+                ReplicationSnapshot* snapshot = server->CaptureSnapshot(now);
+                if (snapshot == nullptr)
+                {
+                    continue;
+                }
+
+                NetworkCommand command = { };
+                command.Type = NetworkCommandType_ServerSnapshot;
+                command.Addr = i;
+                command.Snapshot = snapshot;
+
+                commands.Push(command);
             }
         }
-    }   
+
+        // Pushing waits on a full queue and the network thread needs the write lock to destroy servers so only push once the lock is released
+        for (const NetworkCommand& command : commands)
+        {
+            m_commands.Push(command);
+        }
+    }
 }
 
 // MIT License
@@ -0,0 +1,528 @@
+// Icarian Engine - C# Game Engine
+// 
+// License at end of file.
+
+#include "Networking/NetworkReplication.h"
+
+#include <cmath>
+#include <cstring>
+
+#include "ObjectManager.h"
+
+static constexpr float RotationRange = 0.70710678f;
+static constexpr uint32_t RotationMask = 0x3FF;
+// Even step count so zero lands exactly on a step
+static constexpr float RotationScale = (float)(RotationMask - 1);
+
+// Tick, base tick and entry count
+static constexpr uint32_t HeaderSize = sizeof(uint32_t) * 3;
+
+ReplicationHistory::ReplicationHistory()
+{
+    for (uint32_t i = 0; i < ReplicationHistorySize; ++i)
+    {
+        m_snapshots[i] = nullptr;
+    }
+
+    m_latestTick = 0;
+}
+ReplicationHistory::~ReplicationHistory()
+{
+    for (uint32_t i = 0; i < ReplicationHistorySize; ++i)
+    {
+        if (m_snapshots[i] != nullptr)
+        {
+            delete m_snapshots[i];
+        }
+    }
+}
+
+const ReplicationSnapshot* ReplicationHistory::GetSnapshot(uint32_t a_tick) const
+{
+    // Tick 0 is used for no base
+    if (a_tick == 0)
+    {
+        return nullptr;
+    }
+
+    const ReplicationSnapshot* snapshot = m_snapshots[a_tick % ReplicationHistorySize];
+    if (snapshot == nullptr || snapshot->Tick != a_tick)
+    {
+        return nullptr;
+    }
+
+    return snapshot;
+}
+void ReplicationHistory::Push(ReplicationSnapshot* a_snapshot)
+{
+    const uint32_t index = a_snapshot->Tick % ReplicationHistorySize;
+    if (m_snapshots[index] != nullptr)
+    {
+        delete m_snapshots[index];
+    }
+
+    m_snapshots[index] = a_snapshot;
+
+    if (a_snapshot->Tick > m_latestTick)
+    {
+        m_latestTick = a_snapshot->Tick;
+    }
+}
+
+static int32_t QuantizeFixed(float a_value, uint32_t a_bits)
+{
+    return (int32_t)std::round(a_value * (float)(1 << a_bits));
+}
+static float DequantizeFixed(int32_t a_value, uint32_t a_bits)
+{
+    return (float)a_value / (float)(1 << a_bits);
+}
+
+static uint32_t QuantizeRotation(const glm::quat& a_rotation)
+{
+    const glm::quat q = glm::normalize(a_rotation);
+
+    uint32_t largest = 0;
+    for (uint32_t i = 1; i < 4; ++i)
+    {
+        if (std::abs(q[i]) > std::abs(q[largest]))
+        {
+            largest = i;
+        }
+    }
+
+    // q and -q are the same rotation so the dropped component can always be positive
+    const float sign = q[largest] < 0.0f ? -1.0f : 1.0f;
+
+    uint32_t packed = largest << 30;
+    uint32_t shift = 20;
+    for (uint32_t i = 0; i < 4; ++i)
+    {
+        if (i == largest)
+        {
+            continue;
+        }
+
+        const float n = glm::clamp((q[i] * sign / RotationRange) * 0.5f + 0.5f, 0.0f, 1.0f);
+        packed |= ((uint32_t)std::round(n * RotationScale) & RotationMask) << shift;
+
+        shift -= 10;
+    }
+
+    return packed;
+}
+static glm::quat DequantizeRotation(uint32_t a_packed)
+{
+    const uint32_t largest = a_packed >> 30;
+
+    glm::quat q;
+
+    float sum = 0.0f;
+    uint32_t shift = 20;
+    for (uint32_t i = 0; i < 4; ++i)
+    {
+        if (i == largest)
+        {
+            continue;
+        }
+
+        const float n = (float)((a_packed >> shift) & RotationMask) / RotationScale;
+        q[i] = (n * 2.0f - 1.0f) * RotationRange;
+        sum += q[i] * q[i];
+
+        shift -= 10;
+    }
+
+    q[largest] = std::sqrt(glm::max(0.0f, 1.0f - sum));
+
+    return glm::normalize(q);
+}
+
+void ReplicationQuantize(uint32_t a_netID, const TransformBuffer& a_transform, const uint8_t* a_data, uint32_t a_dataSize, ReplicationState* a_state)
+{
+    a_state->NetID = a_netID;
+
+    for (uint32_t i = 0; i < 3; ++i)
+    {
+        a_state->Translation[i] = QuantizeFixed(a_transform.Translation[i], ReplicationTranslationBits);
+        a_state->Scale[i] = QuantizeFixed(a_transform.Scale[i], ReplicationScaleBits);
+    }
+
+    a_state->Rotation = QuantizeRotation(a_transform.Rotation);
+
+    a_state->DataSize = glm::min(a_dataSize, ReplicationMaxDataSize);
+    memset(a_state->Data, 0, ReplicationMaxDataSize);
+    if (a_state->DataSize > 0)
+    {
+        memcpy(a_state->Data, a_data, a_state->DataSize);
+    }
+}
+void ReplicationDequantize(const ReplicationState& a_state, TransformBuffer* a_transform)
+{
+    for (uint32_t i = 0; i < 3; ++i)
+    {
+        a_transform->Translation[i] = DequantizeFixed(a_state.Translation[i], ReplicationTranslationBits);
+        a_transform->Scale[i] = DequantizeFixed(a_state.Scale[i], ReplicationScaleBits);
+    }
+
+    a_transform->Rotation = DequantizeRotation(a_state.Rotation);
+}
+
+// State objects start from when they are not in the base
+static ReplicationState GetDefaultState(uint32_t a_netID)
+{
+    ReplicationState state = { };
+    state.NetID = a_netID;
+    state.Rotation = QuantizeRotation(glm::identity<glm::quat>());
+
+    for (uint32_t i = 0; i < 3; ++i)
+    {
+        state.Scale[i] = 1 << ReplicationScaleBits;
+    }
+
+    return state;
+}
+
+static void WriteBytes(Array<uint8_t>* a_out, const void* a_data, uint32_t a_size)
+{
+    const uint32_t offset = a_out->Size();
+    a_out->Resize(offset + a_size);
+
+    memcpy(a_out->Data() + offset, a_data, a_size);
+}
+static void WriteVarInt(Array<uint8_t>* a_out, uint32_t a_value)
+{
+    while (a_value >= 0x80)
+    {
+        a_out->Push((uint8_t)(a_value | 0x80));
+        a_value >>= 7;
+    }
+
+    a_out->Push((uint8_t)a_value);
+}
+// Zig zag so small negative deltas stay small, wraps so any pair of values round trips
+static void WriteDelta(Array<uint8_t>* a_out, int32_t a_base, int32_t a_value)
+{
+    const int32_t delta = (int32_t)((uint32_t)a_value - (uint32_t)a_base);
+
+    WriteVarInt(a_out, ((uint32_t)delta << 1) ^ (uint32_t)(delta >> 31));
+}
+
+class ReplicationReader
+{
+private:
+    const uint8_t* m_data;
+    uint32_t       m_size;
+    uint32_t       m_offset;
+    bool           m_valid;
+
+protected:
+
+public:
+    ReplicationReader(const uint8_t* a_data, uint32_t a_size)
+    {
+        m_data = a_data;
+        m_size = a_size;
+        m_offset = 0;
+        m_valid = true;
+    }
+
+    inline bool IsValid() const
+    {
+        return m_valid;
+    }
+
+    bool ReadBytes(void* a_out, uint32_t a_size)
+    {
+        if (!m_valid || m_offset + a_size > m_size)
+        {
+            m_valid = false;
+
+            return false;
+        }
+
+        memcpy(a_out, m_data + m_offset, a_size);
+        m_offset += a_size;
+
+        return true;
+    }
+    uint32_t ReadVarInt()
+    {
+        uint32_t value = 0;
+        for (uint32_t shift = 0; shift < 35; shift += 7)
+        {
+            uint8_t byte;
+            if (!ReadBytes(&byte, 1))
+            {
+                return 0;
+            }
+
+            value |= (uint32_t)(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0)
+            {
+                return value;
+            }
+        }
+
+        m_valid = false;
+
+        return 0;
+    }
+    int32_t ReadDelta(int32_t a_base)
+    {
+        const uint32_t zigzag = ReadVarInt();
+        const uint32_t delta = (zigzag >> 1) ^ (0 - (zigzag & 0b1));
+
+        return (int32_t)((uint32_t)a_base + delta);
+    }
+};
+
+static void WriteEntry(Array<uint8_t>* a_out, uint32_t* a_prevNetID, const ReplicationState& a_base, const ReplicationState& a_state, bool a_force)
+{
+    uint8_t mask = 0;
+    if (memcmp(a_base.Translation, a_state.Translation, sizeof(a_state.Translation)) != 0)
+    {
+        mask |= ReplicationField_Translation;
+    }
+    if (a_base.Rotation != a_state.Rotation)
+    {
+        mask |= ReplicationField_Rotation;
+    }
+    if (memcmp(a_base.Scale, a_state.Scale, sizeof(a_state.Scale)) != 0)
+    {
+        mask |= ReplicationField_Scale;
+    }
+    if (a_base.DataSize != a_state.DataSize || memcmp(a_base.Data, a_state.Data, a_state.DataSize) != 0)
+    {
+        mask |= ReplicationField_Data;
+    }
+
+    if (mask == 0 && !a_force)
+    {
+        return;
+    }
+
+    WriteVarInt(a_out, a_state.NetID - *a_prevNetID);
+    *a_prevNetID = a_state.NetID;
+
+    a_out->Push(mask);
+
+    if (mask & ReplicationField_Translation)
+    {
+        for (uint32_t i = 0; i < 3; ++i)
+        {
+            WriteDelta(a_out, a_base.Translation[i], a_state.Translation[i]);
+        }
+    }
+    if (mask & ReplicationField_Rotation)
+    {
+        WriteBytes(a_out, &a_state.Rotation, sizeof(uint32_t));
+    }
+    if (mask & ReplicationField_Scale)
+    {
+        for (uint32_t i = 0; i < 3; ++i)
+        {
+            WriteDelta(a_out, a_base.Scale[i], a_state.Scale[i]);
+        }
+    }
+    if (mask & ReplicationField_Data)
+    {
+        WriteVarInt(a_out, a_state.DataSize);
+        WriteBytes(a_out, a_state.Data, a_state.DataSize);
+    }
+}
+
+void ReplicationEncodeDelta(const ReplicationSnapshot* a_base, const ReplicationSnapshot& a_snapshot, Array<uint8_t>* a_out)
+{
+    a_out->Clear();
+    a_out->Resize(HeaderSize);
+
+    const uint32_t baseTick = a_base != nullptr ? a_base->Tick : 0;
+
+    uint8_t* header = a_out->Data();
+    memcpy(header, &a_snapshot.Tick, sizeof(uint32_t));
+    memcpy(header + sizeof(uint32_t), &baseTick, sizeof(uint32_t));
+
+    const uint32_t baseCount = a_base != nullptr ? a_base->States.Size() : 0;
+    const uint32_t count = a_snapshot.States.Size();
+
+    uint32_t entries = 0;
+    uint32_t prevNetID = 0;
+
+    uint32_t i = 0;
+    uint32_t j = 0;
+    while (i < baseCount || j < count)
+    {
+        const uint32_t start = a_out->Size();
+
+        if (j < count && (i >= baseCount || a_snapshot.States[j].NetID < a_base->States[i].NetID))
+        {
+            // New objects are always written so the receiver knows they exist
+            const ReplicationState& state = a_snapshot.States[j++];
+
+            WriteEntry(a_out, &prevNetID, GetDefaultState(state.NetID), state, true);
+        }
+        else if (i < baseCount && (j >= count || a_base->States[i].NetID < a_snapshot.States[j].NetID))
+        {
+            const ReplicationState& state = a_base->States[i++];
+
+            WriteVarInt(a_out, state.NetID - prevNetID);
+            prevNetID = state.NetID;
+
+            a_out->Push(ReplicationField_Removed);
+        }
+        else
+        {
+            WriteEntry(a_out, &prevNetID, a_base->States[i++], a_snapshot.States[j++], false);
+        }
+
+        if (a_out->Size() != start)
+        {
+            ++entries;
+        }
+    }
+
+    memcpy(a_out->Data() + sizeof(uint32_t) * 2, &entries, sizeof(uint32_t));
+}
+
+ReplicationSnapshot* ReplicationDecodeDelta(const ReplicationHistory& a_history, const uint8_t* a_data, uint32_t a_size)
+{
+    ReplicationReader reader = ReplicationReader(a_data, a_size);
+
+    uint32_t tick;
+    uint32_t baseTick;
+    uint32_t entries;
+    reader.ReadBytes(&tick, sizeof(uint32_t));
+    reader.ReadBytes(&baseTick, sizeof(uint32_t));
+    reader.ReadBytes(&entries, sizeof(uint32_t));
+    if (!reader.IsValid() || tick == 0)
+    {
+        return nullptr;
+    }
+
+    const ReplicationSnapshot* base = a_history.GetSnapshot(baseTick);
+    if (baseTick != 0 && base == nullptr)
+    {
+        return nullptr;
+    }
+
+    const uint32_t baseCount = base != nullptr ? base->States.Size() : 0;
+
+    ReplicationSnapshot* snapshot = new ReplicationSnapshot();
+    snapshot->Tick = tick;
+    if (baseCount > 0)
+    {
+        snapshot->States.Reserve(baseCount);
+    }
+
+    uint32_t i = 0;
+    uint32_t netID = 0;
+    for (uint32_t e = 0; e < entries; ++e)
+    {
+        const uint32_t netIDDelta = reader.ReadVarInt();
+        uint8_t mask = 0;
+        reader.ReadBytes(&mask, 1);
+
+        // Entries are sorted so anything else has to be malformed
+        if (!reader.IsValid() || (e > 0 && netIDDelta == 0))
+        {
+            delete snapshot;
+
+            return nullptr;
+        }
+
+        netID += netIDDelta;
+
+        // Anything skipped over did not change
+        while (i < baseCount && base->States[i].NetID < netID)
+        {
+            snapshot->States.Push(base->States[i++]);
+        }
+
+        ReplicationState state;
+        if (i < baseCount && base->States[i].NetID == netID)
+        {
+            state = base->States[i++];
+        }
+        else
+        {
+            state = GetDefaultState(netID);
+        }
+
+        if (mask & ReplicationField_Removed)
+        {
+            continue;
+        }
+
+        if (mask & ReplicationField_Translation)
+        {
+            for (uint32_t k = 0; k < 3; ++k)
+            {
+                state.Translation[k] = reader.ReadDelta(state.Translation[k]);
+            }
+        }
+        if (mask & ReplicationField_Rotation)
+        {
+            reader.ReadBytes(&state.Rotation, sizeof(uint32_t));
+        }
+        if (mask & ReplicationField_Scale)
+        {
+            for (uint32_t k = 0; k < 3; ++k)
+            {
+                state.Scale[k] = reader.ReadDelta(state.Scale[k]);
+            }
+        }
+        if (mask & ReplicationField_Data)
+        {
+            state.DataSize = reader.ReadVarInt();
+            if (state.DataSize > ReplicationMaxDataSize)
+            {
+                delete snapshot;
+
+                return nullptr;
+            }
+
+            memset(state.Data, 0, ReplicationMaxDataSize);
+            reader.ReadBytes(state.Data, state.DataSize);
+        }
+
+        if (!reader.IsValid())
+        {
+            delete snapshot;
+
+            return nullptr;
+        }
+
+        snapshot->States.Push(state);
+    }
+
+    while (i < baseCount)
+    {
+        snapshot->States.Push(base->States[i++]);
+    }
+
+    return snapshot;
+}
+
+
+// MIT License
+// 
+// Copyright (c) 2024 River Govers
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
\ No newline at end of file
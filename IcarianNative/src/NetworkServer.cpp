@@ -7,37 +7,32 @@
 #include <cstring>
 
 #include "Core/IcarianDefer.h"
+#include "DataTypes/ThreadGuard.h"
+#include "Networking/NetworkClient.h"
 #include "Networking/NetworkManager.h"
+#include "ObjectManager.h"
 
-constexpr static enet_uint32 GetFlags(e_PacketFlags a_flags)
-{
-    enet_uint32 flags = 0;
-    if (a_flags & PacketFlags_Reliable)
-    {
-        flags |= ENET_PACKET_FLAG_RELIABLE;
-    }
-    if (a_flags & PacketFlags_Unsequenced)
-    {
-        flags |= ENET_PACKET_FLAG_UNSEQUENCED;
-    }
-    if (a_flags & PacketFlags_UnreliableFragment)
-    {
-        flags |= ENET_PACKET_FLAG_UNRELIABLE_FRAGMENT;
-    }
-
-    return flags;
-}
+static constexpr uint32_t DefaultSnapshotRate = 20;
 
 NetworkServer::NetworkServer(uint32_t a_maxClients)
 {
     m_maxClients = a_maxClients;
 
     m_peers = new NetworkPeer[m_maxClients];
+    m_freeSlots.Resize(m_maxClients);
     for (uint32_t i = 0; i < m_maxClients; ++i)
     {
         m_peers[i].Addr = -1;
         m_peers[i].Peer = NULL;
+        m_peers[i].AckTick = 0;
+
+        // Taken from the back so hand out the lowest slots first
+        m_freeSlots[i] = m_maxClients - i - 1;
     }
+
+    m_tick = 0;
+    m_snapshotInterval = 1000000 / DefaultSnapshotRate;
+    m_nextSnapshot = 0;
 }
 NetworkServer::~NetworkServer()
 {
@@ -45,7 +40,7 @@ NetworkServer::~NetworkServer()
     {
         if (m_peers[i].Addr != -1)
         {
-            m_manager->DestroyNetworkClient(m_peers[i].Addr);
+            m_manager->EraseNetworkClient(m_peers[i].Addr);
         }
     }
 
@@ -63,7 +58,7 @@ NetworkServer* NetworkServer::Create(NetworkManager* a_manager, uint16_t a_port,
     address.host = ENET_HOST_ANY;
     address.port = a_port;
 
-    ENetHost* host = enet_host_create(&address, a_maxClients, 2, 0, 0);
+    ENetHost* host = enet_host_create(&address, a_maxClients, NetworkChannelCount, 0, 0);
     if (host == NULL)
     {
         return NULL;
@@ -76,12 +71,227 @@ NetworkServer* NetworkServer::Create(NetworkManager* a_manager, uint16_t a_port,
     return server;
 }
 
-void NetworkServer::Send(const uint8_t* a_data, uint32_t a_size, e_PacketFlags a_flags)
+void NetworkServer::Send(ENetPacket* a_packet, uint32_t a_channel)
+{
+    // Broadcast cleans up the packet itself if there is no one to send to
+    enet_host_broadcast(m_host, (enet_uint8)a_channel, a_packet);
+}
+void NetworkServer::SendTo(ENetPacket* a_packet, uint32_t a_channel, const uint32_t* a_clients, uint32_t a_clientCount)
+{
+    // Each send adds a reference so every peer shares the one packet
+    for (uint32_t i = 0; i < a_clientCount; ++i)
+    {
+        const NetworkClient* client = m_manager->GetNetworkClient(a_clients[i]);
+        if (client == nullptr || client->GetServerAddress() != m_addr)
+        {
+            continue;
+        }
+
+        ENetPeer* peer = client->GetPeer();
+        if (peer != NULL)
+        {
+            enet_peer_send(peer, (enet_uint8)a_channel, a_packet);
+        }
+    }
+
+    // Nothing took a reference so it is still ours
+    if (a_packet->referenceCount == 0)
+    {
+        enet_packet_destroy(a_packet);
+    }
+}
+
+uint32_t NetworkServer::GetPeerSlot(const ENetPeer* a_peer) const
+{
+    // Peers point back at their slot so no need to search for them
+    if (a_peer == NULL || a_peer->data == NULL)
+    {
+        return -1;
+    }
+
+    return (uint32_t)((const NetworkPeer*)a_peer->data - m_peers);
+}
+void NetworkServer::FreePeerSlot(uint32_t a_slot)
+{
+    NetworkPeer& peer = m_peers[a_slot];
+    if (peer.Peer != NULL)
+    {
+        peer.Peer->data = NULL;
+    }
+
+    {
+        const ThreadGuard g = ThreadGuard(m_peerLock);
+
+        peer.Addr = -1;
+    }
+    peer.Peer = NULL;
+    peer.AckTick = 0;
+
+    m_freeSlots.Push(a_slot);
+}
+void NetworkServer::DisconnectPeer(uint32_t a_slot, bool a_error)
+{
+    NetworkPeer& peer = m_peers[a_slot];
+
+    NetworkClient* client = m_manager->GetNetworkClient(peer.Addr);
+    if (client != nullptr)
+    {
+        client->ClearPeer();
+    }
+
+    // Client is destroyed by the game thread after managed code has been told
+    NetworkEvent e = { };
+    e.Type = NetworkEventType_Disconnect;
+    e.Addr = peer.Addr;
+    e.ServerAddr = m_addr;
+    e.Error = (uint32_t)a_error;
+    e.Timestamp = NetworkManager::GetTimestamp();
+
+    m_manager->PushEvent(e);
+
+    FreePeerSlot(a_slot);
+}
+Array<uint32_t> NetworkServer::GetClientAddresses()
+{
+    Array<uint32_t> addresses;
+    addresses.Resize(m_maxClients);
+
+    const ThreadGuard g = ThreadGuard(m_peerLock);
+
+    for (uint32_t i = 0; i < m_maxClients; ++i)
+    {
+        addresses[i] = m_peers[i].Addr;
+    }
+
+    return addresses;
+}
+
+void NetworkServer::ReleaseClient(ENetPeer* a_peer)
+{
+    const uint32_t slot = GetPeerSlot(a_peer);
+    if (slot != -1)
+    {
+        FreePeerSlot(slot);
+    }
+}
+
+uint32_t NetworkServer::GetReplicatedIndex(uint32_t a_netID) const
+{
+    // Lower bound so it doubles as the insert position
+    uint32_t low = 0;
+    uint32_t high = m_replicated.Size();
+    while (low < high)
+    {
+        const uint32_t mid = (low + high) / 2;
+        if (m_replicated[mid].NetID < a_netID)
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+
+    return low;
+}
+void NetworkServer::Replicate(uint32_t a_netID, uint32_t a_transformAddr)
+{
+    const uint32_t index = GetReplicatedIndex(a_netID);
+    if (index < m_replicated.Size() && m_replicated[index].NetID == a_netID)
+    {
+        m_replicated[index].TransformAddr = a_transformAddr;
+
+        return;
+    }
+
+    ReplicatedObject obj = { };
+    obj.NetID = a_netID;
+    obj.TransformAddr = a_transformAddr;
+
+    m_replicated.Insert(index, obj);
+}
+void NetworkServer::StopReplicating(uint32_t a_netID)
+{
+    const uint32_t index = GetReplicatedIndex(a_netID);
+    if (index < m_replicated.Size() && m_replicated[index].NetID == a_netID)
+    {
+        m_replicated.Erase(index);
+    }
+}
+void NetworkServer::SetReplicatedData(uint32_t a_netID, const uint8_t* a_data, uint32_t a_size)
+{
+    const uint32_t index = GetReplicatedIndex(a_netID);
+    if (index >= m_replicated.Size() || m_replicated[index].NetID != a_netID)
+    {
+        return;
+    }
+
+    ReplicatedObject& obj = m_replicated[index];
+    obj.DataSize = a_size < ReplicationMaxDataSize ? a_size : ReplicationMaxDataSize;
+    if (obj.DataSize > 0)
+    {
+        memcpy(obj.Data, a_data, obj.DataSize);
+    }
+}
+void NetworkServer::SetSnapshotRate(uint32_t a_rate)
 {
-    const enet_uint32 flags = GetFlags(a_flags);
+    m_snapshotInterval = 1000000 / (uint64_t)a_rate;
+}
+
+ReplicationSnapshot* NetworkServer::CaptureSnapshot(uint64_t a_timestamp)
+{
+    if (a_timestamp < m_nextSnapshot)
+    {
+        return nullptr;
+    }
+
+    // Nothing has been replicated yet so no point sending empty snapshots
+    if (m_tick == 0 && m_replicated.Empty())
+    {
+        return nullptr;
+    }
+
+    m_nextSnapshot = a_timestamp + m_snapshotInterval;
+
+    const uint32_t count = m_replicated.Size();
+
+    ReplicationSnapshot* snapshot = new ReplicationSnapshot();
+    snapshot->Tick = ++m_tick;
+    snapshot->States.Resize(count);
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        const ReplicatedObject& obj = m_replicated[i];
+
+        ReplicationQuantize(obj.NetID, ObjectManager::GetTransformBuffer(obj.TransformAddr), obj.Data, obj.DataSize, &snapshot->States[i]);
+    }
+
+    return snapshot;
+}
+void NetworkServer::SendSnapshot(ReplicationSnapshot* a_snapshot)
+{
+    m_history.Push(a_snapshot);
+
+    for (uint32_t i = 0; i < m_maxClients; ++i)
+    {
+        const NetworkPeer& peer = m_peers[i];
+        if (peer.Peer == NULL)
+        {
+            continue;
+        }
+
+        // Falls back to a full snapshot if the ack has dropped out of the history
+        const ReplicationSnapshot* base = m_history.GetSnapshot(peer.AckTick);
+        ReplicationEncodeDelta(base, *a_snapshot, &m_replicationBuffer);
 
-    ENetPacket* packet = enet_packet_create(a_data, a_size, flags);
-    enet_host_broadcast(m_host, 0, packet);
+        // Newer snapshots supersede lost ones so there is no need for reliable
+        ENetPacket* packet = enet_packet_create(m_replicationBuffer.Data(), m_replicationBuffer.Size(), ENET_PACKET_FLAG_UNRELIABLE_FRAGMENT);
+        if (enet_peer_send(peer.Peer, ReplicationChannel, packet) < 0)
+        {
+            enet_packet_destroy(packet);
+        }
+    }
 }
 
 void NetworkServer::Update()
@@ -95,57 +305,94 @@ void NetworkServer::Update()
         {
         case ENET_EVENT_TYPE_CONNECT:
         {
-            for (uint32_t i = 0; i < m_maxClients; ++i)
+            const uint32_t freeCount = m_freeSlots.Size();
+            if (freeCount == 0)
             {
-                if (m_peers[i].Addr == -1)
-                {
-                    const uint32_t addr = m_manager->CreateNetworkClientConnection(m_addr, event);
+                enet_peer_reset(event.peer);
 
-                    m_peers[i].Addr = addr;
-                    m_peers[i].Peer = event.peer;
+                break;
+            }
 
-                    m_manager->NetworkServerConnect(m_addr, addr);
+            const uint32_t slot = m_freeSlots[freeCount - 1];
+            m_freeSlots.Resize(freeCount - 1);
 
-                    break;
-                }
+            const uint32_t addr = m_manager->CreateNetworkClientConnection(m_addr, event);
+
+            {
+                const ThreadGuard g = ThreadGuard(m_peerLock);
+
+                m_peers[slot].Addr = addr;
             }
+            m_peers[slot].Peer = event.peer;
+            m_peers[slot].AckTick = 0;
+
+            event.peer->data = &m_peers[slot];
+
+            NetworkEvent e = { };
+            e.Type = NetworkEventType_Connect;
+            e.Addr = m_addr;
+            e.ClientAddr = addr;
+            e.ServerAddr = m_addr;
+            e.Timestamp = NetworkManager::GetTimestamp();
+
+            m_manager->PushEvent(e);
 
             break;
         }
         case ENET_EVENT_TYPE_RECEIVE:
         {
-            IDEFER(enet_packet_destroy(event.packet));
+            const uint32_t slot = GetPeerSlot(event.peer);
+            if (slot == -1)
+            {
+                enet_packet_destroy(event.packet);
+
+                break;
+            }
 
-            for (uint32_t i = 0; i < m_maxClients; ++i)
+            if (event.channelID == ReplicationChannel)
             {
-                if (m_peers[i].Peer == event.peer)
-                {
-                    m_manager->NetworkClientReceive(m_peers[i].Addr, (uint8_t*)event.packet->data, (uint32_t)event.packet->dataLength);
+                IDEFER(enet_packet_destroy(event.packet));
 
-                    break;
+                // Acks can arrive out of order so only ever move forward
+                uint32_t tick;
+                if (event.packet->dataLength == sizeof(uint32_t))
+                {
+                    memcpy(&tick, event.packet->data, sizeof(uint32_t));
+                    if (tick > m_peers[slot].AckTick && tick <= m_tick)
+                    {
+                        m_peers[slot].AckTick = tick;
+                    }
                 }
+
+                break;
             }
 
+            // Packet is destroyed by the game thread once it has been handed to managed code
+            NetworkEvent e = { };
+            e.Type = NetworkEventType_Receive;
+            e.Addr = m_peers[slot].Addr;
+            e.ServerAddr = m_addr;
+            e.Packet = event.packet;
+            e.Timestamp = NetworkManager::GetTimestamp();
+
+            m_manager->PushEvent(e);
+
             break;
         }
         case ENET_EVENT_TYPE_DISCONNECT:
         {
-            for (uint32_t i = 0; i < m_maxClients; ++i)
+            const uint32_t slot = GetPeerSlot(event.peer);
+            if (slot != -1)
             {
-                if (m_peers[i].Peer == event.peer)
-                {
-                    m_manager->NetworkClientDisconnect(m_peers[i].Addr);
-                    m_manager->DestroyNetworkClient(m_peers[i].Addr);
-
-                    m_peers[i].Addr = -1;
-                    m_peers[i].Peer = NULL;
-
-                    break;
-                }
+                DisconnectPeer(slot, false);
             }
 
             break;
         }
+        default:
+        {
+            break;
+        }
         }
 
         ret = enet_host_service(m_host, &event, 0);
@@ -158,18 +405,10 @@ void NetworkServer::Update()
             return;
         }
 
-        for (uint32_t i = 0; i < m_maxClients; ++i)
+        const uint32_t slot = GetPeerSlot(event.peer);
+        if (slot != -1)
         {
-            if (m_peers[i].Peer == event.peer)
-            {
-                m_manager->NetworkClientDisconnect(m_peers[i].Addr, true);
-                m_manager->DestroyNetworkClient(m_peers[i].Addr);
-
-                m_peers[i].Addr = -1;
-                m_peers[i].Peer = NULL;
-
-                break;
-            }
+            DisconnectPeer(slot, true);
         }
     }
 }
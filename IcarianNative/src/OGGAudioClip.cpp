@@ -4,13 +4,97 @@
 
 #include "Audio/AudioClips/OGGAudioClip.h"
 
-#include "DataTypes/RingAllocator.h"
+#define GLM_FORCE_SWIZZLE 
+#include <glm/glm.hpp>
+
+#include <string.h>
+
+#include "Core/IcarianDefer.h"
+#include "DataTypes/FrameAllocator.h"
+#include "FileCache.h"
+#include "IcarianError.h"
+
+OGGAudioDecoder::OGGAudioDecoder(const uint8_t* a_data, uint64_t a_size, uint32_t a_channelCount)
+{
+    m_channelCount = a_channelCount;
+    m_sampleOffset = 0;
+
+    m_stream = stb_vorbis_open_memory(a_data, (int)a_size, NULL, NULL);
+}
+OGGAudioDecoder::~OGGAudioDecoder()
+{
+    if (m_stream != NULL)
+    {
+        stb_vorbis_close(m_stream);
+    }
+}
+
+uint8_t* OGGAudioDecoder::GetAudioData(FrameAllocator* a_allocator, uint64_t a_sampleOffset, uint32_t a_sampleSize, uint32_t* a_outSampleSize)
+{
+    if (m_stream == NULL)
+    {
+        return nullptr;
+    }
+
+    // Seeking is expensive in vorbis so only do it when not continuing on from the last read
+    if (a_sampleOffset != m_sampleOffset)
+    {
+        if (a_sampleOffset == 0)
+        {
+            stb_vorbis_seek_start(m_stream);
+        }
+        else
+        {
+            stb_vorbis_seek(m_stream, (unsigned int)a_sampleOffset);
+        }
+    }
+
+    uint8_t* buffer = (uint8_t*)a_allocator->Allocate<int16_t>(a_sampleSize * m_channelCount);
+
+    *a_outSampleSize = (uint32_t)stb_vorbis_get_samples_short_interleaved(m_stream, m_channelCount, (short*)buffer, a_sampleSize * m_channelCount);
+    m_sampleOffset = a_sampleOffset + *a_outSampleSize;
+
+    return buffer;
+}
 
 OGGAudioClip::OGGAudioClip(const std::filesystem::path& a_path) : AudioClip()
 {
     m_path = a_path;
 
-    m_stream = stb_vorbis_open_filename(m_path.string().c_str(), NULL, NULL);
+    m_data = nullptr;
+    m_dataSize = 0;
+    m_stream = NULL;
+    m_info = { };
+    m_sampleSize = 0;
+    m_duration = 0.0f;
+    m_pcm = nullptr;
+
+    FileHandle* handle = FileCache::LoadFile(m_path);
+    if (handle == nullptr)
+    {
+        IERROR("Failed to open OGG file: " + m_path.string());
+
+        return;
+    }
+    IDEFER(delete handle);
+
+    m_dataSize = handle->GetSize();
+    m_data = new uint8_t[m_dataSize];
+    if (handle->Read(m_data, m_dataSize) != m_dataSize)
+    {
+        IERROR("Failed to read OGG file: " + m_path.string());
+
+        return;
+    }
+
+    m_stream = stb_vorbis_open_memory(m_data, (int)m_dataSize, NULL, NULL);
+    if (m_stream == NULL)
+    {
+        IERROR("Invalid OGG file: " + m_path.string());
+
+        return;
+    }
+
     m_info = stb_vorbis_get_info(m_stream);
 
     // I do not know how or why but get the sample size before doing anything else or else it will break
@@ -22,7 +106,54 @@ OGGAudioClip::OGGAudioClip(const std::filesystem::path& a_path) : AudioClip()
 }
 OGGAudioClip::~OGGAudioClip()
 {
+    if (m_stream != NULL)
+    {
+        stb_vorbis_close(m_stream);
+    }
+
+    if (m_pcm != nullptr)
+    {
+        delete[] m_pcm;
+    }
+
+    if (m_data != nullptr)
+    {
+        delete[] m_data;
+    }
+}
+
+uint64_t OGGAudioClip::GetDecodedSize() const
+{
+    return m_sampleSize * m_info.channels * sizeof(int16_t);
+}
+bool OGGAudioClip::PreDecode()
+{
+    if (m_stream == NULL || m_pcm != nullptr)
+    {
+        return false;
+    }
+
+    const uint64_t count = m_sampleSize * m_info.channels;
+    m_pcm = new int16_t[count];
+
+    stb_vorbis_seek_start(m_stream);
+    const uint64_t decoded = (uint64_t)stb_vorbis_get_samples_short_interleaved(m_stream, m_info.channels, m_pcm, (int)count);
+    
+    // Length is from the last page so can be out slightly so trust what was actually decoded
+    if (decoded < m_sampleSize)
+    {
+        memset(m_pcm + decoded * m_info.channels, 0, (count - decoded * m_info.channels) * sizeof(int16_t));
+    }
+
+    // Everything is served from the decoded data now so the encoded data is no longer needed
     stb_vorbis_close(m_stream);
+    m_stream = NULL;
+
+    delete[] m_data;
+    m_data = nullptr;
+    m_dataSize = 0;
+
+    return true;
 }
 
 float OGGAudioClip::GetDuration() const
@@ -40,14 +171,56 @@ uint32_t OGGAudioClip::GetChannelCount() const
 }
 uint64_t OGGAudioClip::GetSampleSize() const
 {
-    return m_sampleSize * m_info.channels;
+    // Samples per channel to match the offsets used for reading
+    return m_sampleSize;
+}
+
+uint64_t OGGAudioClip::GetCachedSize() const
+{
+    if (m_pcm != nullptr)
+    {
+        return GetDecodedSize();
+    }
+
+    return 0;
+}
+
+AudioClipDecoder* OGGAudioClip::CreateDecoder()
+{
+    // Decoded clips can be read from directly
+    if (m_pcm != nullptr || m_data == nullptr)
+    {
+        return nullptr;
+    }
+
+    return new OGGAudioDecoder(m_data, m_dataSize, (uint32_t)m_info.channels);
 }
 
-uint8_t* OGGAudioClip::GetAudioData(RingAllocator* a_allocator, uint64_t a_sampleOffset, uint32_t a_sampleSize, uint32_t* a_outSampleSize)
+uint8_t* OGGAudioClip::GetAudioData(FrameAllocator* a_allocator, uint64_t a_sampleOffset, uint32_t a_sampleSize, uint32_t* a_outSampleSize)
 {
+    if (m_pcm != nullptr)
+    {
+        if (a_sampleOffset >= m_sampleSize)
+        {
+            *a_outSampleSize = 0;
+
+            return nullptr;
+        }
+
+        // No need to copy as the data lives as long as the clip
+        *a_outSampleSize = (uint32_t)glm::min((uint64_t)a_sampleSize, m_sampleSize - a_sampleOffset);
+
+        return (uint8_t*)(m_pcm + a_sampleOffset * m_info.channels);
+    }
+
+    if (m_stream == NULL)
+    {
+        return nullptr;
+    }
+
     uint8_t* buffer = (uint8_t*)a_allocator->Allocate<int16_t>(a_sampleSize * m_info.channels);
 
-    stb_vorbis_seek(m_stream, (int)a_sampleOffset);
+    stb_vorbis_seek(m_stream, (unsigned int)a_sampleOffset);
 
     *a_outSampleSize = (uint32_t)stb_vorbis_get_samples_short_interleaved(m_stream, m_info.channels, (short*)buffer, a_sampleSize * m_info.channels);
 
@@ -14,17 +14,22 @@
 #include <Jolt/Physics/Body/BodyID.h>
 #include <Jolt/Physics/Body/BodyInterface.h>
 #include <Jolt/RegisterTypes.h>
+#include <algorithm>
+#include <future>
 #include <sstream>
+#include <vector>
 
 #include "Config.h"
 #include "Core/Bitfield.h"
+#include "Core/IcarianDefer.h"
 #include "IcarianError.h"
 #include "ObjectManager.h"
 #include "Physics/InterfaceLock.h"
 #include "Physics/PhysicsEngineBindings.h"
 #include "Profiler.h"
-#include "Runtime/RuntimeFunction.h"
 #include "Runtime/RuntimeManager.h"
+#include "ThreadJob.h"
+#include "ThreadPool.h"
 #include "Trace.h"
 
 static void TraceImpl(const char* inFMT, ...)
@@ -73,7 +78,7 @@ PhysicsEngine::PhysicsEngine(Config* a_config)
         ISETBIT(m_objectLayerCollisions[7], i);
     }
 
-    m_fixedUpdateFunction = RuntimeManager::GetFunction("IcarianEngine", "Program", ":FixedUpdate(double,double)");
+    m_fixedUpdateFunction = RuntimeManager::GetThunk<double, double>("IcarianEngine", "Program", ":FixedUpdate(double,double)");
 
     m_fixedTimeStep = a_config->GetFixedTimeStep();
     m_fixedTimeTimer = 0.0;
@@ -90,6 +95,16 @@ PhysicsEngine::PhysicsEngine(Config* a_config)
 
     m_allocator = new JPH::TempAllocatorImpl(AllocatorSize);
 
+    // The main thread takes a batch of characters as well using the main allocator so only need one per worker
+    m_characterAllocatorCount = ThreadPool::GetThreadCount();
+    m_characterAllocators = new JPH::TempAllocatorImpl*[m_characterAllocatorCount];
+    for (uint32_t i = 0; i < m_characterAllocatorCount; ++i)
+    {
+        m_characterAllocators[i] = new JPH::TempAllocatorImpl(CharacterAllocatorSize);
+    }
+
+    m_characterInteractionMode = CharacterInteractionMode_None;
+
     m_jobSystem = new IcPhysicsJobSystem(JPH::cMaxPhysicsBarriers);
 
     m_broadPhase = new IcBroadPhaseLayerInterface();
@@ -124,6 +139,12 @@ PhysicsEngine::~PhysicsEngine()
 
     delete m_jobSystem;
 
+    for (uint32_t i = 0; i < m_characterAllocatorCount; ++i)
+    {
+        delete m_characterAllocators[i];
+    }
+    delete[] m_characterAllocators;
+
     delete m_allocator;
 
     delete m_runtimeBindings;
@@ -182,6 +203,313 @@ static void TransformObject(uint32_t a_transformAddr, const glm::vec3& a_transla
     ObjectManager::SetTransformBuffer(a_transformAddr, buffer);
 }
 
+struct CharacterUpdateContext
+{
+    JPH::CharacterVirtual* const*       Characters;
+    float                               DeltaTime;
+    JPH::Vec3                           Gravity;
+    const JPH::BroadPhaseLayerFilter*   BroadFilter;
+    const JPH::ObjectLayerFilter*       ObjectFilter;
+};
+
+static void UpdateCharacterRange(const CharacterUpdateContext& a_context, uint32_t a_start, uint32_t a_end, JPH::TempAllocator* a_allocator)
+{
+    for (uint32_t i = a_start; i < a_end; ++i)
+    {
+        JPH::CharacterVirtual* c = a_context.Characters[i];
+
+        const JPH::Vec3 up = c->GetUp();
+
+        const JPH::CharacterVirtual::ExtendedUpdateSettings updateSettings = 
+        {
+            .mStickToFloorStepDown = -up * 0.2f,
+            .mWalkStairsStepUp = up * 0.2f
+        };
+
+        c->ExtendedUpdate(a_context.DeltaTime, a_context.Gravity, updateSettings, *a_context.BroadFilter, *a_context.ObjectFilter, { }, { }, *a_allocator);
+    }
+}
+
+struct CharacterUpdateBind
+{
+    const CharacterUpdateContext* Context;
+    JPH::TempAllocator*           Allocator;
+
+    uint32_t                      Start;
+    uint32_t                      End;
+
+    CharacterUpdateBind() = default;
+    CharacterUpdateBind(const CharacterUpdateBind& a_other) = default;
+    CharacterUpdateBind(const CharacterUpdateContext* a_context, JPH::TempAllocator* a_allocator, uint32_t a_start, uint32_t a_end)
+    {
+        Context = a_context;
+        Allocator = a_allocator;
+
+        Start = a_start;
+        End = a_end;
+    }
+
+    inline uint32_t operator()() const
+    {
+        UpdateCharacterRange(*Context, Start, End, Allocator);
+
+        return End - Start;
+    }
+};
+
+void PhysicsEngine::UpdateCharacters(double a_delta)
+{
+    const Array<JPH::CharacterVirtual*> activeCharacters = m_characters.ToActiveArray();
+    const uint32_t count = activeCharacters.Size();
+    if (count == 0)
+    {
+        return;
+    }
+
+    // Listener callbacks call into scripts which expect to be run one at a time on the calling thread
+    // Characters with a listener go first so they stay on the calling thread and only the rest go to the pool
+    Array<JPH::CharacterVirtual*> characters;
+    characters.Reserve(count);
+    for (JPH::CharacterVirtual* c : activeCharacters)
+    {
+        if (c->GetListener() != nullptr)
+        {
+            characters.Push(c);
+        }
+    }
+
+    const uint32_t listenerCount = characters.Size();
+    for (JPH::CharacterVirtual* c : activeCharacters)
+    {
+        if (c->GetListener() == nullptr)
+        {
+            characters.Push(c);
+        }
+    }
+
+    const JPH::DefaultBroadPhaseLayerFilter broadFilter = m_physicsSystem->GetDefaultBroadPhaseLayerFilter(0);
+    const JPH::DefaultObjectLayerFilter objectFilter = m_physicsSystem->GetDefaultLayerFilter(0);
+
+    const CharacterUpdateContext context = 
+    {
+        .Characters = characters.Data(),
+        .DeltaTime = (float)a_delta,
+        .Gravity = m_physicsSystem->GetGravity(),
+        .BroadFilter = &broadFilter,
+        .ObjectFilter = &objectFilter
+    };
+
+    // Characters only collide with the world during the update so each can be moved independently
+    // Each job gets its own allocator so there is no contention on the temp allocator
+    const uint32_t poolCount = count - listenerCount;
+    const uint32_t batchCount = (poolCount + CharacterBatchSize - 1) / CharacterBatchSize;
+    const uint32_t jobCount = batchCount > 0 ? glm::min(batchCount - 1, m_characterAllocatorCount) : 0;
+    const uint32_t rangeCount = jobCount + 1;
+
+    std::vector<std::future<uint32_t>> futures;
+    futures.reserve(jobCount);
+    for (uint32_t i = 0; i < jobCount; ++i)
+    {
+        const uint32_t start = listenerCount + (poolCount * (i + 1)) / rangeCount;
+        const uint32_t end = listenerCount + (poolCount * (i + 2)) / rangeCount;
+
+        FThreadJob<uint32_t, CharacterUpdateBind>* job = new FThreadJob<uint32_t, CharacterUpdateBind>
+        (
+            CharacterUpdateBind(&context, m_characterAllocators[i], start, end),
+            JobPriority_EngineHigh
+        );
+        futures.emplace_back(job->GetFuture());
+        ThreadPool::PushJob(job);
+    }
+
+    // Main thread would otherwise be idle waiting so take the listener characters and the first range
+    UpdateCharacterRange(context, 0, listenerCount + poolCount / rangeCount, m_allocator);
+
+    for (std::future<uint32_t>& f : futures)
+    {
+        f.wait();
+    }
+
+    switch (m_characterInteractionMode)
+    {
+    case CharacterInteractionMode_Deterministic:
+    {
+        SeparateCharacters(context, count);
+
+        break;
+    }
+    default:
+    {
+        break;
+    }
+    }
+}
+
+struct CharacterSeparationData
+{
+    JPH::Vec3 Position;
+    JPH::Vec3 Up;
+    float     Radius;
+    float     HalfHeight;
+    float     Mass;
+};
+
+struct CharacterCell
+{
+    uint64_t Key;
+    uint32_t Index;
+
+    constexpr bool operator <(const CharacterCell& a_other) const
+    {
+        if (Key == a_other.Key)
+        {
+            return Index < a_other.Index;
+        }
+
+        return Key < a_other.Key;
+    }
+};
+
+static constexpr uint64_t GetCharacterCellKey(int32_t a_x, int32_t a_z)
+{
+    return (uint64_t)(uint32_t)a_x << 32 | (uint64_t)(uint32_t)a_z;
+}
+
+void PhysicsEngine::SeparateCharacters(const CharacterUpdateContext& a_context, uint32_t a_count)
+{
+    // Characters resolving against each other mid update depends on who moves first and what thread gets there first
+    // Instead resolve overlaps after everyone has moved using a snapshot of the positions
+    // Each correction is only dependant on the snapshot so the result is the same regardless of order or threading
+    const uint32_t count = a_count;
+    if (count <= 1 || a_context.DeltaTime <= 0.0f)
+    {
+        return;
+    }
+
+    CharacterSeparationData* data = new CharacterSeparationData[count];
+    IDEFER(delete[] data);
+
+    float maxRadius = 0.0f;
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        const JPH::CharacterVirtual* c = a_context.Characters[i];
+
+        const JPH::AABox bounds = c->GetShape()->GetLocalBounds();
+        const JPH::Vec3 extent = bounds.GetExtent();
+        const JPH::RVec3 position = c->GetCenterOfMassTransform().GetTranslation();
+
+        CharacterSeparationData& d = data[i];
+        d.Position = JPH::Vec3(position);
+        d.Up = c->GetUp();
+        d.Radius = glm::max(extent.GetX(), extent.GetZ()) + c->GetCharacterPadding();
+        d.HalfHeight = extent.GetY();
+        d.Mass = glm::max(c->GetMass(), 0.0001f);
+
+        maxRadius = glm::max(maxRadius, d.Radius);
+    }
+
+    if (maxRadius <= 0.0f)
+    {
+        return;
+    }
+
+    // Any overlapping pair is at most 2 max radii apart so only need to check neighbouring cells
+    const float cellSize = maxRadius * 2.0f;
+    const float invCellSize = 1.0f / cellSize;
+
+    std::vector<CharacterCell> cells;
+    cells.reserve(count);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        const JPH::Vec3 pos = data[i].Position;
+
+        const int32_t x = (int32_t)glm::floor(pos.GetX() * invCellSize);
+        const int32_t z = (int32_t)glm::floor(pos.GetZ() * invCellSize);
+
+        cells.push_back({ GetCharacterCellKey(x, z), i });
+    }
+
+    // Sorting by key then index means neighbours are always visited in the same order
+    std::sort(cells.begin(), cells.end());
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        const CharacterSeparationData& lhs = data[i];
+
+        const int32_t cX = (int32_t)glm::floor(lhs.Position.GetX() * invCellSize);
+        const int32_t cZ = (int32_t)glm::floor(lhs.Position.GetZ() * invCellSize);
+
+        JPH::Vec3 correction = JPH::Vec3::sZero();
+        for (int32_t x = cX - 1; x <= cX + 1; ++x)
+        {
+            for (int32_t z = cZ - 1; z <= cZ + 1; ++z)
+            {
+                const uint64_t key = GetCharacterCellKey(x, z);
+
+                auto iter = std::lower_bound(cells.begin(), cells.end(), CharacterCell{ key, 0 });
+                for (; iter != cells.end() && iter->Key == key; ++iter)
+                {
+                    const uint32_t j = iter->Index;
+                    if (i == j)
+                    {
+                        continue;
+                    }
+
+                    const CharacterSeparationData& rhs = data[j];
+
+                    const JPH::Vec3 diff = lhs.Position - rhs.Position;
+                    const float vertical = diff.Dot(lhs.Up);
+                    if (glm::abs(vertical) >= lhs.HalfHeight + rhs.HalfHeight)
+                    {
+                        continue;
+                    }
+
+                    const JPH::Vec3 horizontal = diff - lhs.Up * vertical;
+                    const float dist = horizontal.Length();
+                    const float penetration = lhs.Radius + rhs.Radius - dist;
+                    if (penetration <= 0.0f)
+                    {
+                        continue;
+                    }
+
+                    JPH::Vec3 dir;
+                    if (dist > 1e-4f)
+                    {
+                        dir = horizontal / dist;
+                    }
+                    else
+                    {
+                        // Stacked on top of each other so pick an arbitrary but consistent direction
+                        dir = lhs.Up.GetNormalizedPerpendicular();
+                        if (i > j)
+                        {
+                            dir = -dir;
+                        }
+                    }
+
+                    // Lighter characters get pushed more
+                    const float share = rhs.Mass / (lhs.Mass + rhs.Mass);
+
+                    correction += dir * (penetration * share);
+                }
+            }
+        }
+
+        if (correction != JPH::Vec3::sZero())
+        {
+            JPH::CharacterVirtual* c = a_context.Characters[i];
+
+            // Move through the character update so the push gets stopped by the world instead of going through walls
+            // Only the correction is applied so velocity is swapped out for the step and gravity is left off
+            const JPH::Vec3 velocity = c->GetLinearVelocity();
+            IDEFER(c->SetLinearVelocity(velocity));
+
+            c->SetLinearVelocity(correction / a_context.DeltaTime);
+            c->Update(a_context.DeltaTime, JPH::Vec3::sZero(), *a_context.BroadFilter, *a_context.ObjectFilter, { }, { }, *m_allocator);
+        }
+    }
+}
+
 void PhysicsEngine::Update(double a_delta)
 {
     {
@@ -199,31 +527,12 @@ void PhysicsEngine::Update(double a_delta)
             m_fixedTimeTimer -= m_fixedTimeStep;
             m_fixedTimePassed += m_fixedTimeStep;
 
-            void* args[] = 
-            { 
-                &m_fixedTimeStep, 
-                &m_fixedTimePassed
-            };
-
-            m_fixedUpdateFunction->Exec(args);
-
-            const JPH::Vec3 gravity = m_physicsSystem->GetGravity();
-
-            const JPH::DefaultBroadPhaseLayerFilter broadFilter = m_physicsSystem->GetDefaultBroadPhaseLayerFilter(0);
-            const JPH::DefaultObjectLayerFilter objectFilter = m_physicsSystem->GetDefaultLayerFilter(0);
+            m_fixedUpdateFunction->Exec(m_fixedTimeStep, m_fixedTimePassed);
 
-            const Array<JPH::CharacterVirtual*> characters = m_characters.ToActiveArray();
-            for (JPH::CharacterVirtual* c : characters)
             {
-                const JPH::Vec3 up = c->GetUp();
-
-                const JPH::CharacterVirtual::ExtendedUpdateSettings updateSettings = 
-                {
-                    .mStickToFloorStepDown = -up * 0.2f,
-                    .mWalkStairsStepUp = up * 0.2f
-                };
+                PROFILESTACK("Character Update");
 
-                c->ExtendedUpdate((float)m_fixedTimeStep, gravity, updateSettings, broadFilter, objectFilter, { }, { }, *m_allocator);
+                UpdateCharacters(m_fixedTimeStep);
             }
 
             m_physicsSystem->Update((float)m_fixedTimeStep, steps, m_allocator, m_jobSystem);
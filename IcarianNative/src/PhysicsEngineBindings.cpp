@@ -342,7 +342,7 @@ uint32_t PhysicsEngineBindings::CreateCharacterController(uint32_t a_transformAd
 
     const uint32_t index = m_engine->m_characters.PushVal(character);
 
-    character->SetListener(m_engine->m_characterListener);
+    // Listener is only set once the script has callbacks so characters without any can update off the calling thread
     character->SetUserData((JPH::uint64)index << 32 | (JPH::uint64)a_transformAddr);
 
     return index;
@@ -374,6 +374,14 @@ void PhysicsEngineBindings::SetCharacterControllerVelocity(uint32_t a_addr, cons
     JPH::CharacterVirtual* character = m_engine->m_characters[a_addr];
     character->SetLinearVelocity(JPH::Vec3Arg(a_velocity.x, a_velocity.y, a_velocity.z));
 }
+void PhysicsEngineBindings::SetCharacterControllerListener(uint32_t a_addr, bool a_state) const
+{
+    IVERIFY(a_addr < m_engine->m_characters.Size());
+    IVERIFY(m_engine->m_characters.Exists(a_addr));
+
+    JPH::CharacterVirtual* character = m_engine->m_characters[a_addr];
+    character->SetListener(a_state ? m_engine->m_characterListener : nullptr);
+}
 
 void PhysicsEngineBindings::AddBody(JPH::uint32 a_id, uint32_t a_index) const
 {
@@ -781,6 +789,15 @@ glm::vec3 PhysicsEngineBindings::GetGravity() const
     return glm::vec3(gravity.GetX(), gravity.GetY(), gravity.GetZ());
 }
 
+e_CharacterInteractionMode PhysicsEngineBindings::GetCharacterInteractionMode() const
+{
+    return m_engine->m_characterInteractionMode;
+}
+void PhysicsEngineBindings::SetCharacterInteractionMode(e_CharacterInteractionMode a_mode) const
+{
+    m_engine->m_characterInteractionMode = a_mode;
+}
+
 bool PhysicsEngineBindings::GetObjectLayerCollision(uint32_t a_lhs, uint32_t a_rhs) const
 {
     return m_engine->CanObjectLayersCollide(a_lhs, a_rhs);
@@ -0,0 +1,173 @@
+// Icarian Engine - C# Game Engine
+// 
+// License at end of file.
+
+#ifdef ICARIANNATIVE_ENABLE_GRAPHICS_VULKAN
+
+#include "Rendering/Vulkan/VulkanDynamicVertexBuffer.h"
+
+#include <cstring>
+
+#include "Rendering/Vulkan/VulkanRenderEngineBackend.h"
+#include "Trace.h"
+
+class VulkanDynamicVertexBufferDeletionObject : public VulkanDeletionObject
+{
+private:
+    VulkanRenderEngineBackend* m_engine;
+
+    vk::Buffer                 m_buffer;
+    VmaAllocation              m_allocation;
+
+protected:
+
+public:
+    VulkanDynamicVertexBufferDeletionObject(VulkanRenderEngineBackend* a_engine, vk::Buffer a_buffer, VmaAllocation a_allocation)
+    {
+        m_engine = a_engine;
+
+        m_buffer = a_buffer;
+        m_allocation = a_allocation;
+    }
+    virtual ~VulkanDynamicVertexBufferDeletionObject()
+    {
+
+    }
+
+    virtual void Destroy()
+    {
+        TRACE("Destroying Dynamic Vertex Buffer");
+        const VmaAllocator allocator = m_engine->GetAllocator();
+
+        vmaDestroyBuffer(allocator, m_buffer, m_allocation);
+    }
+};
+
+// Keeps attribute reads aligned regardless of the vertex stride of the previous write
+static constexpr uint32_t WriteAlignment = 16;
+
+VulkanDynamicVertexBuffer::VulkanDynamicVertexBuffer(VulkanRenderEngineBackend* a_engine, uint32_t a_initialSize)
+{
+    TRACE("Creating Vulkan Dynamic Vertex Buffer");
+    m_engine = a_engine;
+
+    m_offset = 0;
+    m_requiredSize = a_initialSize;
+
+    for (uint32_t i = 0; i < VulkanFlightPoolSize; ++i)
+    {
+        CreateBuffer(i, a_initialSize);
+    }
+}
+VulkanDynamicVertexBuffer::~VulkanDynamicVertexBuffer()
+{
+    TRACE("Queueing Dynamic Vertex Buffer for deletion");
+    for (uint32_t i = 0; i < VulkanFlightPoolSize; ++i)
+    {
+        m_engine->PushDeletionObject(new VulkanDynamicVertexBufferDeletionObject(m_engine, m_buffers[i], m_allocations[i]));
+    }
+}
+
+void VulkanDynamicVertexBuffer::CreateBuffer(uint32_t a_index, uint32_t a_size)
+{
+    const VmaAllocator allocator = m_engine->GetAllocator();
+
+    VkBufferCreateInfo bufferInfo = { };
+    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferInfo.size = (VkDeviceSize)a_size;
+    bufferInfo.usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
+    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    VmaAllocationCreateInfo bufferAllocInfo = { 0 };
+    bufferAllocInfo.usage = VMA_MEMORY_USAGE_AUTO;
+    bufferAllocInfo.requiredFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+    bufferAllocInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
+    VmaAllocationInfo info;
+
+    VkBuffer tBuffer;
+    VKRESERRMSG(vmaCreateBuffer(allocator, &bufferInfo, &bufferAllocInfo, &tBuffer, &m_allocations[a_index], &info), "Failed to create Dynamic Vertex Buffer");
+#ifdef DEBUG
+    vmaSetAllocationName(allocator, m_allocations[a_index], "Dynamic Vertex Buffer");
+#endif
+
+    m_buffers[a_index] = tBuffer;
+    m_mapped[a_index] = info.pMappedData;
+    m_sizes[a_index] = a_size;
+}
+
+void VulkanDynamicVertexBuffer::GrowBuffer(uint32_t a_index, uint32_t a_size)
+{
+    TRACE("Growing Dynamic Vertex Buffer");
+
+    uint32_t size = m_sizes[a_index];
+    while (size < a_size)
+    {
+        size *= 2;
+    }
+
+    m_engine->PushDeletionObject(new VulkanDynamicVertexBufferDeletionObject(m_engine, m_buffers[a_index], m_allocations[a_index]));
+
+    CreateBuffer(a_index, size);
+
+    // Other frames grow on their next reset instead of when they run out
+    if (size > m_requiredSize)
+    {
+        m_requiredSize = size;
+    }
+}
+
+void VulkanDynamicVertexBuffer::Reset(uint32_t a_index)
+{
+    m_offset = 0;
+
+    if (m_requiredSize > m_sizes[a_index])
+    {
+        GrowBuffer(a_index, m_requiredSize);
+    }
+}
+vk::DeviceSize VulkanDynamicVertexBuffer::Write(uint32_t a_index, const void* a_data, uint32_t a_size)
+{
+    uint32_t offset = (m_offset + WriteAlignment - 1) & ~(WriteAlignment - 1);
+    if (offset + a_size > m_sizes[a_index])
+    {
+        // Sized for everything written this frame so the next frame fits without growing again
+        // Earlier writes stay in the old buffer until it is deleted so the new one can start from the beginning
+        GrowBuffer(a_index, offset + a_size);
+
+        offset = 0;
+    }
+
+    m_offset = offset + a_size;
+
+    memcpy((uint8_t*)m_mapped[a_index] + offset, a_data, a_size);
+    // No op on coherent memory which is pretty much everything but the allocator is allowed to hand back non coherent memory
+    vmaFlushAllocation(m_engine->GetAllocator(), m_allocations[a_index], (VkDeviceSize)offset, (VkDeviceSize)a_size);
+
+    return (vk::DeviceSize)offset;
+}
+
+#endif
+
+
+// MIT License
+// 
+// Copyright (c) 2024 River Govers
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
\ No newline at end of file
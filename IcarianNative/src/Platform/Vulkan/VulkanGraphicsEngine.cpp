@@ -21,10 +21,12 @@
 #include "Rendering/RenderEngine.h"
 #include "Rendering/UI/ImageUIElement.h"
 #include "Rendering/UI/TextUIElement.h"
+#include "Rendering/UI/UIBatcher.h"
 #include "Rendering/UI/UIControl.h"
 #include "Rendering/UI/UIElement.h"
 #include "Rendering/Vulkan/VulkanDepthCubeRenderTexture.h"
 #include "Rendering/Vulkan/VulkanDepthRenderTexture.h"
+#include "Rendering/Vulkan/VulkanDynamicVertexBuffer.h"
 #include "Rendering/Vulkan/VulkanGraphicsEngineBindings.h"
 #include "Rendering/Vulkan/VulkanGraphicsParticle2D.h"
 #include "Rendering/Vulkan/VulkanLightBuffer.h"
@@ -73,27 +75,44 @@ VulkanGraphicsEngine::VulkanGraphicsEngine(VulkanRenderEngineBackend* a_vulkanEn
     m_postForwardFunc = RuntimeManager::GetFunction("IcarianEngine.Rendering", "RenderPipeline", ":PostForwardS(uint)");
     m_postProcessFunc = RuntimeManager::GetFunction("IcarianEngine.Rendering", "RenderPipeline", ":PostProcessS(uint)"); 
 
+    // Text and images share the batched vertex layout and only differ in how the texture is sampled
+    VertexInputAttribute* textAttributes = new VertexInputAttribute[3];
+    textAttributes[0] = { .Location = 0, .Type = VertexType_Float, .Count = 2, .Offset = offsetof(UIBatchVertex, Position) };
+    textAttributes[1] = { .Location = 1, .Type = VertexType_Float, .Count = 2, .Offset = offsetof(UIBatchVertex, TexCoord) };
+    textAttributes[2] = { .Location = 2, .Type = VertexType_Float, .Count = 4, .Offset = offsetof(UIBatchVertex, Color) };
+
     const RenderProgram textProgram = 
     {
         .VertexShader = GenerateFVertexShader(UIVertexShader),
         .PixelShader = GenerateFPixelShader(UITextPixelShader),
         .ShadowVertexShader = uint32_t(-1),
+        .VertexAttributes = textAttributes,
+        .VertexInputCount = 3,
+        .VertexStride = sizeof(UIBatchVertex),
         .ColorBlendMode = MaterialBlendMode_Alpha,
         .CullingMode = CullMode_None,
-        .PrimitiveMode = PrimitiveMode_TriangleStrip,
+        .PrimitiveMode = PrimitiveMode_Triangles,
         .Flags = 0b1 << RenderProgram::DestroyFlag
     };
 
     m_textUIPipelineAddr = GenerateRenderProgram(textProgram);
 
+    VertexInputAttribute* imageAttributes = new VertexInputAttribute[3];
+    imageAttributes[0] = { .Location = 0, .Type = VertexType_Float, .Count = 2, .Offset = offsetof(UIBatchVertex, Position) };
+    imageAttributes[1] = { .Location = 1, .Type = VertexType_Float, .Count = 2, .Offset = offsetof(UIBatchVertex, TexCoord) };
+    imageAttributes[2] = { .Location = 2, .Type = VertexType_Float, .Count = 4, .Offset = offsetof(UIBatchVertex, Color) };
+
     const RenderProgram imageProgram = 
     {
         .VertexShader = GenerateFVertexShader(UIVertexShader),
         .PixelShader = GenerateFPixelShader(UIImagePixelShader),
         .ShadowVertexShader = uint32_t(-1),
+        .VertexAttributes = imageAttributes,
+        .VertexInputCount = 3,
+        .VertexStride = sizeof(UIBatchVertex),
         .ColorBlendMode = MaterialBlendMode_Alpha,
         .CullingMode = CullMode_None,
-        .PrimitiveMode = PrimitiveMode_TriangleStrip,
+        .PrimitiveMode = PrimitiveMode_Triangles,
         .Flags = 0b1 << RenderProgram::DestroyFlag
     };
 
@@ -127,6 +146,7 @@ VulkanGraphicsEngine::VulkanGraphicsEngine(VulkanRenderEngineBackend* a_vulkanEn
     m_imageUIPipelineAddr = GenerateRenderProgram(imageProgram);
 
     m_timeUniform = new VulkanUniformBuffer(m_vulkanEngine, sizeof(IcarianCore::ShaderTimeBuffer));
+    m_uiVertexBuffer = new VulkanDynamicVertexBuffer(m_vulkanEngine, UIVertexBufferInitialSize);
 }
 VulkanGraphicsEngine::~VulkanGraphicsEngine()
 {
@@ -204,6 +224,12 @@ VulkanGraphicsEngine::~VulkanGraphicsEngine()
 void VulkanGraphicsEngine::Cleanup()
 {
     delete m_timeUniform;
+    delete m_uiVertexBuffer;
+
+    for (UIBatcher* batcher : m_uiBatchers)
+    {
+        delete batcher;
+    }
 
     const RenderProgram textProgram = m_shaderPrograms[m_textUIPipelineAddr];
     IDEFER(
@@ -2362,104 +2388,79 @@ VulkanCommandBuffer VulkanGraphicsEngine::PostPass(uint32_t a_camIndex, uint32_t
     return vCmdBuffer;
 }
 
-void VulkanGraphicsEngine::DrawUIElement(vk::CommandBuffer a_commandBuffer, uint32_t a_addr, const CanvasBuffer& a_canvas, const glm::vec2& a_screenSize, uint32_t a_index)
+void VulkanGraphicsEngine::DrawCanvas(vk::CommandBuffer a_commandBuffer, uint32_t a_canvasAddr, const CanvasBuffer& a_canvas, const glm::vec2& a_screenSize, uint32_t a_index)
 {
-    const bool valid = a_addr != -1;
-    if (!valid)
+    while (m_uiBatchers.Size() <= a_canvasAddr)
     {
-        return;
+        m_uiBatchers.Push(new UIBatcher());
     }
 
-    UIElement* element = UIControl::GetUIElement(a_addr);
-    if (element == nullptr)
+    UIBatcher* batcher = m_uiBatchers[a_canvasAddr];
+
+    // Only rebuilds the batches if something in the canvas changed otherwise the vertices from last time are reused
+    batcher->Update(a_canvas, a_screenSize, m_vulkanEngine->GetRenderEngine());
+
+    const Array<UIBatchVertex>& vertices = batcher->GetVertices();
+    if (vertices.Empty())
     {
         return;
     }
 
-    const glm::vec2 pos = element->GetCanvasPosition(a_canvas, a_screenSize);
-    const glm::vec2 scale = element->GetCanvasScale(a_canvas, a_screenSize);
+    const vk::DeviceSize offset = m_uiVertexBuffer->Write(a_index, vertices.Data(), vertices.Size() * sizeof(UIBatchVertex));
 
-    const glm::vec2 screenPos = pos * a_screenSize;
-    const glm::vec2 screenSize = scale * a_screenSize;
+    // Vertices are already clipped and in render target space so one viewport covers every batch
+    const vk::Rect2D scissor = vk::Rect2D({ 0, 0 }, { (uint32_t)a_screenSize.x, (uint32_t)a_screenSize.y });
+    a_commandBuffer.setScissor(0, 1, &scissor);
+    const vk::Viewport viewport = vk::Viewport(0.0f, 0.0f, a_screenSize.x, a_screenSize.y, 0.0f, 1.0f);
+    a_commandBuffer.setViewport(0, 1, &viewport);
 
-    element->Update(m_vulkanEngine->GetRenderEngine());
+    const vk::Buffer vertexBuffer = m_uiVertexBuffer->GetBuffer(a_index);
+    a_commandBuffer.bindVertexBuffers(0, 1, &vertexBuffer, &offset);
 
-    VulkanPipeline* pipeline = nullptr;
-    VulkanShaderData* shaderData = nullptr;
+    VulkanPipeline* boundPipeline = nullptr;
 
-    switch (element->GetType()) 
-    {
-    case UIElementType_Base:
-    {
-        break;
-    }
-    case UIElementType_Text:
+    for (const UIBatch& batch : batcher->GetBatches())
     {
-        const TextUIElement* text = (TextUIElement*)element;
+        VulkanPipeline* pipeline = nullptr;
 
-        if (text->IsValid())
+        switch (batch.Type)
+        {
+        case UIBatchType_Text:
         {
-            const vk::Rect2D scissor = vk::Rect2D({ (int32_t)screenPos.x, (int32_t)screenPos.y }, { (uint32_t)screenSize.x, (uint32_t)screenSize.y });
-            a_commandBuffer.setScissor(0, 1, &scissor);
-            const vk::Viewport viewport = vk::Viewport(screenPos.x, screenPos.y, screenSize.x, screenSize.y, 0.0f, 1.0f);
-            a_commandBuffer.setViewport(0, 1, &viewport);
-
             pipeline = GetPipeline(-1, m_textUIPipelineAddr);
-            IVERIFY(pipeline != nullptr);
-            shaderData = pipeline->GetShaderData();
-            IVERIFY(shaderData != nullptr);
 
-            const uint32_t samplerAddr = text->GetSamplerAddr();
-            const TextureSamplerBuffer& sampler = GetTextureSampler(samplerAddr);
+            break;
+        }
+        case UIBatchType_Image:
+        {
+            pipeline = GetPipeline(-1, m_imageUIPipelineAddr);
 
-            shaderData->PushTexture(a_commandBuffer, 0, sampler, a_index);
+            break;
         }
-            
-        break;
-    }
-    case UIElementType_Image:
-    {
-        const ImageUIElement* image = (ImageUIElement*)element;
+        default:
+        {
+            IERROR("Invalid UIBatch Type");
 
-        const vk::Rect2D scissor = vk::Rect2D({ (int32_t)screenPos.x, (int32_t)screenPos.y }, { (uint32_t)screenSize.x, (uint32_t)screenSize.y });
-        a_commandBuffer.setScissor(0, 1, &scissor);
-        const vk::Viewport viewport = vk::Viewport(screenPos.x, screenPos.y, screenSize.x, screenSize.y, 0.0f, 1.0f);
-        a_commandBuffer.setViewport(0, 1, &viewport);
+            break;
+        }
+        }
 
-        pipeline = GetPipeline(-1, m_imageUIPipelineAddr);
         IVERIFY(pipeline != nullptr);
-        shaderData = pipeline->GetShaderData();
+        VulkanShaderData* shaderData = pipeline->GetShaderData();
         IVERIFY(shaderData != nullptr);
-        
-        const uint32_t samplerAddr = image->GetSamplerAddr();
-        const TextureSamplerBuffer& sampler = GetTextureSampler(samplerAddr);
-
-        shaderData->PushTexture(a_commandBuffer, 0, sampler, a_index);
 
-        break;
-    }
-    default:
-    {
-        IERROR("Invalid UIElement Type");
+        const TextureSamplerBuffer& sampler = GetTextureSampler(batch.SamplerAddr);
 
-        break;
-    }
-    }
+        shaderData->PushTexture(a_commandBuffer, 0, sampler, a_index);
 
-    const bool set = pipeline != nullptr && shaderData != nullptr;
-    if (set)
-    {
-        pipeline->Bind(a_index, a_commandBuffer);
-        shaderData->UpdateUIBuffer(a_commandBuffer, element);
+        if (pipeline != boundPipeline)
+        {
+            pipeline->Bind(a_index, a_commandBuffer);
 
-        a_commandBuffer.draw(4, 1, 0, 0);
-    }
+            boundPipeline = pipeline;
+        }
 
-    const uint32_t childCount = element->GetChildCount();
-    const uint32_t* children = element->GetChildren();
-    for (uint32_t i = 0; i < childCount; ++i)
-    {
-        DrawUIElement(a_commandBuffer, children[i], a_canvas, a_screenSize, a_index);
+        a_commandBuffer.draw(batch.VertexCount, 1, batch.FirstVertex, 0);
     }
 }
 
@@ -2696,6 +2697,8 @@ Array<VulkanCommandBuffer> VulkanGraphicsEngine::Update(double a_delta, double a
     {
         PROFILESTACK("UI Draw");
 
+        m_uiVertexBuffer->Reset(a_index);
+
         const Array<CanvasRendererBuffer> a = m_canvasRenderers.ToActiveArray();
 
         const uint32_t canvasArrSize = a.Size();
@@ -2747,10 +2750,7 @@ Array<VulkanCommandBuffer> VulkanGraphicsEngine::Update(double a_delta, double a
                 buffer.beginRenderPass(&renderPassInfo, vk::SubpassContents::eInline);
             }
 
-            for (uint32_t i = 0; i < canvas.ChildCount; ++i)
-            {
-                DrawUIElement(buffer, canvas.ChildElements[i], canvas, screenSize, a_index);
-            }
+            DrawCanvas(buffer, canvasRenderer.CanvasAddr, canvas, screenSize, a_index);
 
             buffer.endRenderPass();
 
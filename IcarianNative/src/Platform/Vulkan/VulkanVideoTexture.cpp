@@ -93,7 +93,8 @@ double VulkanVideoTexture::GenerateClipBuffer(const VideoClip* a_clip, const Vul
 
     const VideoFrameInfo* frameInfo = a_clip->GetFrameInfo();
 
-    const double endTimeStamp = frameInfo[endIndex].TimeStamp;
+    // The last clip runs to the end of the video as there is no frame after it
+    const double endTimeStamp = endIndex < a_clip->GetFrameCount() ? frameInfo[endIndex].TimeStamp : a_clip->GetDuration();
 
     VmaAllocation allocation;
     vk::Buffer buffer;
@@ -239,6 +240,12 @@ VulkanVideoTexture::VulkanVideoTexture(VulkanRenderEngineBackend* a_engine, uint
         lastTimeStamp += frameStep;
     }
 
+    // Get the GOP after the buffered ones off the disk before playback reaches it
+    if (lastTimeStamp >= 0)
+    {
+        clip->PrefetchClipData(lastTimeStamp);
+    }
+
     const vk::Device device = m_engine->GetLogicalDevice();
 
     const uint32_t spsCount = clip->GetSPSCount();
@@ -419,6 +426,8 @@ void VulkanVideoTexture::UpdateVulkan(vk::CommandBuffer a_commandBuffer, double
         {
             break;
         }
+
+        clip->PrefetchClipData(v + frameStep);
     }
 
     vk::VideoBeginCodingInfoKHR beginInfo = vk::VideoBeginCodingInfoKHR
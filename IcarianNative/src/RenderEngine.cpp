@@ -13,7 +13,6 @@
 #include "Rendering/Null/NullRenderEngineBackend.h"
 #include "Rendering/RenderAssetStore.h"
 #include "Rendering/SPIRVTools.h"
-#include "Runtime/RuntimeFunction.h"
 #include "Runtime/RuntimeManager.h"
 #include "Trace.h"
 
@@ -26,7 +25,7 @@ RenderEngine::RenderEngine(AppWindow* a_window, Config* a_config)
     TRACE("Initializing Rendering");
     m_config = a_config;
 
-    m_frameUpdateFunction = RuntimeManager::GetFunction("IcarianEngine", "Program", ":FrameUpdate(double,double)");
+    m_frameUpdateFunction = RuntimeManager::GetThunk<double, double>("IcarianEngine", "Program", ":FrameUpdate(double,double)");
 
     m_window = a_window;
 
@@ -138,16 +137,10 @@ void RenderEngine::Run()
                 AnimationController::UpdateAnimators(AnimationUpdateMode_FrameUpdate, (float)delta);
             }
 
-            void* args[] =
-            {
-                &delta,
-                &timePassed
-            };
-
             {
                 PROFILESTACK("Frame Update");
                 
-                m_frameUpdateFunction->Exec(args);
+                m_frameUpdateFunction->Exec(delta, timePassed);
             }
 
             m_backend->Update(delta, timePassed);
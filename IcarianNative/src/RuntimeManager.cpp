@@ -15,9 +15,17 @@
 #include "Profiler.h"
 #include "Rendering/RenderEngine.h"
 #include "Runtime/RuntimeFunction.h"
+#include "Trace.h"
 
 static RuntimeManager* Instance = nullptr;
 
+// Mono looks for AOT images at <assembly path> + the platform shared library extension
+#ifdef WIN32
+static constexpr char AOTImageName[] = "IcarianCS.dll.dll";
+#else
+static constexpr char AOTImageName[] = "IcarianCS.dll.so";
+#endif
+
 #include "EngineIcarianAssemblyInterop.h"
 
 ENGINE_ICARIANASSEMBLY_EXPORT_TABLE(RUNTIME_FUNCTION_DEFINITION);
@@ -125,6 +133,16 @@ RuntimeManager::RuntimeManager()
 
     mono_dl_fallback_register(RuntimeDLOpen, RuntimeDLSymbol, NULL, NULL);
 
+    // Mono loads the image on its own when it is present, anything without one is JIT compiled
+    if (std::filesystem::exists(currentDir / AOTImageName))
+    {
+        TRACE("Using AOT runtime image");
+    }
+    else
+    {
+        TRACE("No AOT runtime image found falling back to JIT");
+    }
+
     m_domain = mono_jit_init_version("Core", "v4.0");
     m_assembly = mono_domain_assembly_open(m_domain, "IcarianCS.dll");
     IVERIFY(m_assembly != NULL);
@@ -143,14 +161,16 @@ RuntimeManager::RuntimeManager()
     MonoMethodDesc* updateDesc = mono_method_desc_new(":Update(double,double)", 0);
     IVERIFY(updateDesc != NULL);
     IDEFER(mono_method_desc_free(updateDesc));
-    m_updateMethod = mono_method_desc_search_in_class(updateDesc, m_programClass);
-    IVERIFY(m_updateMethod != NULL);
+    MonoMethod* updateMethod = mono_method_desc_search_in_class(updateDesc, m_programClass);
+    IVERIFY(updateMethod != NULL);
+    m_updateFunction = new RuntimeThunk<double, double>(updateMethod);
 
     MonoMethodDesc* lateUpdateDesc = mono_method_desc_new(":LateUpdate()", 0);
     IVERIFY(lateUpdateDesc != NULL);
     IDEFER(mono_method_desc_free(lateUpdateDesc));
-    m_lateUpdateMethod = mono_method_desc_search_in_class(lateUpdateDesc, m_programClass);
-    IVERIFY(m_lateUpdateMethod != NULL);
+    MonoMethod* lateUpdateMethod = mono_method_desc_search_in_class(lateUpdateDesc, m_programClass);
+    IVERIFY(lateUpdateMethod != NULL);
+    m_lateUpdateFunction = new RuntimeThunk<>(lateUpdateMethod);
 
     MonoMethodDesc* shutdownDesc = mono_method_desc_new(":Shutdown()", 0);
     IVERIFY(shutdownDesc != NULL);
@@ -165,8 +185,8 @@ RuntimeManager::~RuntimeManager()
     mono_runtime_invoke(m_shutdownMethod, NULL, NULL, NULL);
 
     mono_free_method(m_initMethod);
-    mono_free_method(m_updateMethod);
-    mono_free_method(m_lateUpdateMethod);
+    delete m_updateFunction;
+    delete m_lateUpdateFunction;
     mono_free_method(m_shutdownMethod);
 
     mono_jit_cleanup(m_domain);
@@ -215,19 +235,13 @@ void RuntimeManager::Update(double a_delta, double a_time)
 {
     PROFILESTACK("Runtime Update");
     
-    void* args[] =
-    {
-        &a_delta,
-        &a_time
-    };
-
-    mono_runtime_invoke(Instance->m_updateMethod, NULL, args, NULL);
+    Instance->m_updateFunction->Exec(a_delta, a_time);
 }
 void RuntimeManager::LateUpdate()
 {
     PROFILESTACK("Runtime Late Update");
 
-    mono_runtime_invoke(Instance->m_lateUpdateMethod, NULL, NULL, NULL);
+    Instance->m_lateUpdateFunction->Exec();
 }
 
 void RuntimeManager::BindFunction(const std::string_view& a_location, void* a_function)
@@ -302,7 +316,7 @@ MonoClass* RuntimeManager::GetClass(const std::string_view& a_namespace, const s
     return mono_class_from_name(Instance->m_image, a_namespace.data(), a_name.data());
 }
 
-RuntimeFunction* RuntimeManager::GetFunction(const std::string_view& a_namespace, const std::string_view& a_class, const std::string_view& a_method)
+MonoMethod* RuntimeManager::GetMethod(const std::string_view& a_namespace, const std::string_view& a_class, const std::string_view& a_method)
 {
     MonoClass* cls = mono_class_from_name(Instance->m_image, a_namespace.data(), a_class.data());
     IVERIFY(cls != NULL);
@@ -313,7 +327,11 @@ RuntimeFunction* RuntimeManager::GetFunction(const std::string_view& a_namespace
     MonoMethod* method = mono_method_desc_search_in_class(desc, cls);
     IVERIFY(method != NULL);
 
-    return new RuntimeFunction(method);
+    return method;
+}
+RuntimeFunction* RuntimeManager::GetFunction(const std::string_view& a_namespace, const std::string_view& a_class, const std::string_view& a_method)
+{
+    return new RuntimeFunction(GetMethod(a_namespace, a_class, a_method));
 }
 
 // MIT License
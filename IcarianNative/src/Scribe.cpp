@@ -14,6 +14,262 @@ Scribe* Scribe::Instance = nullptr;
 
 static std::wstring_convert<std::codecvt_utf8<char32_t>, char32_t> converter;
 
+// Strings for the runtime are built here so per frame UI text does not allocate beyond the returned string
+struct ScribeScratch
+{
+    std::u16string                Text;
+    Array<std::u16string_view>    Args;
+};
+
+static thread_local ScribeScratch Scratch;
+
+static constexpr uint64_t FNVOffsetBasis = 0xcbf29ce484222325ULL;
+static constexpr uint64_t FNVPrime = 0x100000001b3ULL;
+
+template<typename F>
+static void EncodeUTF8(char32_t a_char, F a_func)
+{
+    if (a_char < 0x80)
+    {
+        a_func((uint8_t)a_char);
+    }
+    else if (a_char < 0x800)
+    {
+        a_func((uint8_t)(0xC0 | (a_char >> 6)));
+        a_func((uint8_t)(0x80 | (a_char & 0x3F)));
+    }
+    else if (a_char < 0x10000)
+    {
+        a_func((uint8_t)(0xE0 | (a_char >> 12)));
+        a_func((uint8_t)(0x80 | ((a_char >> 6) & 0x3F)));
+        a_func((uint8_t)(0x80 | (a_char & 0x3F)));
+    }
+    else
+    {
+        a_func((uint8_t)(0xF0 | (a_char >> 18)));
+        a_func((uint8_t)(0x80 | ((a_char >> 12) & 0x3F)));
+        a_func((uint8_t)(0x80 | ((a_char >> 6) & 0x3F)));
+        a_func((uint8_t)(0x80 | (a_char & 0x3F)));
+    }
+}
+
+// Runtime keys come in as UTF-16 so walk them as UTF-8 to match the keys they were set with
+template<typename F>
+static void ForEachUTF8(const std::u16string_view& a_str, F a_func)
+{
+    const uint32_t size = (uint32_t)a_str.size();
+    for (uint32_t i = 0; i < size; ++i)
+    {
+        char32_t c = a_str[i];
+        if (c >= 0xD800 && c < 0xDC00 && i + 1 < size)
+        {
+            const char32_t low = a_str[i + 1];
+            if (low >= 0xDC00 && low < 0xE000)
+            {
+                c = 0x10000 + ((c - 0xD800) << 10) + (low - 0xDC00);
+
+                ++i;
+            }
+        }
+
+        EncodeUTF8(c, a_func);
+    }
+}
+
+static uint64_t HashKey(const std::string_view& a_key)
+{
+    uint64_t hash = FNVOffsetBasis;
+    for (const char c : a_key)
+    {
+        hash = (hash ^ (uint8_t)c) * FNVPrime;
+    }
+
+    return hash;
+}
+static uint64_t HashKey(const std::u16string_view& a_key)
+{
+    uint64_t hash = FNVOffsetBasis;
+    ForEachUTF8(a_key, [&](uint8_t a_byte)
+    {
+        hash = (hash ^ a_byte) * FNVPrime;
+    });
+
+    return hash;
+}
+
+static bool KeyEquals(const std::string& a_lhs, const std::u16string_view& a_rhs)
+{
+    uint32_t index = 0;
+    bool equal = true;
+    ForEachUTF8(a_rhs, [&](uint8_t a_byte)
+    {
+        equal = equal && index < a_lhs.size() && (uint8_t)a_lhs[index] == a_byte;
+
+        ++index;
+    });
+
+    return equal && index == a_lhs.size();
+}
+
+static void AppendUTF16(std::u16string* a_str, char32_t a_char)
+{
+    if (a_char < 0x10000)
+    {
+        a_str->push_back((char16_t)a_char);
+
+        return;
+    }
+
+    a_char -= 0x10000;
+    a_str->push_back((char16_t)(0xD800 + (a_char >> 10)));
+    a_str->push_back((char16_t)(0xDC00 + (a_char & 0x3FF)));
+}
+
+static ScribeString CompileString(const std::string_view& a_key, const std::u32string_view& a_text)
+{
+    ScribeString str;
+    str.Key = std::string(a_key);
+    str.Text = std::u32string(a_text);
+
+    const uint32_t size = (uint32_t)a_text.size();
+
+    // Work out where each character lands in UTF-16 up front so segments can index either string
+    Array<uint32_t> offsets16;
+    offsets16.Resize(size + 1);
+    for (uint32_t i = 0; i < size; ++i)
+    {
+        offsets16[i] = (uint32_t)str.Text16.size();
+        AppendUTF16(&str.Text16, a_text[i]);
+    }
+    offsets16[size] = (uint32_t)str.Text16.size();
+
+    const auto pushSegment = [&](uint32_t a_start, uint32_t a_end, uint32_t a_arg)
+    {
+        if (a_start >= a_end)
+        {
+            return;
+        }
+
+        // Literals next to each other from a placeholder that did not parse get merged
+        if (a_arg == ScribeSegment::Literal && !str.Segments.Empty())
+        {
+            ScribeSegment& last = str.Segments[str.Segments.Size() - 1];
+            if (last.Arg == ScribeSegment::Literal && last.Start + last.Length == a_start)
+            {
+                last.Length = a_end - last.Start;
+                last.Length16 = offsets16[a_end] - last.Start16;
+
+                return;
+            }
+        }
+
+        const ScribeSegment segment = 
+        {
+            .Start = a_start,
+            .Length = a_end - a_start,
+            .Start16 = offsets16[a_start],
+            .Length16 = offsets16[a_end] - offsets16[a_start],
+            .Arg = a_arg
+        };
+
+        str.Segments.Push(segment);
+    };
+
+    uint32_t literalStart = 0;
+    uint32_t i = 0;
+    while (i < size)
+    {
+        if (a_text[i] != U'{')
+        {
+            ++i;
+
+            continue;
+        }
+
+        // Matches the {0}, {1}... placeholders, no leading zeros and kept to a sane number of digits
+        uint32_t j = i + 1;
+        uint32_t arg = 0;
+        while (j < size && j - i <= 6 && a_text[j] >= U'0' && a_text[j] <= U'9')
+        {
+            arg = arg * 10 + (uint32_t)(a_text[j] - U'0');
+
+            ++j;
+        }
+
+        const uint32_t digits = j - i - 1;
+        if (digits == 0 || j >= size || a_text[j] != U'}' || (digits > 1 && a_text[i + 1] == U'0'))
+        {
+            ++i;
+
+            continue;
+        }
+
+        pushSegment(literalStart, i, ScribeSegment::Literal);
+        pushSegment(i, j + 1, arg);
+
+        i = j + 1;
+        literalStart = i;
+    }
+
+    pushSegment(literalStart, size, ScribeSegment::Literal);
+
+    return str;
+}
+
+template<typename A>
+static std::u32string FormatString(const ScribeString& a_str, const A* a_args, uint32_t a_count)
+{
+    uint32_t size = 0;
+    for (const ScribeSegment& segment : a_str.Segments)
+    {
+        if (segment.Arg < a_count)
+        {
+            size += (uint32_t)std::u32string_view(a_args[segment.Arg]).size();
+        }
+        else
+        {
+            size += segment.Length;
+        }
+    }
+
+    std::u32string str;
+    str.reserve(size);
+
+    for (const ScribeSegment& segment : a_str.Segments)
+    {
+        if (segment.Arg < a_count)
+        {
+            str.append(std::u32string_view(a_args[segment.Arg]));
+        }
+        else
+        {
+            str.append(a_str.Text, segment.Start, segment.Length);
+        }
+    }
+
+    return str;
+}
+
+static MonoString* ToMonoString(const std::u16string& a_str)
+{
+    if (a_str.empty())
+    {
+        return NULL;
+    }
+
+    return mono_string_new_utf16(mono_domain_get(), (const mono_unichar2*)a_str.data(), (int32_t)a_str.size());
+}
+
+static std::u16string_view ToStringView(MonoString* a_str)
+{
+    if (a_str == NULL)
+    {
+        return std::u16string_view();
+    }
+
+    return std::u16string_view((const char16_t*)mono_string_chars(a_str), (size_t)mono_string_length(a_str));
+}
+
 RUNTIME_FUNCTION(void, Scribe, SetInternalLanguage, 
 {
     char* language = mono_string_to_utf8(a_language);
@@ -35,53 +291,42 @@ RUNTIME_FUNCTION(uint32_t, Scribe, GetFontAddr,
 }, MonoString* a_key);
 RUNTIME_FUNCTION(MonoString*, Scribe, GetString,
 {
-    char* key = mono_string_to_utf8(a_key);
-    IDEFER(mono_free(key));
+    const std::u16string_view key = ToStringView(a_key);
+    if (key.empty())
+    {
+        return NULL;
+    }
 
-    const std::u32string str = Scribe::GetString(key);
-    if (!str.empty())
+    // Missing keys come back as the key so can hand back the same string
+    if (!Scribe::GetStringUTF16(key, &Scratch.Text))
     {
-        return mono_string_from_utf32((mono_unichar4*)str.c_str());
+        return a_key;
     }
 
-    return NULL;
+    return ToMonoString(Scratch.Text);
 }, MonoString* a_key)
 RUNTIME_FUNCTION(MonoString*, Scribe, GetStringFormated, 
 {
-    const uintptr_t size = mono_array_length(a_args);
-
-    char32_t** args = nullptr;
-    if (size > 0)
+    const std::u16string_view key = ToStringView(a_key);
+    if (key.empty())
     {
-        args = new char32_t*[size];
-        for (uintptr_t i = 0; i < size; ++i)
-        {
-            args[i] = (char32_t*)mono_string_to_utf32(mono_array_get(a_args, MonoString*, i));
-        }
+        return NULL;
     }
 
-    IDEFER(
-    if (args != nullptr)
+    // Reads the runtime strings in place rather then taking UTF-32 copies of them
+    Scratch.Args.Clear();
+    const uintptr_t size = a_args != NULL ? mono_array_length(a_args) : 0;
+    for (uintptr_t i = 0; i < size; ++i)
     {
-        for (uint32_t i = 0; i < size; ++i)
-        {
-            mono_free(args[i]);
-        }
-
-        delete[] args;
-    });
-
-    char* key = mono_string_to_utf8(a_key);
-    IDEFER(mono_free(key));
-
-    const std::u32string str = Scribe::GetStringFormated(key, args, (uint32_t)size);
+        Scratch.Args.Push(ToStringView(mono_array_get(a_args, MonoString*, i)));
+    }
 
-    if (!str.empty())
+    if (!Scribe::GetStringFormatedUTF16(key, Scratch.Args.Data(), (uint32_t)size, &Scratch.Text))
     {
-        return mono_string_from_utf32((mono_unichar4*)str.c_str());
+        return a_key;
     }
 
-    return NULL;
+    return ToMonoString(Scratch.Text);
 }, MonoString* a_key, MonoArray* a_args)
 
 RUNTIME_FUNCTION(void, Scribe, SetFont,
@@ -176,73 +421,164 @@ uint32_t Scribe::GetFont(const std::string_view& a_key)
     return -1;
 }
 
+const ScribeString* Scribe::FindString(const std::string_view& a_key) const
+{
+    const auto iter = m_strings.find(HashKey(a_key));
+    if (iter != m_strings.end() && iter->second.Key == a_key)
+    {
+        return &iter->second;
+    }
+
+    return nullptr;
+}
+const ScribeString* Scribe::FindString(const std::u16string_view& a_key) const
+{
+    const auto iter = m_strings.find(HashKey(a_key));
+    if (iter != m_strings.end() && KeyEquals(iter->second.Key, a_key))
+    {
+        return &iter->second;
+    }
+
+    return nullptr;
+}
+
+bool Scribe::KeyExists(const std::string_view& a_key)
+{
+    IVERIFY(Instance != nullptr);
+
+    const SharedThreadGuard g = SharedThreadGuard(Instance->m_lock);
+
+    return Instance->FindString(a_key) != nullptr;
+}
+
+void Scribe::SetString(const std::string_view& a_key, const std::u32string_view& a_string)
+{
+    IVERIFY(Instance != nullptr);
+
+    const uint64_t hash = HashKey(a_key);
+    const ScribeString str = CompileString(a_key, a_string);
+
+    const ThreadGuard g = ThreadGuard(Instance->m_lock);
+
+    const auto iter = Instance->m_strings.find(hash);
+    if (iter != Instance->m_strings.end() && iter->second.Key != a_key)
+    {
+        IERROR("Scribe key hash collision: " + std::string(a_key) + " and " + iter->second.Key);
+
+        // Keep the existing string otherwise lookups for the other key would silently return this one
+        return;
+    }
+
+    Instance->m_strings[hash] = str;
+}
+
 std::u32string Scribe::GetString(const std::string_view& a_key)
 {
     IVERIFY(Instance != nullptr);
-    
-    const std::string key = std::string(a_key);
-    if (Instance->m_strings.Exists(key))
+
     {
-        return Instance->m_strings[key];
+        const SharedThreadGuard g = SharedThreadGuard(Instance->m_lock);
+
+        const ScribeString* str = Instance->FindString(a_key);
+        if (str != nullptr)
+        {
+            return str->Text;
+        }
     }
 
-    return converter.from_bytes(key);
+    return converter.from_bytes(a_key.data(), a_key.data() + a_key.size());
 }
 std::u32string Scribe::GetStringFormated(const std::string_view& a_key, const char32_t* const* a_args, uint32_t a_count)
 {
-    std::u32string str = GetString(a_key);
+    IVERIFY(Instance != nullptr);
 
-    if (str.empty())
     {
-        return str;
+        const SharedThreadGuard g = SharedThreadGuard(Instance->m_lock);
+
+        const ScribeString* str = Instance->FindString(a_key);
+        if (str != nullptr)
+        {
+            return FormatString(*str, a_args, a_count);
+        }
     }
 
-    for (uint32_t i = 0; i < a_count; ++i)
+    return converter.from_bytes(a_key.data(), a_key.data() + a_key.size());
+}
+std::u32string Scribe::GetStringFormated(const std::string_view& a_key, const std::u32string* a_args, uint32_t a_count)
+{
+    IVERIFY(Instance != nullptr);
+
     {
-        const std::u32string iStr = converter.from_bytes("{" + std::to_string(i) + "}");
-        const size_t size = iStr.size();
+        const SharedThreadGuard g = SharedThreadGuard(Instance->m_lock);
 
-        while (true)
+        const ScribeString* str = Instance->FindString(a_key);
+        if (str != nullptr)
         {
-            const std::size_t pos = str.find(iStr);
-            if (pos == std::u32string::npos)
-            {
-                break;
-            }
-
-            str.replace(pos, size, a_args[i]);
-        }   
+            return FormatString(*str, a_args, a_count);
+        }
     }
 
-    return str;
+    return converter.from_bytes(a_key.data(), a_key.data() + a_key.size());
 }
-std::u32string Scribe::GetStringFormated(const std::string_view& a_key, const std::u32string* a_args, uint32_t a_count)
+
+bool Scribe::GetStringUTF16(const std::u16string_view& a_key, std::u16string* a_out)
 {
-    std::u32string str = GetString(a_key);
+    IVERIFY(Instance != nullptr);
+
+    const SharedThreadGuard g = SharedThreadGuard(Instance->m_lock);
 
-    if (str.empty())
+    const ScribeString* str = Instance->FindString(a_key);
+    if (str == nullptr)
     {
-        return str;
+        return false;
     }
 
-    for (uint32_t i = 0; i < a_count; ++i)
+    a_out->assign(str->Text16);
+
+    return true;
+}
+bool Scribe::GetStringFormatedUTF16(const std::u16string_view& a_key, const std::u16string_view* a_args, uint32_t a_count, std::u16string* a_out)
+{
+    IVERIFY(Instance != nullptr);
+
+    const SharedThreadGuard g = SharedThreadGuard(Instance->m_lock);
+
+    const ScribeString* str = Instance->FindString(a_key);
+    if (str == nullptr)
     {
-        const std::u32string iStr = converter.from_bytes("{" + std::to_string(i) + "}");
-        const size_t size = iStr.size();
+        return false;
+    }
 
-        while (true)
+    uint32_t size = 0;
+    for (const ScribeSegment& segment : str->Segments)
+    {
+        if (segment.Arg < a_count)
         {
-            const std::size_t pos = str.find(iStr);
-            if (pos == std::u32string::npos)
-            {
-                break;
-            }
+            size += (uint32_t)a_args[segment.Arg].size();
+        }
+        else
+        {
+            size += segment.Length16;
+        }
+    }
+
+    // Buffer keeps its capacity between calls so only grows on the longest string seen
+    a_out->clear();
+    a_out->reserve(size);
 
-            str.replace(pos, size, a_args[i]);
-        }   
+    for (const ScribeSegment& segment : str->Segments)
+    {
+        if (segment.Arg < a_count)
+        {
+            a_out->append(a_args[segment.Arg]);
+        }
+        else
+        {
+            a_out->append(str->Text16, segment.Start16, segment.Length16);
+        }
     }
 
-    return str;
+    return true;
 }
 
 // MIT License
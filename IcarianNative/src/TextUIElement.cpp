@@ -4,37 +4,33 @@
 
 #include "Rendering/UI/TextUIElement.h"
 
-#include "Core/Bitfield.h"
-#include "Core/IcarianAssert.h"
 #include "Rendering/RenderEngine.h"
 #include "Rendering/UI/Font.h"
+#include "Rendering/UI/GlyphAtlas.h"
 
 TextUIElement::TextUIElement() : UIElement()
 {
     m_fontAddr = -1;
     m_fontSize = 10.0f;
 
-    m_textureAddr = -1;
-    m_samplerAddr = -1;
+    m_atlas = nullptr;
+    m_builtSize = glm::vec2(0.0f);
 
     m_flags = 0;
-
-    m_lastRenderEngine = nullptr;
 }
 TextUIElement::~TextUIElement()
 {
-    if (m_textureAddr != -1)
-    {
-        ICARIAN_ASSERT_MSG(m_lastRenderEngine != nullptr, "TextUIElement last render engine is null");
 
-        m_lastRenderEngine->DestroyTexture(m_textureAddr);
-    }
-    if (m_samplerAddr != -1)
-    {
-        ICARIAN_ASSERT_MSG(m_lastRenderEngine != nullptr, "TextUIElement last render engine is null");
+}
 
-        m_lastRenderEngine->DestroyTextureSampler(m_samplerAddr);
+uint32_t TextUIElement::GetSamplerAddr() const
+{
+    if (m_atlas == nullptr)
+    {
+        return -1;
     }
+
+    return m_atlas->GetSamplerAddr();
 }
 
 void TextUIElement::SetFontAddr(uint32_t a_addr)
@@ -60,39 +56,86 @@ void TextUIElement::SetText(const std::u32string_view& a_text)
     ISETBIT(m_flags, RefreshBit);
 }
 
-void TextUIElement::Update(RenderEngine* a_renderEngine)
+void TextUIElement::Rebuild(RenderEngine* a_renderEngine)
 {
-    if (IISBITSET(m_flags, RefreshBit) && m_fontAddr != -1)
+    const SharedThreadGuard g = SharedThreadGuard(m_lock);
+
+    Font* font = a_renderEngine->GetFont(m_fontAddr);
+    if (font == nullptr)
     {
-        const SharedThreadGuard g = SharedThreadGuard(m_lock);
+        return;
+    }
 
-        if (m_textureAddr != -1)
-        {
-            m_lastRenderEngine->DestroyTexture(m_textureAddr);
-        }
-        if (m_samplerAddr != -1)
+    m_atlas = font->GetGlyphAtlas();
+    m_builtSize = GetSize();
+
+    // Keeps capacity so changing text of similar length does not allocate
+    m_quads.Clear();
+
+    // Positions are normalized against the element size so the quads land where the old per element texture texels did
+    const glm::vec2 invSize = 1.0f / glm::max(m_builtSize, glm::vec2(1.0f));
+    // Atlas metrics are at the base size of the distance field
+    const float scale = m_fontSize / m_atlas->GetBaseFontSize();
+    const float lineHeight = m_atlas->GetLineHeight() * scale;
+
+    glm::vec2 pen = glm::vec2(0.0f, lineHeight);
+    for (const char32_t codepoint : m_text)
+    {
+        if (codepoint == '\n')
         {
-            m_lastRenderEngine->DestroyTextureSampler(m_samplerAddr);
+            pen.x = 0.0f;
+            pen.y += lineHeight;
+
+            continue;
         }
 
-        const Font* font = a_renderEngine->GetFont(m_fontAddr);
-        if (font == nullptr)
+        const GlyphInfo* glyph = m_atlas->GetGlyph(codepoint);
+
+        if (glyph->Size.x > 0.0f && glyph->Size.y > 0.0f)
         {
-            return;
+            const glm::vec2 min = (pen + glyph->Offset * scale) * invSize;
+            const glm::vec2 max = (pen + (glyph->Offset + glyph->Size) * scale) * invSize;
+
+            // Out of the element rect and would get clipped anyway
+            if (min.x < 1.0f && min.y < 1.0f)
+            {
+                const UITextQuad quad = 
+                { 
+                    .Min = min, 
+                    .Max = max, 
+                    .TexMin = glyph->TexMin, 
+                    .TexMax = glyph->TexMax 
+                };
+
+                m_quads.Push(quad);
+            }
         }
 
-        const glm::vec2 size = GetSize();
+        pen.x += glyph->Advance * scale;
+    }
 
-        const unsigned char* data = font->StringToTexture(m_text, m_fontSize, (uint32_t)size.x, (uint32_t)size.y);
-        IDEFER(delete[] data);
+    ICLEARBIT(m_flags, RefreshBit);
+    ISETBIT(m_flags, ValidBit);
 
-        m_textureAddr = a_renderEngine->GenerateTexture((uint32_t)size.x, (uint32_t)size.y, TextureFormat_Alpha, data);
-        m_samplerAddr = a_renderEngine->GenerateTextureSampler(m_textureAddr, TextureMode_Texture, TextureFilter_Linear, TextureAddress_ClampToEdge);
+    MarkDirty();
+}
 
-        m_lastRenderEngine = a_renderEngine;
+void TextUIElement::Update(RenderEngine* a_renderEngine)
+{
+    if (m_fontAddr == -1)
+    {
+        return;
+    }
 
-        ICLEARBIT(m_flags, RefreshBit);
-        ISETBIT(m_flags, ValidBit);
+    if (IISBITSET(m_flags, RefreshBit) || GetSize() != m_builtSize)
+    {
+        Rebuild(a_renderEngine);
+    }
+
+    // New glyphs only get rasterized into the shared atlas so this is a no op unless a glyph was seen for the first time
+    if (m_atlas != nullptr)
+    {
+        m_atlas->Flush(a_renderEngine);
     }
 }
 
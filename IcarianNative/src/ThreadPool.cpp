@@ -11,7 +11,6 @@
 #include "Core/IcarianDefer.h"
 #include "Logger.h"
 #include "Runtime/RuntimeManager.h"
-#include "Runtime/RuntimeFunction.h"
 #include "RuntimeThreadJob.h"
 #include "Trace.h"
 
@@ -42,7 +41,7 @@ ThreadPool::ThreadPool(uint32_t a_threadCount)
     m_threads = new std::thread[m_threadCount];
     m_join = new bool[m_threadCount];
 
-    m_runtimeDispatch = RuntimeManager::GetFunction("IcarianEngine", "ThreadPool", ":Dispatch(uint)");
+    m_runtimeDispatch = RuntimeManager::GetThunk<uint32_t>("IcarianEngine", "ThreadPool", ":Dispatch(uint)");
 
     for (uint32_t i = 0; i < m_threadCount; ++i)
     {
@@ -252,12 +251,7 @@ void ThreadPool::Run(uint32_t a_thread)
 
 void ThreadPool::Dispath(uint32_t a_objectAddr)
 {
-    void* args[] =
-    {
-        &a_objectAddr
-    };
-
-    Instance->m_runtimeDispatch->Exec(args);
+    Instance->m_runtimeDispatch->Exec(a_objectAddr);
 }
 
 // MIT License
@@ -0,0 +1,359 @@
+// Icarian Engine - C# Game Engine
+// 
+// License at end of file.
+
+#include "Rendering/UI/UIBatcher.h"
+
+#include <cstring>
+
+#include "IcarianError.h"
+#include "Rendering/UI/ImageUIElement.h"
+#include "Rendering/UI/TextUIElement.h"
+#include "Rendering/UI/UIControl.h"
+#include "Rendering/UI/UIElement.h"
+#include "Trace.h"
+
+static constexpr uint64_t HashOffset = 14695981039346656037ULL;
+static constexpr uint64_t HashPrime = 1099511628211ULL;
+
+static void HashCombine(uint64_t* a_hash, uint64_t a_value)
+{
+    *a_hash = (*a_hash ^ a_value) * HashPrime;
+}
+
+static void PushQuad(Array<UIBatchVertex>* a_vertices, const glm::vec2& a_min, const glm::vec2& a_max, const glm::vec2& a_texMin, const glm::vec2& a_texMax, const glm::vec4& a_color)
+{
+    const UIBatchVertex tl = { glm::vec2(a_min.x, a_min.y), glm::vec2(a_texMin.x, a_texMin.y), a_color };
+    const UIBatchVertex tr = { glm::vec2(a_max.x, a_min.y), glm::vec2(a_texMax.x, a_texMin.y), a_color };
+    const UIBatchVertex bl = { glm::vec2(a_min.x, a_max.y), glm::vec2(a_texMin.x, a_texMax.y), a_color };
+    const UIBatchVertex br = { glm::vec2(a_max.x, a_max.y), glm::vec2(a_texMax.x, a_texMax.y), a_color };
+
+    a_vertices->Push(tl);
+    a_vertices->Push(bl);
+    a_vertices->Push(tr);
+
+    a_vertices->Push(tr);
+    a_vertices->Push(bl);
+    a_vertices->Push(br);
+}
+
+UIBatcher::UIBatcher()
+{
+    m_hash = 0;
+    m_screenSize = glm::vec2(0.0f);
+}
+UIBatcher::~UIBatcher()
+{
+
+}
+
+void UIBatcher::UpdateElement(uint32_t a_addr, RenderEngine* a_renderEngine, uint64_t* a_hash)
+{
+    UIElement* element = UIControl::GetUIElement(a_addr);
+    if (element == nullptr)
+    {
+        return;
+    }
+
+    element->Update(a_renderEngine);
+
+    HashCombine(a_hash, a_addr);
+    HashCombine(a_hash, element->GetVersion());
+
+    switch (element->GetType())
+    {
+    case UIElementType_Text:
+    {
+        // The atlas gets a new sampler when it grows
+        const TextUIElement* text = (TextUIElement*)element;
+        HashCombine(a_hash, text->GetSamplerAddr());
+
+        break;
+    }
+    default:
+    {
+        break;
+    }
+    }
+
+    const uint32_t childCount = element->GetChildCount();
+    const uint32_t* children = element->GetChildren();
+    for (uint32_t i = 0; i < childCount; ++i)
+    {
+        UpdateElement(children[i], a_renderEngine, a_hash);
+    }
+}
+
+bool UIBatcher::Update(const CanvasBuffer& a_canvas, const glm::vec2& a_screenSize, RenderEngine* a_renderEngine)
+{
+    // Walking the canvas is still needed to update the elements so fold everything that affects drawing into a hash on the way
+    uint64_t hash = HashOffset;
+
+    uint64_t refResolution;
+    memcpy(&refResolution, &a_canvas.ReferenceResolution, sizeof(uint64_t));
+    HashCombine(&hash, refResolution);
+
+    for (uint32_t i = 0; i < a_canvas.ChildCount; ++i)
+    {
+        const uint32_t addr = a_canvas.ChildElements[i];
+        if (addr == -1)
+        {
+            continue;
+        }
+
+        UpdateElement(addr, a_renderEngine, &hash);
+    }
+
+    if (hash == m_hash && a_screenSize == m_screenSize)
+    {
+        return false;
+    }
+
+    m_hash = hash;
+    m_screenSize = a_screenSize;
+
+    Build(a_canvas, a_screenSize);
+
+    return true;
+}
+
+void UIBatcher::AddElement(const CanvasBuffer& a_canvas, uint32_t a_addr, const glm::vec2& a_screenSize)
+{
+    const UIElement* element = UIControl::GetUIElement(a_addr);
+    if (element == nullptr)
+    {
+        return;
+    }
+
+    const glm::vec2 pos = element->GetCanvasPosition(a_canvas, a_screenSize);
+    const glm::vec2 scale = element->GetCanvasScale(a_canvas, a_screenSize);
+    const glm::vec4 color = element->GetColor();
+
+    m_elementVertices.Clear();
+
+    switch (element->GetType())
+    {
+    case UIElementType_Base:
+    {
+        break;
+    }
+    case UIElementType_Text:
+    {
+        const TextUIElement* text = (TextUIElement*)element;
+        const uint32_t samplerAddr = text->GetSamplerAddr();
+        if (!text->IsValid() || samplerAddr == -1)
+        {
+            break;
+        }
+
+        for (const UITextQuad& quad : text->GetQuads())
+        {
+            // Clip to the element on the CPU instead of a scissor per element so elements can share a draw
+            const glm::vec2 min = glm::max(quad.Min, glm::vec2(0.0f));
+            const glm::vec2 max = glm::min(quad.Max, glm::vec2(1.0f));
+            if (min.x >= max.x || min.y >= max.y)
+            {
+                continue;
+            }
+
+            const glm::vec2 texScale = (quad.TexMax - quad.TexMin) / (quad.Max - quad.Min);
+            const glm::vec2 texMin = quad.TexMin + (min - quad.Min) * texScale;
+            const glm::vec2 texMax = quad.TexMin + (max - quad.Min) * texScale;
+
+            PushQuad(&m_elementVertices, pos + min * scale, pos + max * scale, texMin, texMax, color);
+        }
+
+        if (!m_elementVertices.Empty())
+        {
+            AddTriangles(UIBatchType_Text, samplerAddr, m_elementVertices.Data(), m_elementVertices.Size());
+        }
+
+        break;
+    }
+    case UIElementType_Image:
+    {
+        const ImageUIElement* image = (ImageUIElement*)element;
+        const uint32_t samplerAddr = image->GetSamplerAddr();
+        if (samplerAddr == -1)
+        {
+            break;
+        }
+
+        PushQuad(&m_elementVertices, pos, pos + scale, glm::vec2(0.0f), glm::vec2(1.0f), color);
+
+        AddTriangles(UIBatchType_Image, samplerAddr, m_elementVertices.Data(), m_elementVertices.Size());
+
+        break;
+    }
+    default:
+    {
+        IERROR("Invalid UIElement Type");
+
+        break;
+    }
+    }
+
+    const uint32_t childCount = element->GetChildCount();
+    const uint32_t* children = element->GetChildren();
+    for (uint32_t i = 0; i < childCount; ++i)
+    {
+        AddElement(a_canvas, children[i], a_screenSize);
+    }
+}
+
+void UIBatcher::Build(const CanvasBuffer& a_canvas, const glm::vec2& a_screenSize)
+{
+    TRACE("Building UI batches");
+
+    Begin();
+
+    for (uint32_t i = 0; i < a_canvas.ChildCount; ++i)
+    {
+        const uint32_t addr = a_canvas.ChildElements[i];
+        if (addr == -1)
+        {
+            continue;
+        }
+
+        AddElement(a_canvas, addr, a_screenSize);
+    }
+
+    End();
+}
+
+uint32_t UIBatcher::GetBatch(e_UIBatchType a_type, uint32_t a_samplerAddr, const glm::vec2& a_min, const glm::vec2& a_max)
+{
+    const uint32_t count = m_pendingBatches.Size();
+    const uint32_t end = count > MaxBatchLookback ? count - MaxBatchLookback : 0;
+
+    for (uint32_t i = count; i > end; --i)
+    {
+        PendingBatch& batch = m_pendingBatches[i - 1];
+        if (batch.Type == a_type && batch.SamplerAddr == a_samplerAddr)
+        {
+            batch.Min = glm::min(batch.Min, a_min);
+            batch.Max = glm::max(batch.Max, a_max);
+
+            return i - 1;
+        }
+
+        // Moving past something it overlaps would change what ends up on top
+        if (a_min.x < batch.Max.x && a_max.x > batch.Min.x && a_min.y < batch.Max.y && a_max.y > batch.Min.y)
+        {
+            break;
+        }
+    }
+
+    const PendingBatch batch = 
+    {
+        .Type = a_type,
+        .SamplerAddr = a_samplerAddr,
+        .Min = a_min,
+        .Max = a_max
+    };
+
+    m_pendingBatches.Push(batch);
+
+    return count;
+}
+
+void UIBatcher::Begin()
+{
+    m_pendingBatches.Clear();
+    m_pendingRanges.Clear();
+    m_pendingVertices.Clear();
+}
+void UIBatcher::AddTriangles(e_UIBatchType a_type, uint32_t a_samplerAddr, const UIBatchVertex* a_vertices, uint32_t a_count)
+{
+    if (a_count == 0)
+    {
+        return;
+    }
+
+    glm::vec2 min = a_vertices[0].Position;
+    glm::vec2 max = a_vertices[0].Position;
+    for (uint32_t i = 1; i < a_count; ++i)
+    {
+        min = glm::min(min, a_vertices[i].Position);
+        max = glm::max(max, a_vertices[i].Position);
+    }
+
+    const PendingRange range = 
+    {
+        .Batch = GetBatch(a_type, a_samplerAddr, min, max),
+        .FirstVertex = m_pendingVertices.Size(),
+        .VertexCount = a_count
+    };
+
+    m_pendingRanges.Push(range);
+
+    for (uint32_t i = 0; i < a_count; ++i)
+    {
+        m_pendingVertices.Push(a_vertices[i]);
+    }
+}
+void UIBatcher::End()
+{
+    m_batches.Clear();
+
+    const uint32_t batchCount = m_pendingBatches.Size();
+    for (uint32_t i = 0; i < batchCount; ++i)
+    {
+        const UIBatch batch = 
+        {
+            .Type = m_pendingBatches[i].Type,
+            .SamplerAddr = m_pendingBatches[i].SamplerAddr,
+            .FirstVertex = 0,
+            .VertexCount = 0
+        };
+
+        m_batches.Push(batch);
+    }
+
+    // Ranges were added in draw order so bucketing them by batch keeps the order within a batch
+    for (const PendingRange& range : m_pendingRanges)
+    {
+        m_batches[range.Batch].VertexCount += range.VertexCount;
+    }
+
+    uint32_t vertexCount = 0;
+    for (UIBatch& batch : m_batches)
+    {
+        batch.FirstVertex = vertexCount;
+        vertexCount += batch.VertexCount;
+
+        batch.VertexCount = 0;
+    }
+
+    m_vertices.Resize(vertexCount);
+
+    for (const PendingRange& range : m_pendingRanges)
+    {
+        UIBatch& batch = m_batches[range.Batch];
+
+        memcpy(m_vertices.Data() + batch.FirstVertex + batch.VertexCount, m_pendingVertices.Data() + range.FirstVertex, range.VertexCount * sizeof(UIBatchVertex));
+        batch.VertexCount += range.VertexCount;
+    }
+}
+
+// MIT License
+// 
+// Copyright (c) 2024 River Govers
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE
\ No newline at end of file
@@ -4,12 +4,15 @@
 
 #include "Rendering/UI/UIControl.h"
 
+#include <cstring>
+
 #include "Core/Bitfield.h"
+#include "Core/IcarianDefer.h"
 #include "IcarianError.h"
 #include "Logger.h"
 #include "Rendering/UI/UIControlBindings.h"
 #include "Rendering/UI/UIElement.h"
-#include "Runtime/RuntimeFunction.h"
+#include "Rendering/UI/UIHitGrid.h"
 #include "Runtime/RuntimeManager.h"
 
 UIControl* UIControl::Instance = nullptr;
@@ -18,20 +21,21 @@ UIControl::UIControl()
 {
     m_bindings = new UIControlBindings(this);
 
-    m_onNormal = RuntimeManager::GetFunction("IcarianEngine.Rendering.UI", "UIElement", ":OnNormalS(uint,uint)");
-    m_onHover = RuntimeManager::GetFunction("IcarianEngine.Rendering.UI", "UIElement", ":OnHoverS(uint,uint)");
-    m_onPressed = RuntimeManager::GetFunction("IcarianEngine.Rendering.UI", "UIElement", ":OnPressedS(uint,uint)");
-    m_onReleased = RuntimeManager::GetFunction("IcarianEngine.Rendering.UI", "UIElement", ":OnReleasedS(uint,uint)");
+    m_onStateChanged = RuntimeManager::GetThunk<MonoArray*, uint32_t>("IcarianEngine.Rendering.UI", "UIElement", ":OnStateChangedS(uint[],uint)");
+
+    m_layoutGeneration = 0;
 }
 UIControl::~UIControl()
 {
-    delete m_onNormal;
-    delete m_onHover;
-    delete m_onPressed;
-    delete m_onReleased;
+    delete m_onStateChanged;
 
     delete m_bindings;
 
+    for (UIHitGrid* grid : m_hitGrids)
+    {
+        delete grid;
+    }
+
     for (uint32_t i = 0; i < m_canvas.Size(); ++i)
     {
         if (!m_canvas.Exists(i))
@@ -87,6 +91,8 @@ void UIControl::SetCanvas(uint32_t a_addr, const CanvasBuffer& a_buffer)
     IVERIFY(Instance->m_canvas.Exists(a_addr));
 
     Instance->m_canvas.LockSet(a_addr, a_buffer);
+
+    MarkLayoutDirty();
 }
 
 UIElement* UIControl::GetUIElement(uint32_t a_addr)
@@ -97,212 +103,37 @@ UIElement* UIControl::GetUIElement(uint32_t a_addr)
     return Instance->m_uiElements[a_addr];
 }
 
-static bool IsInside(const CanvasBuffer& a_canvas, const UIElement* a_element, const glm::vec2& a_pos, const glm::vec2& a_screenSize)
+void UIControl::MarkLayoutDirty()
 {
-    const glm::vec2 pos = a_element->GetCanvasPosition(a_canvas, a_screenSize);
-    const glm::vec2 size = a_element->GetCanvasScale(a_canvas, a_screenSize);
-
-    const glm::vec2 scaledPos = pos * a_screenSize;
-    const glm::vec2 scaledSize = size * a_screenSize;
-
-    const glm::vec2 endPos = scaledPos + scaledSize;
-
-    return a_pos.x >= scaledPos.x && a_pos.x <= endPos.x &&
-        a_pos.y >= scaledPos.y && a_pos.y <= endPos.y;
+    ++Instance->m_layoutGeneration;
 }
 
-void UIControl::SendCursor(uint32_t a_canvasAddr, uint32_t a_elementAddr, const glm::vec2& a_pos, const glm::vec2& a_screenSize)
+UIHitGrid* UIControl::GetHitGrid(uint32_t a_canvasAddr, const CanvasBuffer& a_canvas, const glm::vec2& a_screenSize)
 {
-    IVERIFY(a_canvasAddr < Instance->m_canvas.Size());
-    IVERIFY(Instance->m_canvas.Exists(a_canvasAddr));
-    IVERIFY(a_elementAddr < Instance->m_uiElements.Size());
-    IVERIFY(Instance->m_uiElements.Exists(a_elementAddr));
-
-    const CanvasBuffer& canvas = Instance->m_canvas[a_canvasAddr];
-    UIElement* element = Instance->m_uiElements[a_elementAddr];    
-
-    const e_ElementState state = element->GetState();
-
-    if (IsInside(canvas, element, a_pos, a_screenSize))
+    while (m_hitGrids.Size() <= a_canvasAddr)
     {
-        if (state == ElementState_Normal)
-        {
-            element->SetState(ElementState_Hovered);
-
-            void* args[] = { &a_canvasAddr, &a_elementAddr };
-
-            Instance->m_onHover->Exec(args);
-        }
+        m_hitGrids.Push(new UIHitGrid());
     }
-    else if (state == ElementState_Hovered)
-    {
-        element->SetState(ElementState_Normal);
 
-        void* args[] = 
-        { 
-            &a_canvasAddr, 
-            &a_elementAddr 
-        };
+    UIHitGrid* grid = m_hitGrids[a_canvasAddr];
 
-        Instance->m_onNormal->Exec(args);
-    }
-
-    const uint32_t childCount = element->GetChildCount();
-    const uint32_t* children = element->GetChildren();
-    for (uint32_t i = 0; i < childCount; ++i)
+    // Read before building so a change made mid build still triggers a rebuild next time
+    const uint32_t generation = m_layoutGeneration;
+    if (!grid->IsValid(generation, a_screenSize))
     {
-        if (children[i] < 0)
-        {
-            continue;
-        }
-
-        Instance->SendCursor(a_canvasAddr, children[i], a_pos, a_screenSize);
+        grid->Build(a_canvas, generation, a_screenSize);
     }
-}
-
-bool UIControl::SendClick(uint32_t a_canvasAddr, uint32_t a_elementAddr, const glm::vec2& a_pos, const glm::vec2& a_screenSize)
-{
-    IVERIFY(a_canvasAddr < Instance->m_canvas.Size());
-    IVERIFY(Instance->m_canvas.Exists(a_canvasAddr));
-    IVERIFY(a_elementAddr < Instance->m_uiElements.Size());
-    IVERIFY(Instance->m_uiElements.Exists(a_elementAddr));
 
-    const CanvasBuffer& canvas = Instance->m_canvas[a_canvasAddr];
-    UIElement* element = Instance->m_uiElements[a_elementAddr];
-
-    const e_ElementState state = element->GetState();
-
-    if (IsInside(canvas, element, a_pos, a_screenSize))
-    {
-        if (state != ElementState_Pressed)
-        {
-            element->SetState(ElementState_Pressed);
-
-            void* args[] = { &a_canvasAddr, &a_elementAddr };
-
-            Instance->m_onPressed->Exec(args);
-        }
-        
-        return true;
-    }
-    else 
-    {
-        switch (state)
-        {
-        case ElementState_Pressed:
-        case ElementState_Released:
-        {
-            element->SetState(ElementState_Normal);
-
-            void* args[] = 
-            { 
-                &a_canvasAddr, 
-                &a_elementAddr 
-            };
-
-            Instance->m_onNormal->Exec(args);
-
-            break;
-        }
-        default:
-        {
-            break;
-        }
-        }
-    }
-
-    const uint32_t childCount = element->GetChildCount();
-    const uint32_t* children = element->GetChildren();
-    for (uint32_t i = 0; i < childCount; ++i)
-    {
-        if (children[i] < 0)
-        {
-            continue;
-        }
-
-        if (Instance->SendClick(a_canvasAddr, children[i], a_pos, a_screenSize))
-        {
-            return true;
-        }
-    }
-
-    return false;
+    return grid;
 }
 
-void UIControl::SendRelease(uint32_t a_canvasAddr, uint32_t a_elementAddr, const glm::vec2& a_pos, const glm::vec2& a_screenSize)
+void UIControl::SetElementState(uint32_t a_canvasAddr, uint32_t a_elementAddr, UIElement* a_element, e_ElementState a_state)
 {
-    IVERIFY(a_canvasAddr < Instance->m_canvas.Size());
-    IVERIFY(Instance->m_canvas.Exists(a_canvasAddr));
-    IVERIFY(a_elementAddr < Instance->m_uiElements.Size());
-    IVERIFY(Instance->m_uiElements.Exists(a_elementAddr));
-
-    const CanvasBuffer& canvas = Instance->m_canvas[a_canvasAddr];
-    UIElement* element = Instance->m_uiElements[a_elementAddr];
-
-    const e_ElementState state = element->GetState();
-
-    if (IsInside(canvas, element, a_pos, a_screenSize))
-    {
-        switch (state)
-        {
-        case ElementState_Pressed:
-        {
-            element->SetState(ElementState_Released);
-
-            void* args[] = 
-            { 
-                &a_canvasAddr, 
-                &a_elementAddr 
-            };
-
-            Instance->m_onReleased->Exec(args);
-
-            break;
-        }
-        case ElementState_Released:
-        {
-            element->SetState(ElementState_Hovered);
-
-            void* args[] = 
-            { 
-                &a_canvasAddr, 
-                &a_elementAddr 
-            };
-
-            Instance->m_onHover->Exec(args);
-
-            break;
-        }
-        default:
-        {
-            break;
-        }
-        }
-    }
-    else if (state == ElementState_Released)
-    {
-        element->SetState(ElementState_Normal);
-
-        void* args[] = 
-        { 
-            &a_canvasAddr, 
-            &a_elementAddr 
-        };
-
-        Instance->m_onNormal->Exec(args);
-    }
-
-    const uint32_t childCount = element->GetChildCount();
-    const uint32_t* children = element->GetChildren();
-    for (uint32_t i = 0; i < childCount; ++i)
-    {
-        if (children[i] < 0)
-        {
-            continue;
-        }
+    a_element->SetState(a_state);
 
-        Instance->SendRelease(a_canvasAddr, children[i], a_pos, a_screenSize);
-    }
+    m_stateEvents.Push(a_canvasAddr);
+    m_stateEvents.Push(a_elementAddr);
+    m_stateEvents.Push((uint32_t)a_state);
 }
 
 void UIControl::UpdateCursor(const glm::vec2& a_pos, const glm::vec2& a_size)
@@ -326,17 +157,37 @@ void UIControl::UpdateCursor(const glm::vec2& a_pos, const glm::vec2& a_size)
             continue;
         }
 
-        const uint32_t childCount = canvas.ChildCount;
-        const uint32_t* children = canvas.ChildElements;
-        for (uint32_t j = 0; j < childCount; ++j) 
+        UIHitGrid* grid = Instance->GetHitGrid(i, canvas, a_size);
+
+        Instance->m_hits.Clear();
+        grid->Query(a_pos, &Instance->m_hits);
+
+        for (const uint32_t index : Instance->m_hits)
         {
-            if (children[j] < 0) 
+            const uint32_t addr = grid->GetEntry(index).ElementAddr;
+            UIElement* element = Instance->m_uiElements[addr];
+
+            if (element->GetState() == ElementState_Normal)
             {
-                continue;
+                Instance->SetElementState(i, addr, element, ElementState_Hovered);
+
+                grid->MarkActive(index);
             }
+        }
 
-            Instance->SendCursor(i, children[j], a_pos, a_size);
+        // Anything not under the cursor can only change if it was hovered
+        for (const uint32_t index : grid->GetActive())
+        {
+            const UIHitEntry& entry = grid->GetEntry(index);
+            UIElement* element = Instance->m_uiElements[entry.ElementAddr];
+
+            if (element->GetState() == ElementState_Hovered && !entry.Contains(a_pos))
+            {
+                Instance->SetElementState(i, entry.ElementAddr, element, ElementState_Normal);
+            }
         }
+
+        grid->PruneActive();
     }
 }
 
@@ -361,20 +212,60 @@ bool UIControl::SubmitClick(const glm::vec2& a_pos, const glm::vec2& a_size)
             continue;
         }
 
-        const uint32_t childCount = canvas.ChildCount;
-        const uint32_t* children = canvas.ChildElements;
-        for (uint32_t j = 0; j < childCount; ++j)
+        UIHitGrid* grid = Instance->GetHitGrid(i, canvas, a_size);
+
+        Instance->m_hits.Clear();
+        grid->Query(a_pos, &Instance->m_hits);
+
+        // Clicks stop at the first element in tree order so only elements before it get reset
+        // Anything before it cannot contain the cursor otherwise it would have been the hit
+        const uint32_t hit = Instance->m_hits.Empty() ? -1 : Instance->m_hits[0];
+
+        for (const uint32_t index : grid->GetActive())
         {
-            if (children[j] < 0)
+            if (index >= hit)
             {
                 continue;
             }
 
-            if (Instance->SendClick(i, children[j], a_pos, a_size))
+            const uint32_t addr = grid->GetEntry(index).ElementAddr;
+            UIElement* element = Instance->m_uiElements[addr];
+
+            switch (element->GetState())
             {
-                return true;
+            case ElementState_Pressed:
+            case ElementState_Released:
+            {
+                Instance->SetElementState(i, addr, element, ElementState_Normal);
+
+                break;
+            }
+            default:
+            {
+                break;
+            }
             }
         }
+
+        if (hit != -1)
+        {
+            const uint32_t addr = grid->GetEntry(hit).ElementAddr;
+            UIElement* element = Instance->m_uiElements[addr];
+
+            if (element->GetState() != ElementState_Pressed)
+            {
+                Instance->SetElementState(i, addr, element, ElementState_Pressed);
+
+                grid->MarkActive(hit);
+            }
+        }
+
+        grid->PruneActive();
+
+        if (hit != -1)
+        {
+            return true;
+        }
     }
 
     return false;
@@ -401,20 +292,64 @@ void UIControl::SubmitRelease(const glm::vec2& a_pos, const glm::vec2& a_size)
             continue;
         }
 
-        const uint32_t childCount = canvas.ChildCount;
-        const uint32_t* children = canvas.ChildElements;
-        for (uint32_t j = 0; j < childCount; ++j)
+        UIHitGrid* grid = Instance->GetHitGrid(i, canvas, a_size);
+
+        // Only pressed and released elements react to a release and those are always active so the cell lookup can be skipped
+        for (const uint32_t index : grid->GetActive())
         {
-            if (children[j] < 0)
+            const UIHitEntry& entry = grid->GetEntry(index);
+            UIElement* element = Instance->m_uiElements[entry.ElementAddr];
+
+            const e_ElementState elementState = element->GetState();
+
+            if (entry.Contains(a_pos))
             {
-                continue;
+                switch (elementState)
+                {
+                case ElementState_Pressed:
+                {
+                    Instance->SetElementState(i, entry.ElementAddr, element, ElementState_Released);
+
+                    break;
+                }
+                case ElementState_Released:
+                {
+                    Instance->SetElementState(i, entry.ElementAddr, element, ElementState_Hovered);
+
+                    break;
+                }
+                default:
+                {
+                    break;
+                }
+                }
+            }
+            else if (elementState == ElementState_Released)
+            {
+                Instance->SetElementState(i, entry.ElementAddr, element, ElementState_Normal);
             }
-
-            Instance->SendRelease(i, children[j], a_pos, a_size);
         }
+
+        grid->PruneActive();
     }
 }
 
+void UIControl::FlushEvents()
+{
+    const uint32_t count = Instance->m_stateEvents.Size() / 3;
+    if (count == 0)
+    {
+        return;
+    }
+
+    IDEFER(Instance->m_stateEvents.Clear());
+
+    MonoArray* eventArray = mono_array_new(mono_domain_get(), mono_get_uint32_class(), (uintptr_t)Instance->m_stateEvents.Size());
+    memcpy(mono_array_addr(eventArray, uint32_t, 0), Instance->m_stateEvents.Data(), Instance->m_stateEvents.Size() * sizeof(uint32_t));
+
+    Instance->m_onStateChanged->Exec(eventArray, count);
+}
+
 // MIT License
 // 
 // Copyright (c) 2024 River Govers
@@ -66,6 +66,8 @@ void UIControlBindings::DestroyCanvas(uint32_t a_addr) const
 		delete[] buffer.ChildElements;
 	});
     m_uiControl->m_canvas.Erase(a_addr);
+
+    UIControl::MarkLayoutDirty();
 }
 void UIControlBindings::AddCanvasChild(uint32_t a_addr, uint32_t a_uiElementAddr) const
 {
@@ -74,6 +76,9 @@ void UIControlBindings::AddCanvasChild(uint32_t a_addr, uint32_t a_uiElementAddr
     IVERIFY(a_uiElementAddr < m_uiControl->m_uiElements.Size());   
     IVERIFY(m_uiControl->m_uiElements.Exists(a_uiElementAddr));
 
+    // Deferred so the layout is only invalidated after the child has been added
+    IDEFER(UIControl::MarkLayoutDirty());
+
     {
         TLockArray<CanvasBuffer> a = m_uiControl->m_canvas.ToLockArray();
 
@@ -136,6 +141,8 @@ void UIControlBindings::RemoveCanvasChild(uint32_t a_addr, uint32_t a_uiElementA
             }
         }
     }
+
+    UIControl::MarkLayoutDirty();
 }
 uint32_t* UIControlBindings::GetCanvasChildren(uint32_t a_addr, uint32_t* a_count) const
 {
@@ -163,6 +170,8 @@ void UIControlBindings::DestroyUIElement(uint32_t a_addr) const
     const UIElement* element = m_uiControl->m_uiElements[a_addr];
     IDEFER(delete element);
     m_uiControl->m_uiElements.Erase(a_addr);
+
+    UIControl::MarkLayoutDirty();
 }
 void UIControlBindings::AddElementChild(uint32_t a_addr, uint32_t a_childAddr) const
 {
@@ -177,6 +186,8 @@ void UIControlBindings::AddElementChild(uint32_t a_addr, uint32_t a_childAddr) c
     pElement->AddChild(a_childAddr);
     UIElement* cElement = a[a_childAddr];
     cElement->SetParent(a_addr);
+
+    UIControl::MarkLayoutDirty();
 }
 void UIControlBindings::RemoveElementChild(uint32_t a_addr, uint32_t a_childAddr) const
 {
@@ -191,6 +202,8 @@ void UIControlBindings::RemoveElementChild(uint32_t a_addr, uint32_t a_childAddr
     pElement->RemoveChild(a_childAddr);
     UIElement* cElement = a[a_addr];
     cElement->SetParent(-1);
+
+    UIControl::MarkLayoutDirty();
 }
 uint32_t* UIControlBindings::GetElementChildren(uint32_t a_addr, uint32_t* a_count) const
 {
@@ -223,6 +236,8 @@ void UIControlBindings::SetElementPosition(uint32_t a_addr, const glm::vec2& a_p
 
     UIElement* element = a[a_addr];
     element->SetPosition(a_pos);
+
+    UIControl::MarkLayoutDirty();
 }
 glm::vec2 UIControlBindings::GetElementSize(uint32_t a_addr) const
 {
@@ -243,6 +258,8 @@ void UIControlBindings::SetElementSize(uint32_t a_addr, const glm::vec2& a_size)
 
     UIElement* element = a[a_addr];
     element->SetSize(a_size);
+
+    UIControl::MarkLayoutDirty();
 }
 glm::vec4 UIControlBindings::GetElementColor(uint32_t a_addr) const
 {
@@ -283,6 +300,8 @@ void UIControlBindings::SetElementXAnchor(uint32_t a_addr, e_UIXAnchor a_anchor)
 
     UIElement* element = a[a_addr];
     element->SetXAnchor(a_anchor);
+
+    UIControl::MarkLayoutDirty();
 }
 e_UIYAnchor UIControlBindings::GetElementYAnchor(uint32_t a_addr) const
 {
@@ -303,6 +322,8 @@ void UIControlBindings::SetElementYAnchor(uint32_t a_addr, e_UIYAnchor a_anchor)
 
     UIElement* element = a[a_addr];
     element->SetYAnchor(a_anchor);
+
+    UIControl::MarkLayoutDirty();
 }
 e_ElementState UIControlBindings::GetElementState(uint32_t a_addr) const
 {
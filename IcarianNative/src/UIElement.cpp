@@ -22,6 +22,8 @@ UIElement::UIElement()
     m_color = glm::vec4(1.0f);
 
     m_state = ElementState_Normal;
+
+    m_version = 0;
 }
 UIElement::~UIElement()
 {
@@ -48,6 +50,8 @@ void UIElement::AddChild(uint32_t a_childAddr)
     } 
 
     m_children[m_childCount++] = a_childAddr;
+
+    MarkDirty();
 }
 void UIElement::RemoveChild(uint32_t a_childAddr)
 {
@@ -62,6 +66,8 @@ void UIElement::RemoveChild(uint32_t a_childAddr)
                 m_children[j] = m_children[j + 1];
             }
 
+            MarkDirty();
+
             return;
         }
     }
@@ -0,0 +1,194 @@
+// Icarian Engine - C# Game Engine
+// 
+// License at end of file.
+
+#include "Rendering/UI/UIHitGrid.h"
+
+#include "Rendering/UI/UIControl.h"
+#include "Rendering/UI/UIElement.h"
+#include "Trace.h"
+
+UIHitGrid::UIHitGrid()
+{
+    m_generation = -1;
+    m_screenSize = glm::vec2(0.0f);
+}
+UIHitGrid::~UIHitGrid()
+{
+
+}
+
+glm::uvec2 UIHitGrid::GetCell(const glm::vec2& a_pos) const
+{
+    const glm::vec2 screenSize = glm::max(m_screenSize, glm::vec2(1.0f));
+    const glm::vec2 cell = glm::floor(a_pos / screenSize * (float)CellCount);
+
+    // Clamping is monotonic so rects partially or fully off screen still share a cell with any point they contain
+    return (glm::uvec2)glm::clamp(cell, glm::vec2(0.0f), glm::vec2((float)(CellCount - 1)));
+}
+
+void UIHitGrid::AddElement(const CanvasBuffer& a_canvas, uint32_t a_addr)
+{
+    const UIElement* element = UIControl::GetUIElement(a_addr);
+
+    const glm::vec2 pos = element->GetCanvasPosition(a_canvas, m_screenSize) * m_screenSize;
+    const glm::vec2 size = element->GetCanvasScale(a_canvas, m_screenSize) * m_screenSize;
+
+    const uint32_t index = m_entries.Size();
+    m_entries.Push({ pos, pos + size, a_addr });
+
+    if (element->GetState() != ElementState_Normal)
+    {
+        m_active.Push(index);
+    }
+
+    const uint32_t childCount = element->GetChildCount();
+    const uint32_t* children = element->GetChildren();
+    for (uint32_t i = 0; i < childCount; ++i)
+    {
+        if (children[i] == -1)
+        {
+            continue;
+        }
+
+        AddElement(a_canvas, children[i]);
+    }
+}
+
+void UIHitGrid::Build(const CanvasBuffer& a_canvas, uint32_t a_generation, const glm::vec2& a_screenSize)
+{
+    TRACE("Building UIHitGrid");
+
+    m_generation = a_generation;
+    m_screenSize = a_screenSize;
+
+    m_entries.Clear();
+    m_active.Clear();
+
+    for (uint32_t i = 0; i < a_canvas.ChildCount; ++i)
+    {
+        const uint32_t addr = a_canvas.ChildElements[i];
+        if (addr == -1)
+        {
+            continue;
+        }
+
+        AddElement(a_canvas, addr);
+    }
+
+    m_cellStart.Resize(TotalCellCount + 1);
+    for (uint32_t i = 0; i <= TotalCellCount; ++i)
+    {
+        m_cellStart[i] = 0;
+    }
+
+    const uint32_t entryCount = m_entries.Size();
+
+    // Counting sort into the cells so lookups are a contiguous run and entries stay in dispatch order within a cell
+    for (uint32_t i = 0; i < entryCount; ++i)
+    {
+        const glm::uvec2 min = GetCell(m_entries[i].Min);
+        const glm::uvec2 max = GetCell(m_entries[i].Max);
+
+        for (uint32_t y = min.y; y <= max.y; ++y)
+        {
+            for (uint32_t x = min.x; x <= max.x; ++x)
+            {
+                ++m_cellStart[y * CellCount + x + 1];
+            }
+        }
+    }
+
+    for (uint32_t i = 0; i < TotalCellCount; ++i)
+    {
+        m_cellStart[i + 1] += m_cellStart[i];
+    }
+
+    m_cellEntries.Resize(m_cellStart[TotalCellCount]);
+
+    uint32_t fill[TotalCellCount];
+    for (uint32_t i = 0; i < TotalCellCount; ++i)
+    {
+        fill[i] = m_cellStart[i];
+    }
+
+    for (uint32_t i = 0; i < entryCount; ++i)
+    {
+        const glm::uvec2 min = GetCell(m_entries[i].Min);
+        const glm::uvec2 max = GetCell(m_entries[i].Max);
+
+        for (uint32_t y = min.y; y <= max.y; ++y)
+        {
+            for (uint32_t x = min.x; x <= max.x; ++x)
+            {
+                m_cellEntries[fill[y * CellCount + x]++] = i;
+            }
+        }
+    }
+}
+
+void UIHitGrid::Query(const glm::vec2& a_pos, Array<uint32_t>* a_entries) const
+{
+    const glm::uvec2 cell = GetCell(a_pos);
+    const uint32_t cellIndex = cell.y * CellCount + cell.x;
+
+    const uint32_t end = m_cellStart[cellIndex + 1];
+    for (uint32_t i = m_cellStart[cellIndex]; i < end; ++i)
+    {
+        const uint32_t index = m_cellEntries[i];
+        if (m_entries[index].Contains(a_pos))
+        {
+            a_entries->Push(index);
+        }
+    }
+}
+
+void UIHitGrid::MarkActive(uint32_t a_index)
+{
+    for (const uint32_t index : m_active)
+    {
+        if (index == a_index)
+        {
+            return;
+        }
+    }
+
+    m_active.Push(a_index);
+}
+void UIHitGrid::PruneActive()
+{
+    for (uint32_t i = 0; i < m_active.Size();)
+    {
+        const UIElement* element = UIControl::GetUIElement(m_entries[m_active[i]].ElementAddr);
+        if (element->GetState() == ElementState_Normal)
+        {
+            m_active.Erase(i);
+
+            continue;
+        }
+
+        ++i;
+    }
+}
+
+// MIT License
+// 
+// Copyright (c) 2024 River Govers
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE
\ No newline at end of file
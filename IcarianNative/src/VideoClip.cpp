@@ -10,9 +10,65 @@
 #include <minimp4.h>
 
 #include "Core/IcarianDefer.h"
+#include "DataTypes/ThreadGuard.h"
 #include "FileCache.h"
 #include "IcarianError.h"
 #include "Rendering/Video/H264.h"
+#include "ThreadJob.h"
+#include "ThreadPool.h"
+
+static void ReleasePrefetch(VideoClipPrefetch* a_prefetch)
+{
+    if (a_prefetch->Refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        if (a_prefetch->Data != nullptr)
+        {
+            delete[] a_prefetch->Data;
+        }
+
+        delete a_prefetch;
+    }
+}
+
+class VideoPrefetchJob : public ThreadJob
+{
+private:
+    std::filesystem::path m_path;
+    Array<VideoFrameInfo> m_frames;
+    VideoClipPrefetch*    m_prefetch;
+
+protected:
+
+public:
+    // Takes a copy of the frames so the job does not depend on the clip still being around
+    VideoPrefetchJob(const std::filesystem::path& a_path, const VideoFrameInfo* a_frames, uint32_t a_frameCount, VideoClipPrefetch* a_prefetch) : 
+        ThreadJob(JobPriority_EngineLow),
+        m_frames(a_frames, a_frameCount)
+    {
+        m_path = a_path;
+        m_prefetch = a_prefetch;
+    }
+    virtual ~VideoPrefetchJob() 
+    { 
+        ReleasePrefetch(m_prefetch);
+    }
+
+    virtual void Execute()
+    {
+        // Clip has already let go of it so nobody is going to use the data
+        if (m_prefetch->Refs.load(std::memory_order_acquire) <= 1)
+        {
+            return;
+        }
+
+        uint8_t* data;
+        uint32_t size;
+        VideoClip::ReadClipData(m_path, m_frames.Data(), m_frames.Size(), &data, &size);
+
+        m_prefetch->Data = data;
+        m_prefetch->State.store(VideoPrefetchState_Ready, std::memory_order_release);
+    }
+};
 
 static int ReadCallback(int64_t a_offset, void* a_buffer, size_t a_size, void* a_token)
 {
@@ -40,6 +96,15 @@ VideoClip::VideoClip(const std::filesystem::path& a_path)
     m_frameCount = 0;
     m_frames = nullptr;
 
+    m_gopCount = 0;
+    m_gops = nullptr;
+    m_lastGOP = 0;
+
+    for (uint32_t i = 0; i < MaxPrefetchCount; ++i)
+    {
+        m_prefetch[i] = nullptr;
+    }
+
     m_duration = 0.0;
     m_fps = 0.0;
 
@@ -146,6 +211,10 @@ VideoClip::VideoClip(const std::filesystem::path& a_path)
 
             const double invTimescale = 1.0 / track.timescale;
 
+            // Grows when a slice header does not fit so the rest of the file can still get away with small reads
+            Array<uint8_t> peek;
+            peek.Resize(SliceHeaderPeekSize + 4);
+
             for (uint32_t j = 0; j < track.sample_count; ++j)
             {
                 unsigned int frameBytes;
@@ -154,18 +223,23 @@ VideoClip::VideoClip(const std::filesystem::path& a_path)
                 const MP4D_file_offset_t offset = MP4D_frame_offset(&demux, i, j, &frameBytes, &timestamp, &duration);
                 trackDuration += duration;
 
-                handle->Seek(offset);
-                uint8_t* dat = new uint8_t[frameBytes];
-                IDEFER(delete[] dat);
-                handle->Read(dat, (uint64_t)frameBytes);
-
-                const uint8_t* p = dat;
+                // Only the headers are needed to order the frames so walk the NAL units in the file instead of reading whole samples
+                // Keeps load time and memory down on long or high bitrate clips as the slice data is only read when it is played
+                uint64_t nalOffset = (uint64_t)offset;
                 while (frameBytes > 0) 
                 {
-                    const uint32_t size = (((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3]) + 4;
+                    uint32_t peekSize = glm::min(frameBytes, SliceHeaderPeekSize + 4);
+
+                    handle->Seek(nalOffset);
+                    handle->Read(peek.Data(), (uint64_t)peekSize);
+                    IVERIFY(peekSize > 4);
+
+                    const uint32_t size = (((uint32_t)peek[0] << 24) | ((uint32_t)peek[1] << 16) | ((uint32_t)peek[2] << 8) | peek[3]) + 4;
                     IVERIFY(frameBytes >= size);
 
-                    H264::BitStream bitStream = H264::BitStream(p + 4, frameBytes);
+                    peekSize = glm::min(size, peekSize);
+
+                    H264::BitStream bitStream = H264::BitStream(peek.Data() + 4, (uint64_t)peekSize - 4);
                     
                     const H264::NALHeader nal = H264::ReadNALHeader(&bitStream);
 
@@ -187,13 +261,32 @@ VideoClip::VideoClip(const std::filesystem::path& a_path)
                     default:
                     {
                         frameBytes -= size;
-                        p += size;
+                        nalOffset += size;
 
                         continue;
                     }
                     }
 
-                    const H264::SliceHeader header = H264::ReadSliceHeader(&bitStream, nal, m_pps, m_sps);
+                    H264::SliceHeader header = H264::ReadSliceHeader(&bitStream, nal, m_pps, m_sps);
+
+                    // Reads past the end of the stream come back as 0 so running out means the header may not have fit
+                    // Read more of the NAL and parse it again until it fits or the whole NAL has been read
+                    while (bitStream.IsEOF() && peekSize < size)
+                    {
+                        peekSize = glm::min(peekSize * 2, size);
+                        if (peek.Size() < peekSize)
+                        {
+                            peek.Resize(peekSize);
+                        }
+
+                        handle->Seek(nalOffset);
+                        handle->Read(peek.Data(), (uint64_t)peekSize);
+
+                        bitStream = H264::BitStream(peek.Data() + 4, (uint64_t)peekSize - 4);
+                        H264::ReadNALHeader(&bitStream);
+
+                        header = H264::ReadSliceHeader(&bitStream, nal, m_pps, m_sps);
+                    }
 
                     if (header.PICOrderCNTLSB == 0)
                     {
@@ -229,7 +322,7 @@ VideoClip::VideoClip(const std::filesystem::path& a_path)
                         },
                         .Size = size,
                         .TimeStamp = timestamp * invTimescale,
-                        .Offset = (uint64_t)offset + (p - dat),
+                        .Offset = nalOffset,
                     };
 
                     frames.Push(info);
@@ -268,6 +361,8 @@ VideoClip::VideoClip(const std::filesystem::path& a_path)
                 NextFrame:;
             }
 
+            BuildGOPIndex();
+
             m_fps = (float)((double)track.timescale / trackDuration * track.sample_count);
             m_duration = trackDuration * invTimescale;
 
@@ -288,75 +383,144 @@ VideoClip::~VideoClip()
     {
         delete[] m_frames;
     }
-}
 
-bool VideoClip::GetVideoClipData(double a_inTimeStamp, uint32_t* a_startIndex, uint32_t* a_endIndex, uint8_t** a_data, uint32_t* a_size) const
-{
-    IVERIFY(a_size != nullptr);
-    IVERIFY(a_data != nullptr);
-
-    if (a_startIndex != nullptr)
+    if (m_gops != nullptr)
     {
-        *a_startIndex = -1;
+        delete[] m_gops;
     }
-    if (a_endIndex != nullptr)
+
+    // Jobs still in flight hold their own reference and clean up after themselves
+    for (uint32_t i = 0; i < MaxPrefetchCount; ++i)
     {
-        *a_endIndex = -1;
+        if (m_prefetch[i] != nullptr)
+        {
+            ReleasePrefetch(m_prefetch[i]);
+        }
     }
+}
 
-    *a_size = 0;
-    *a_data = nullptr;
+void VideoClip::BuildGOPIndex()
+{
+    Array<VideoGOPInfo> gops;
 
-    uint32_t startIndex = 0;
-    uint32_t endIndex = m_frameCount;
+    double maxTimeStamp = -1.0;
     for (uint32_t i = 0; i < m_frameCount; ++i)
     {
-        if (m_frames[i].TimeStamp > a_inTimeStamp)
+        const VideoFrameInfo& frame = m_frames[i];
+
+        if (i == 0 || frame.Type == VideoFrameType_Intra)
         {
-            for (uint32_t j = i; j < m_frameCount; ++j)
+            const VideoGOPInfo info = 
             {
-                if (m_frames[j].Type == VideoFrameType_Intra)
-                {
-                    endIndex = j;
+                .FrameIndex = i,
+                .MaxTimeStamp = maxTimeStamp
+            };
 
-                    break;
-                }
-            }
+            gops.Push(info);
+        }
+
+        maxTimeStamp = glm::max(maxTimeStamp, frame.TimeStamp);
+        gops[gops.Size() - 1].MaxTimeStamp = maxTimeStamp;
+    }
+
+    IVERIFY(m_gops == nullptr);
+    m_gopCount = gops.Size();
+    if (m_gopCount > 0)
+    {
+        m_gops = new VideoGOPInfo[m_gopCount];
+        memcpy(m_gops, gops.Data(), m_gopCount * sizeof(VideoGOPInfo));
+    }
+}
+
+uint32_t VideoClip::FindGOP(double a_timeStamp) const
+{
+    // Looking for the first GOP with a frame after the timestamp
+    // Max timestamps are monotonic so it is the first GOP with a max timestamp greater than the timestamp
+    const auto isMatch = [&](uint32_t a_gop)
+    {
+        return m_gops[a_gop].MaxTimeStamp > a_timeStamp && (a_gop == 0 || m_gops[a_gop - 1].MaxTimeStamp <= a_timeStamp);
+    };
 
-            goto FoundIntra;
+    const uint32_t lastGOP = m_lastGOP.load(std::memory_order_relaxed);
+    for (uint32_t i = lastGOP; i < m_gopCount && i <= lastGOP + 1; ++i)
+    {
+        if (isMatch(i))
+        {
+            return i;
         }
+    }
 
-        if (m_frames[i].Type == VideoFrameType_Intra)
+    uint32_t low = 0;
+    uint32_t high = m_gopCount;
+    while (low < high)
+    {
+        const uint32_t mid = low + (high - low) / 2;
+        if (m_gops[mid].MaxTimeStamp > a_timeStamp)
+        {
+            high = mid;
+        }
+        else
         {
-            startIndex = i;
+            low = mid + 1;
         }
     }
 
-    return false;
+    return low;
+}
 
-    FoundIntra:;
+bool VideoClip::GetClipRange(double a_timeStamp, uint32_t* a_startIndex, uint32_t* a_endIndex) const
+{
+    const uint32_t gop = FindGOP(a_timeStamp);
+    if (gop >= m_gopCount)
+    {
+        return false;
+    }
 
-    IVERIFY(startIndex < m_frameCount);
-    IVERIFY(endIndex < m_frameCount);
-    IVERIFY(startIndex != endIndex);
+    m_lastGOP.store(gop, std::memory_order_relaxed);
 
-    if (a_startIndex != nullptr)
+    const uint32_t gopStart = m_gops[gop].FrameIndex;
+    const uint32_t gopEnd = gop + 1 < m_gopCount ? m_gops[gop + 1].FrameIndex : m_frameCount;
+
+    // Everything before the GOP is at or before the timestamp so the first frame after it is in this GOP
+    uint32_t frameIndex = gopStart;
+    while (frameIndex < gopEnd && m_frames[frameIndex].TimeStamp <= a_timeStamp)
     {
-        *a_startIndex = startIndex;
+        ++frameIndex;
     }
-    if (a_endIndex != nullptr)
+
+    // Decode from the last intra frame before the frame up to the next intra frame at or after it
+    // Only the leading GOP can start on a non intra frame and it defaults to 0 either way
+    uint32_t startIndex = gopStart;
+    uint32_t endIndex = gopEnd;
+    if (frameIndex == gopStart)
     {
-        *a_endIndex = endIndex;
+        startIndex = gop > 0 ? m_gops[gop - 1].FrameIndex : 0;
+        endIndex = m_frames[gopStart].Type == VideoFrameType_Intra ? gopStart : gopEnd;
     }
 
-    FileHandle* handle = FileCache::LoadFile(m_path);
+    // End is exclusive so the last GOP ends on the frame count
+    IVERIFY(startIndex < m_frameCount);
+    IVERIFY(endIndex <= m_frameCount);
+    IVERIFY(startIndex != endIndex);
+
+    *a_startIndex = startIndex;
+    *a_endIndex = endIndex;
+
+    return true;
+}
+
+void VideoClip::ReadClipData(const std::filesystem::path& a_path, const VideoFrameInfo* a_frames, uint32_t a_frameCount, uint8_t** a_data, uint32_t* a_size)
+{
+    FileHandle* handle = FileCache::LoadFile(a_path);
     IVERIFY(handle != nullptr);
     IDEFER(delete handle);
 
     uint32_t size = 0;
-    for (uint32_t i = startIndex; i < endIndex; ++i)
+    uint32_t maxFrameSize = 0;
+    for (uint32_t i = 0; i < a_frameCount; ++i)
     {
-        size += m_frames[i].Size;
+        size += a_frames[i].Size;
+        maxFrameSize = glm::max(maxFrameSize, a_frames[i].Size);
     }
 
     *a_size = size;
@@ -367,19 +531,19 @@ bool VideoClip::GetVideoClipData(double a_inTimeStamp, uint32_t* a_startIndex, u
     // Can skip bits so just zero them
     memset(p, 0, size);
 
-    // Oversized but better over then under and/or multiple allocations
-    uint8_t* readBuff = new uint8_t[size + 4];
+    // Only ever holds a single frame so keep it to the largest one
+    uint8_t* readBuff = new uint8_t[maxFrameSize];
     IDEFER(delete[] readBuff);
-    for (uint32_t i = startIndex; i < endIndex; ++i)
+    for (uint32_t i = 0; i < a_frameCount; ++i)
     {
-        const VideoFrameInfo& frame = m_frames[i];
+        const VideoFrameInfo& frame = a_frames[i];
 
         handle->Seek(frame.Offset);
         handle->Read(readBuff, frame.Size);
 
         const uint8_t* offBuf = readBuff + 4;
 
-        H264::BitStream bitStream = H264::BitStream(offBuf, frame.Size);
+        H264::BitStream bitStream = H264::BitStream(offBuf, frame.Size - 4);
                     
         const H264::NALHeader nal = H264::ReadNALHeader(&bitStream);
         IVERIFY(nal.Type == H264::NALUnitType_CodedSliceIDR || nal.Type == H264::NALUnitType_CodedSliceNonIDR);
@@ -389,10 +553,157 @@ bool VideoClip::GetVideoClipData(double a_inTimeStamp, uint32_t* a_startIndex, u
 
         p += frame.Size;
     }
+}
+
+bool VideoClip::GetVideoClipData(double a_inTimeStamp, uint32_t* a_startIndex, uint32_t* a_endIndex, uint8_t** a_data, uint32_t* a_size) const
+{
+    IVERIFY(a_size != nullptr);
+    IVERIFY(a_data != nullptr);
+
+    if (a_startIndex != nullptr)
+    {
+        *a_startIndex = -1;
+    }
+    if (a_endIndex != nullptr)
+    {
+        *a_endIndex = -1;
+    }
+
+    *a_size = 0;
+    *a_data = nullptr;
+
+    uint32_t startIndex;
+    uint32_t endIndex;
+    if (!GetClipRange(a_inTimeStamp, &startIndex, &endIndex))
+    {
+        return false;
+    }
+
+    if (a_startIndex != nullptr)
+    {
+        *a_startIndex = startIndex;
+    }
+    if (a_endIndex != nullptr)
+    {
+        *a_endIndex = endIndex;
+    }
+
+    VideoClipPrefetch* prefetch = nullptr;
+    {
+        const ThreadGuard g = ThreadGuard(m_prefetchLock);
+
+        for (uint32_t i = 0; i < MaxPrefetchCount; ++i)
+        {
+            VideoClipPrefetch* p = m_prefetch[i];
+            if (p != nullptr && p->StartIndex == startIndex && p->EndIndex == endIndex)
+            {
+                prefetch = p;
+                m_prefetch[i] = nullptr;
+
+                break;
+            }
+        }
+    }
+
+    if (prefetch != nullptr)
+    {
+        IDEFER(ReleasePrefetch(prefetch));
+
+        // Still in flight so read it here rather then stall on the thread pool
+        // The job sees it is the last one holding it and backs out
+        if (prefetch->State.load(std::memory_order_acquire) == VideoPrefetchState_Ready)
+        {
+            *a_data = prefetch->Data;
+            *a_size = prefetch->Size;
+
+            prefetch->Data = nullptr;
+
+            return true;
+        }
+    }
+
+    ReadClipData(m_path, m_frames + startIndex, endIndex - startIndex, a_data, a_size);
 
     return true;
 }
 
+void VideoClip::PrefetchClipData(double a_timeStamp) const
+{
+    uint32_t startIndex;
+    uint32_t endIndex;
+    if (!GetClipRange(a_timeStamp, &startIndex, &endIndex))
+    {
+        return;
+    }
+
+    uint64_t size = 0;
+    for (uint32_t i = startIndex; i < endIndex; ++i)
+    {
+        size += m_frames[i].Size;
+    }
+
+    // Not worth holding onto when it is larger then the budget so leave it to be read when it is needed
+    if (size > MaxPrefetchSize)
+    {
+        return;
+    }
+
+    VideoClipPrefetch* evicted = nullptr;
+    IDEFER(
+    if (evicted != nullptr)
+    {
+        ReleasePrefetch(evicted);
+    });
+
+    const ThreadGuard g = ThreadGuard(m_prefetchLock);
+
+    uint64_t residentSize = size;
+    for (uint32_t i = 0; i < MaxPrefetchCount; ++i)
+    {
+        const VideoClipPrefetch* p = m_prefetch[i];
+        if (p != nullptr)
+        {
+            if (p->StartIndex == startIndex && p->EndIndex == endIndex)
+            {
+                return;
+            }
+
+            residentSize += p->Size;
+        }
+    }
+
+    // Oldest is at the front and the furthest from being needed next so it goes first
+    if (m_prefetch[0] != nullptr && (m_prefetch[MaxPrefetchCount - 1] != nullptr || residentSize > MaxPrefetchSize))
+    {
+        evicted = m_prefetch[0];
+        for (uint32_t i = 1; i < MaxPrefetchCount; ++i)
+        {
+            m_prefetch[i - 1] = m_prefetch[i];
+        }
+        m_prefetch[MaxPrefetchCount - 1] = nullptr;
+    }
+
+    uint32_t slot = 0;
+    while (m_prefetch[slot] != nullptr)
+    {
+        ++slot;
+    }
+
+    VideoClipPrefetch* prefetch = new VideoClipPrefetch();
+    // One for the clip and one for the job
+    prefetch->Refs = 2;
+    prefetch->State = VideoPrefetchState_Pending;
+    prefetch->StartIndex = startIndex;
+    prefetch->EndIndex = endIndex;
+    // Known up front so can be used for the budget before the data has been read
+    prefetch->Size = (uint32_t)size;
+    prefetch->Data = nullptr;
+
+    m_prefetch[slot] = prefetch;
+
+    ThreadPool::PushJob(new VideoPrefetchJob(m_path, m_frames + startIndex, endIndex - startIndex, prefetch));
+}
+
 // MIT License
 // 
 // Copyright (c) 2024 River Govers
@@ -7,7 +7,6 @@
 #define GLM_FORCE_SWIZZLE 
 #include <glm/glm.hpp>
 
-#include "DataTypes/RingAllocator.h"
 #include "FileCache.h"
 #include "IcarianError.h"
 
@@ -21,6 +20,13 @@ WAVAudioClip::WAVAudioClip(const std::filesystem::path& a_path)
     m_channelCount = 0;
     m_sampleSize = 0;
 
+    m_dataOffset = 0;
+    m_dataSize = 0;
+
+    m_file = nullptr;
+    m_residentData = nullptr;
+    m_data = nullptr;
+
     FileHandle* handle = FileCache::LoadFile(m_path);
     if (handle != nullptr)
     {
@@ -96,6 +102,9 @@ WAVAudioClip::WAVAudioClip(const std::filesystem::path& a_path)
                     IERROR("WAV invalid file");
                 }
 
+                // Some exporters write a bogus size for streamed files so clamp to what is actually there
+                m_dataSize = glm::min(m_dataSize, handle->GetSize() - m_dataOffset);
+
                 m_sampleSize = m_dataSize / m_channelCount / sizeof(int16_t);
                 m_duration = (float)m_sampleSize / (float)m_sampleRate;
 
@@ -106,11 +115,52 @@ WAVAudioClip::WAVAudioClip(const std::filesystem::path& a_path)
                 handle->Ignore(chunkSize);
             }
         }        
+
+        if (m_sampleSize == 0)
+        {
+            return;
+        }
+
+        m_file = MappedFile::Open(m_path);
+        if (m_file != nullptr && m_dataOffset + m_dataSize <= m_file->GetSize())
+        {
+            m_data = (const uint8_t*)m_file->GetData() + m_dataOffset;
+
+            return;
+        }
+
+        if (m_file != nullptr)
+        {
+            delete m_file;
+            m_file = nullptr;
+        }
+
+        m_residentData = new uint8_t[m_dataSize];
+        if (!handle->Seek(m_dataOffset) || handle->Read(m_residentData, m_dataSize) != m_dataSize)
+        {
+            IERROR("WAV failed to read data: " + m_path.string());
+
+            delete[] m_residentData;
+            m_residentData = nullptr;
+            m_sampleSize = 0;
+
+            return;
+        }
+
+        m_data = m_residentData;
     }
 }
 WAVAudioClip::~WAVAudioClip()
 {
+    if (m_file != nullptr)
+    {
+        delete m_file;
+    }
 
+    if (m_residentData != nullptr)
+    {
+        delete[] m_residentData;
+    }
 }
 
 float WAVAudioClip::GetDuration() const
@@ -131,36 +181,20 @@ uint64_t WAVAudioClip::GetSampleSize() const
     return m_sampleSize;
 }
 
-uint8_t* WAVAudioClip::GetAudioData(RingAllocator* a_allocator, uint64_t a_sampleOffset, uint32_t a_sampleSize, uint32_t* a_outSampleSize)
+uint8_t* WAVAudioClip::GetAudioData(FrameAllocator* a_allocator, uint64_t a_sampleOffset, uint32_t a_sampleSize, uint32_t* a_outSampleSize)
 {
-    FileHandle* handle = FileCache::LoadFile(m_path);
-    if (handle == nullptr)
-    {
-        return nullptr;
-    }
-
-    IDEFER(delete handle);
-        
-    const uint64_t seekOffset = a_sampleOffset * m_channelCount * sizeof(int16_t);
-
-    if (!handle->Seek(m_dataOffset + seekOffset))
+    if (m_data == nullptr || a_sampleOffset >= m_sampleSize)
     {
         return nullptr;
     }
 
     const uint64_t remainingSamples = m_sampleSize - a_sampleOffset;
     const uint64_t samplesToRead = glm::min((uint64_t)a_sampleSize, remainingSamples);
-    const uint64_t size = samplesToRead * m_channelCount;
-    
-    uint8_t* data = (uint8_t*)a_allocator->Allocate<int16_t>(size);
-    if (handle->Read(data, size * sizeof(int16_t)) != size)
-    {
-        return nullptr;
-    }
 
     *a_outSampleSize = (uint32_t)samplesToRead;
 
-    return data;
+    // Data lives as long as the clip and is only read from so can be handed out directly
+    return (uint8_t*)(m_data + a_sampleOffset * m_channelCount * sizeof(int16_t));
 }
 
 // MIT License
@@ -21,12 +21,25 @@ void PrintEngineHelp()
 
     printf("  --enable-trace - Enables debug logging for the engine \n");
     printf("  --enable-profiler - Enables the internal profiler for the engine \n");
+    printf("  --enable-aot - Enables ahead of time compilation of managed assemblies on Linux \n");
 }
 
 static const char EnableTraceString[] = "--enable-trace";
 static const CBUINT32 EnableTraceStringLen = sizeof(EnableTraceString) - 1;
 static const char EnableProfilerString[] = "--enable-profiler";
 static const CBUINT32 EnableProfilerStringLen = sizeof(EnableProfilerString) - 1;
+static const char EnableAOTString[] = "--enable-aot";
+static const CBUINT32 EnableAOTStringLen = sizeof(EnableAOTString) - 1;
+
+// Framework assemblies IcarianCS pulls in at startup
+static const char* AOTFrameworkAssemblies[] = 
+{
+    "lib/mono/4.5/mscorlib.dll",
+    "lib/mono/4.5/System.dll",
+    "lib/mono/4.5/System.Core.dll",
+    "lib/mono/4.5/System.Xml.dll"
+};
+static const CBUINT32 AOTFrameworkAssemblyCount = sizeof(AOTFrameworkAssemblies) / sizeof(*AOTFrameworkAssemblies);
 
 int main(int a_argc, char** a_argv)
 {
@@ -52,6 +65,7 @@ int main(int a_argc, char** a_argv)
 
     CBBOOL enableTrace;
     CBBOOL enableProfiler;
+    CBBOOL enableAOT;
 
 #ifdef _WIN32
     targetPlatform = TargetPlatform_Windows;
@@ -68,6 +82,7 @@ int main(int a_argc, char** a_argv)
 
     enableTrace = CBFALSE;
     enableProfiler = CBFALSE;
+    enableAOT = CBFALSE;
 
     printf("IcarianEngine Build\n");
     printf("\n");
@@ -159,6 +174,10 @@ int main(int a_argc, char** a_argv)
         {
             enableProfiler = CBTRUE;
         }
+        else if (strncmp(a_argv[i], EnableAOTString, EnableAOTStringLen) == 0)
+        {
+            enableAOT = CBTRUE;
+        }
         else if (strncmp(a_argv[i], JobString, JobStringLen) == 0)
         {
             const char* jobCountStr = a_argv[i] + JobStringLen;
@@ -440,6 +459,40 @@ int main(int a_argc, char** a_argv)
     }
     }
 
+    // Mono on Windows needs an MSVC toolchain to AOT so only doing it for Linux targets
+    if (enableAOT && targetPlatform != TargetPlatform_Windows)
+    {
+        PrintHeader("AOT Compiling Assemblies");
+
+        printf("AOT Compiling IcarianCS...\n");
+        ret = AOTCompileCSAssembly("build", "../deps/Mono/Linux/bin/mono", "IcarianCS.dll", &lines, &lineCount);
+
+        FlushLines(&lines, &lineCount);
+
+        if (!ret)
+        {
+            printf("Failed to AOT compile IcarianCS\n");
+
+            return 1;
+        }
+
+        for (CBUINT32 i = 0; i < AOTFrameworkAssemblyCount; ++i)
+        {
+            printf("AOT Compiling %s...\n", AOTFrameworkAssemblies[i]);
+            ret = AOTCompileCSAssembly("build", "../deps/Mono/Linux/bin/mono", AOTFrameworkAssemblies[i], &lines, &lineCount);
+
+            FlushLines(&lines, &lineCount);
+
+            // Not fatal the runtime will JIT anything without an image
+            if (!ret)
+            {
+                printf("Failed to AOT compile %s, skipping\n", AOTFrameworkAssemblies[i]);
+            }
+        }
+
+        printf("AOT Compiled!\n");
+    }
+
     printf("Done!\n");
 
     return 0;